@@ -0,0 +1,139 @@
+/*
+ * ============================================
+ * ALLOC_BENCHMARK.CPP - Allocations per Row
+ * ============================================
+ * Counts heap allocations (global operator new) spent
+ * executing a prepared statement and reading its rows:
+ *   - first execution vs. re-execution of the cached
+ *     statement (fetch buffers come from its scratch)
+ *   - reading cells with getString (one copy per cell)
+ *     vs. getStringView (no copy)
+ *   - binding long text with setString (copied) vs.
+ *     setStringView (bound in place)
+ *
+ * Usage: alloc_benchmark [password]
+ */
+
+#include "../include/Database.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+static atomic<unsigned long long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+static const char* BENCH_QUERY =
+    "SELECT r.id, r.student_id, CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
+    "c.code, c.name_en AS course_name, r.status "
+    "FROM registrations r "
+    "JOIN students s ON r.student_id = s.id "
+    "JOIN courses c ON r.course_id = c.id "
+    "WHERE r.status <> ?";
+
+static void report(const string& label, unsigned long long count, size_t per) {
+    cout << left << setw(44) << label
+         << right << setw(10) << count << " allocations";
+    if (per > 0) {
+        cout << fixed << setprecision(2) << setw(10) << (double)count / per << " per row";
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string password = argc > 1 ? argv[1] : "admin";
+
+    Database db("localhost", "root", password, "nctu_sis");
+    if (!db.connect()) {
+        cerr << "Cannot connect to database" << endl;
+        return 1;
+    }
+    QueryStats::instance().setEnabled(false);   // Measure the data path only
+
+    // A long value so setString cannot fit it in the small-string buffer
+    const string longStatus(256, 'x');
+
+    size_t rows = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        auto stmt = db.prepareStatement(BENCH_QUERY);
+        stmt->setString(1, longStatus);
+        unsigned long long before = allocations.load();
+        auto rs = stmt->executeQuery();
+        unsigned long long spent = allocations.load() - before;
+        rows = (size_t)rs->getRowCount();
+        report(pass == 0 ? "executeQuery (first execution)" : "executeQuery (cached statement)", spent, rows);
+    }
+    if (rows == 0) {
+        cerr << "No rows - load sql/sample_data.sql first" << endl;
+        return 1;
+    }
+
+    {
+        auto stmt = db.prepareStatement(BENCH_QUERY);
+        stmt->setString(1, longStatus);
+        auto result = stmt->executeQuery();
+        size_t columns = result->getColumnCount();
+        size_t checksum = 0;
+
+        unsigned long long before = allocations.load();
+        while (result->next()) {
+            for (size_t i = 0; i < columns; i++) {
+                string value = result->getString((int)i);
+                checksum += value.size();
+            }
+        }
+        report("read every cell with getString", allocations.load() - before, rows);
+
+        result = stmt->executeQuery();
+        before = allocations.load();
+        while (result->next()) {
+            for (size_t i = 0; i < columns; i++) {
+                checksum += result->getStringView((int)i).size();
+            }
+        }
+        report("read every cell with getStringView", allocations.load() - before, rows);
+        cout << "(checksum " << checksum << ")" << endl;
+    }
+
+    {
+        // Handlers prepare a fresh PreparedStatement per call (the server-side
+        // handle is cached), so the parameter copy is paid every time
+        const int executions = 100;
+
+        unsigned long long before = allocations.load();
+        for (int i = 0; i < executions; i++) {
+            auto stmt = db.prepareStatement(BENCH_QUERY);
+            stmt->setString(1, longStatus);
+            stmt->executeUpdate();
+        }
+        cout << endl;
+        report("prepare + setString + execute, per call", (allocations.load() - before) / executions, 0);
+
+        before = allocations.load();
+        for (int i = 0; i < executions; i++) {
+            auto stmt = db.prepareStatement(BENCH_QUERY);
+            stmt->setStringView(1, longStatus);
+            stmt->executeUpdate();
+        }
+        report("prepare + setStringView + execute, per call", (allocations.load() - before) / executions, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * ============================================
+ * ESCAPE_BENCHMARK.CPP - JSON String Escaping
+ * ============================================
+ * Escapes every quoted string literal found in the SQL seed
+ * files (English names, e-mails and descriptions from
+ * sample_data.sql; Arabic names from schema_v3.sql) and
+ * compares MB/s of:
+ *   - the old stringstream escapeString
+ *   - a byte-at-a-time loop appending clean runs
+ *   - JsonHelper::appendString (SSE2/AVX2 span scan)
+ * No database connection is needed.
+ *
+ * Usage: escape_benchmark [seconds] [sqlFile...]
+ *        (default files: sql/sample_data.sql sql/schema_v3.sql)
+ */
+
+#include "../include/JsonHelper.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// Escaping as JsonHelper::escapeString did it before the vector scan
+static string streamEscape(const string& str) {
+    stringstream ss;
+    for (char c : str) {
+        switch (c) {
+            case '"':  ss << "\\\""; break;
+            case '\\': ss << "\\\\"; break;
+            case '\b': ss << "\\b"; break;
+            case '\f': ss << "\\f"; break;
+            case '\n': ss << "\\n"; break;
+            case '\r': ss << "\\r"; break;
+            case '\t': ss << "\\t"; break;
+            default:
+                if (c >= 0 && c < 32) {
+                    ss << "\\u" << hex << setfill('0') << setw(4) << static_cast<int>(c);
+                } else {
+                    ss << c;
+                }
+        }
+    }
+    return ss.str();
+}
+
+// One byte per iteration, copying runs between escapes
+static void scalarAppend(string& out, string_view value) {
+    static const char hexDigits[] = "0123456789abcdef";
+    out += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < value.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(value.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hexDigits[c >> 4];
+                out += hexDigits[c & 0x0F];
+        }
+    }
+    out.append(value.data() + runStart, value.size() - runStart);
+    out += '"';
+}
+
+// Every '...' literal in the file ('' is an escaped quote)
+static void collectLiterals(const string& path, vector<string>& literals) {
+    ifstream file(path, ios::binary);
+    if (!file) {
+        cerr << "Cannot open " << path << endl;
+        return;
+    }
+    string sql((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    bool inComment = false;
+    for (size_t i = 0; i < sql.size(); i++) {
+        if (inComment) {
+            if (sql[i] == '\n') inComment = false;
+        } else if (sql[i] == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+            inComment = true;
+        } else if (sql[i] == '\'') {
+            string literal;
+            for (i++; i < sql.size(); i++) {
+                if (sql[i] == '\'') {
+                    if (i + 1 < sql.size() && sql[i + 1] == '\'') {
+                        literal += '\'';
+                        i++;
+                        continue;
+                    }
+                    break;
+                }
+                if (sql[i] == '\\' && i + 1 < sql.size()) {
+                    literal += sql[++i];
+                    continue;
+                }
+                literal += sql[i];
+            }
+            literals.push_back(literal);
+        }
+    }
+}
+
+template <typename Escape>
+static void run(const string& label, const vector<string>& literals, size_t bytes,
+                double seconds, Escape escape) {
+    string out;
+    size_t passes = 0;
+    auto started = Clock::now();
+    chrono::duration<double> elapsed(0);
+    do {
+        out.clear();
+        for (const string& literal : literals) {
+            escape(out, literal);
+        }
+        passes++;
+        elapsed = Clock::now() - started;
+    } while (elapsed.count() < seconds);
+
+    double megabytes = (double)bytes * passes / (1024.0 * 1024.0);
+    cout << left << setw(36) << label
+         << right << fixed << setprecision(1) << setw(10) << megabytes / elapsed.count() << " MB/s"
+         << setw(12) << out.size() << " bytes out" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    vector<string> files;
+    for (int i = 2; i < argc; i++) files.push_back(argv[i]);
+    if (files.empty()) {
+        files = { "sql/sample_data.sql", "sql/schema_v3.sql" };
+    }
+
+    vector<string> literals;
+    for (const string& path : files) collectLiterals(path, literals);
+    if (literals.empty()) {
+        cerr << "No string literals found - run from the project directory" << endl;
+        return 1;
+    }
+
+    size_t bytes = 0;
+    size_t nonAscii = 0;
+    for (const string& literal : literals) {
+        bytes += literal.size();
+        for (unsigned char c : literal) nonAscii += c >= 0x80;
+    }
+
+    // All three must produce the same JSON
+    string reference, scalar, vectorized;
+    for (const string& literal : literals) {
+        reference += '"' + streamEscape(literal) + '"';
+        scalarAppend(scalar, literal);
+        JsonHelper::appendString(vectorized, literal);
+    }
+    if (reference != scalar || reference != vectorized) {
+        cerr << "Escaped output differs between implementations" << endl;
+        return 1;
+    }
+
+    cout << literals.size() << " literals, " << bytes << " bytes ("
+         << nonAscii * 100 / bytes << "% non-ASCII bytes)" << endl;
+#if defined(__AVX2__)
+    cout << "Vector path: AVX2 + SSE2" << endl;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    cout << "Vector path: SSE2" << endl;
+#else
+    cout << "Vector path: none (scalar fallback)" << endl;
+#endif
+    cout << endl;
+
+    run("stringstream escapeString", literals, bytes, seconds, [](string& out, const string& s) {
+        out += '"';
+        out += streamEscape(s);
+        out += '"';
+    });
+    run("byte loop, run copies", literals, bytes, seconds, [](string& out, const string& s) {
+        scalarAppend(out, s);
+    });
+    run("JsonHelper::appendString", literals, bytes, seconds, [](string& out, const string& s) {
+        JsonHelper::appendString(out, s);
+    });
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * ============================================
+ * POOL_BENCHMARK.CPP - Connection Pool Benchmark
+ * ============================================
+ * Compares N concurrent callers sharing the single global
+ * connection (serialized by a mutex, as before the pool)
+ * against the same callers checking out pooled connections.
+ *
+ * Usage: pool_benchmark [callers] [queriesPerCaller] [password]
+ */
+
+#include "../include/Database.h"
+#include "../include/ConnectionPool.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static const char* BENCH_QUERY =
+    "SELECT r.id, CONCAT(s.first_name, ' ', s.last_name) AS student_name, c.code "
+    "FROM registrations r "
+    "JOIN students s ON r.student_id = s.id "
+    "JOIN courses c ON r.course_id = c.id LIMIT 50";
+
+struct RunResult {
+    double seconds;
+    vector<double> latenciesMs;             // Successful queries only
+    size_t failures = 0;
+    string firstError;
+};
+
+static void report(const string& label, int callers, RunResult& run) {
+    sort(run.latenciesMs.begin(), run.latenciesMs.end());
+    size_t n = run.latenciesMs.size();
+    double p50 = n ? run.latenciesMs[n / 2] : 0.0;
+    double p99 = n ? run.latenciesMs[min(n - 1, (n * 99) / 100)] : 0.0;
+    cout << left << setw(22) << label
+         << " callers=" << setw(3) << callers
+         << fixed << setprecision(1)
+         << " total=" << setw(8) << run.seconds * 1000.0 << "ms"
+         << " qps=" << setw(9) << (run.seconds > 0 ? n / run.seconds : 0.0)
+         << setprecision(2)
+         << " p50=" << setw(7) << p50 << "ms"
+         << " p99=" << p99 << "ms";
+    if (run.failures > 0) {
+        cout << " failed=" << run.failures << " (" << run.firstError << ")";
+    }
+    cout << endl;
+}
+
+template <typename QueryFn>
+static RunResult runCallers(int callers, int queries, QueryFn query) {
+    vector<vector<double>> perThread(callers);
+    vector<thread> threads;
+    RunResult run;
+    mutex errorMutex;
+    auto start = Clock::now();
+    for (int t = 0; t < callers; t++) {
+        threads.emplace_back([&, t]() {
+            mysql_thread_init();
+            perThread[t].reserve(queries);
+            for (int i = 0; i < queries; i++) {
+                auto q0 = Clock::now();
+                try {
+                    query();
+                } catch (const exception& e) {
+                    // Counted and reported instead of terminating the process
+                    lock_guard<mutex> lock(errorMutex);
+                    if (run.failures++ == 0) run.firstError = e.what();
+                    continue;
+                }
+                perThread[t].push_back(chrono::duration<double, milli>(Clock::now() - q0).count());
+            }
+            mysql_thread_end();
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    run.seconds = chrono::duration<double>(Clock::now() - start).count();
+    for (auto& v : perThread) run.latenciesMs.insert(run.latenciesMs.end(), v.begin(), v.end());
+    return run;
+}
+
+int main(int argc, char* argv[]) {
+    int callers = argc > 1 ? atoi(argv[1]) : 8;
+    int queries = argc > 2 ? atoi(argv[2]) : 200;
+    string password = argc > 3 ? argv[3] : "admin";
+
+    // Pool first: it performs the one-time mysql_library_init()
+    ConnectionPool pool("localhost", "root", password, "nctu_sis", 3306,
+                        1, (size_t)max(callers, 1));
+    if (!pool.initialize()) {
+        cerr << "Cannot connect to database" << endl;
+        return 1;
+    }
+
+    Database shared("localhost", "root", password, "nctu_sis");
+    if (!shared.connect()) {
+        cerr << "Cannot connect to database" << endl;
+        return 1;
+    }
+    mutex sharedLock;
+
+    auto sharedQuery = [&]() {
+        lock_guard<mutex> lock(sharedLock);
+        auto rs = shared.executeQuery(BENCH_QUERY);
+        while (rs->next()) {}
+    };
+    auto pooledQuery = [&]() {
+        auto conn = pool.acquire();
+        auto rs = conn->executeQuery(BENCH_QUERY);
+        while (rs->next()) {}
+    };
+
+    cout << "Query: " << BENCH_QUERY << endl << endl;
+
+    // Warm up both paths (opens the pool up to its maximum)
+    for (RunResult warmup : {runCallers(callers, 5, sharedQuery), runCallers(callers, 5, pooledQuery)}) {
+        if (warmup.failures > 0) {
+            cerr << "Benchmark query failed: " << warmup.firstError << endl;
+            return 1;
+        }
+    }
+
+    for (int n : {1, callers}) {
+        RunResult single = runCallers(n, queries, sharedQuery);
+        report("shared connection", n, single);
+        RunResult pooled = runCallers(n, queries, pooledQuery);
+        report("connection pool", n, pooled);
+        cout << endl;
+    }
+
+    cout << "Pool size after run: " << pool.size() << " (" << pool.idleCount() << " idle)" << endl;
+    return 0;
+}
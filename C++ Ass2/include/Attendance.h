@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include "Database.h"
+#include "EntityFields.h"
 
 class Attendance {
 private:
@@ -55,9 +56,27 @@ public:
     bool update(Database& db);
     bool remove(Database& db);
 
+    // Field table: column, JSON key and member of every attendance field
+    // (SELECT list, row decoder and toJson are generated from it)
+    static const auto& fields();
+
     // Utility
     std::string toJson() const;
     bool isEmpty() const;
 };
 
+inline const auto& Attendance::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &Attendance::id),
+        member("session_id", "sessionId", &Attendance::sessionId),
+        member("student_id", "studentId", &Attendance::studentId),
+        member("status", "status", &Attendance::status),
+        member("remarks", "remarks", &Attendance::remarks),
+        member("recorded_by", "recordedBy", &Attendance::recordedBy),
+        member("recorded_at", "recordedAt", &Attendance::recordedAt)
+    );
+    return table;
+}
+
 #endif // ATTENDANCE_H
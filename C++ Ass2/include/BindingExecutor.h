@@ -0,0 +1,79 @@
+/*
+ * ============================================
+ * BINDINGEXECUTOR.H - Worker Threads for Bindings
+ * ============================================
+ * Runs binding handlers on a small pool of worker threads
+ * instead of the UI thread, so the window keeps painting
+ * while queries run and independent calls from a page
+ * overlap. Each binding has its own concurrency limit;
+ * calls beyond it wait in that binding's queue without
+ * holding up other bindings.
+ */
+
+#ifndef BINDING_EXECUTOR_H
+#define BINDING_EXECUTOR_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/*
+ * BindingExecutor - Worker pool with per-binding limits
+ */
+class BindingExecutor {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Lane {
+        size_t limit;
+        size_t running = 0;             // Tasks queued to or running on a worker
+        std::deque<Task> waiting;       // Over the limit, in arrival order
+    };
+
+    struct ReadyTask {
+        Lane* lane;
+        Task task;
+    };
+
+    std::unordered_map<std::string, Lane> lanes;    // Node-based: Lane* stays valid
+    std::deque<ReadyTask> ready;
+    std::vector<std::thread> workers;
+    size_t defaultLimit;
+    bool running;
+    mutable std::mutex mtx;
+    std::condition_variable wake;
+
+    Lane& laneFor(const std::string& binding);
+    void workerLoop();
+
+public:
+    explicit BindingExecutor(size_t defaultLimit = 2);
+    ~BindingExecutor();
+
+    BindingExecutor(const BindingExecutor&) = delete;
+    BindingExecutor& operator=(const BindingExecutor&) = delete;
+
+    // Start the worker threads
+    void start(size_t workerCount);
+
+    // Drop queued tasks, wait for running ones and join the workers
+    void stop();
+
+    // Most tasks of binding that may run at once (at least 1)
+    void setLimit(const std::string& binding, size_t limit);
+
+    // Queue task under binding. Without workers (before start or
+    // after stop) the task runs right away on the calling thread.
+    void submit(const std::string& binding, Task task);
+
+    size_t workerCount() const;
+    size_t queuedCount() const;
+};
+
+#endif // BINDING_EXECUTOR_H
@@ -0,0 +1,58 @@
+/*
+ * ============================================
+ * CHANGEFEED.H - Row Change Notifications
+ * ============================================
+ * Mutating bindings publish the row they changed as a
+ * delta; the feed hands it to the page, which patches the
+ * matching grid row in place instead of reloading the
+ * whole listing:
+ *
+ *   {"table":"grades","op":"update","key":"42","row":{...}}
+ *
+ * row has the same keys as the listing that shows the
+ * table. On the page, onDataChange() in web/js/app.js
+ * registers a listener per table.
+ */
+
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <mutex>
+
+/*
+ * ChangeFeed - Process-wide delta publisher
+ */
+class ChangeFeed {
+public:
+    // Delivers a script to the page; may be called from any thread
+    using Sink = std::function<void(const std::string& script)>;
+
+private:
+    std::mutex mtx;
+    Sink sink;
+
+    ChangeFeed() = default;
+
+public:
+    static ChangeFeed& instance();
+
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    // Where deltas go (the webview); an empty sink drops them
+    void setSink(Sink newSink);
+
+    /*
+     * publish - Sends one delta
+     *
+     * op is "insert", "update" or "delete"; rowJson is the changed
+     * row as a JSON object, or empty for a delete.
+     */
+    void publish(std::string_view table, std::string_view op, std::string_view key,
+                 std::string_view rowJson);
+};
+
+#endif // CHANGE_FEED_H
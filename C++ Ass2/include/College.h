@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include "Database.h"
+#include "EntityFields.h"
 
 // NOTE: Do NOT use "using namespace std;" in header files as it causes
 // conflicts with Windows SDK types like "byte" when used with C++17.
@@ -44,9 +45,23 @@ public:
     bool update(Database& db);
     bool remove(Database& db);
 
+    // Field table: column, JSON key and member of every college field
+    // (SELECT list, row decoder and toJson are generated from it)
+    static const auto& fields();
+
     // Utility methods
     std::string toJson() const;
     bool isEmpty() const;
 };
 
+inline const auto& College::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &College::id),
+        member("name", "name", &College::name),
+        member("description", "description", &College::description)
+    );
+    return table;
+}
+
 #endif // COLLEGE_H
@@ -0,0 +1,137 @@
+/*
+ * ============================================
+ * CONNECTIONPOOL.H - Pooled MySQL Connections
+ * ============================================
+ * Keeps between minSize and maxSize open Database
+ * connections, hands them out through a scoped
+ * lease and closes connections that sit idle.
+ */
+
+#ifndef CONNECTION_POOL_H
+#define CONNECTION_POOL_H
+
+#include <string>
+#include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <future>
+#include <vector>
+#include "Database.h"
+
+class ConnectionPool;
+
+/*
+ * PooledConnection - Scoped checkout of a pooled connection
+ * The connection goes back to the pool when the lease is destroyed.
+ */
+class PooledConnection {
+private:
+    ConnectionPool* pool;
+    std::unique_ptr<Database> conn;
+
+public:
+    PooledConnection() : pool(nullptr) {}
+    PooledConnection(ConnectionPool* owner, std::unique_ptr<Database> connection)
+        : pool(owner), conn(std::move(connection)) {}
+    ~PooledConnection();
+
+    PooledConnection(PooledConnection&& other) noexcept;
+    PooledConnection& operator=(PooledConnection&& other) noexcept;
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    Database& operator*() const { return *conn; }
+    Database* operator->() const { return conn.get(); }
+    Database* get() const { return conn.get(); }
+    explicit operator bool() const { return conn != nullptr; }
+
+    // Return the connection to the pool early
+    void release();
+};
+
+/*
+ * ConnectionPool - Bounded pool of Database connections
+ */
+class ConnectionPool {
+private:
+    struct IdleConnection {
+        std::unique_ptr<Database> conn;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    std::string host;
+    std::string user;
+    std::string password;
+    std::string database;
+    int port;
+
+    size_t minSize;
+    size_t maxSize;
+    std::chrono::seconds idleTimeout;       // Close extra connections idle this long
+    std::chrono::seconds validateAfter;     // Ping connections idle longer than this on checkout
+    std::chrono::milliseconds waitTimeout;  // How long acquire() waits when the pool is exhausted
+
+    std::deque<IdleConnection> idle;        // Most recently returned at the back
+    size_t totalCount;                      // Idle + checked out + being opened
+    bool running;
+
+    mutable std::mutex mtx;
+    std::condition_variable available;
+    std::condition_variable reaperWake;
+    std::thread reaper;
+
+    std::unique_ptr<Database> openConnection();
+    void giveBack(std::unique_ptr<Database> conn);
+    void reaperLoop();
+
+    friend class PooledConnection;
+
+public:
+    // Pool over the default connection parameters (see Database)
+    ConnectionPool(size_t minSize = 2, size_t maxSize = 8,
+                   std::chrono::seconds idleTimeout = std::chrono::seconds(60));
+
+    // Pool with custom connection parameters
+    ConnectionPool(const std::string& host, const std::string& user,
+                   const std::string& password, const std::string& database, int port = 3306,
+                   size_t minSize = 2, size_t maxSize = 8,
+                   std::chrono::seconds idleTimeout = std::chrono::seconds(60));
+
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Open minSize connections and start the idle reaper
+    bool initialize();
+
+    // Close every idle connection and stop the reaper
+    void shutdown();
+
+    // Check out a healthy connection, waiting up to waitTimeout
+    PooledConnection acquire();
+
+    // Check out a connection and run query on it through the event loop
+    // (see QueryEventLoop); the connection returns to the pool once the
+    // result has been fetched. Issue several and get() them to run side by side.
+    // Not for pooled bindings: their handler already holds a lease, so the
+    // extra checkout can wait out waitTimeout while the pool is busy. Use
+    // Database::executeQueryAsync or a QueryPipeline on the leased connection.
+    std::future<std::unique_ptr<ResultSet>> executeQueryAsync(const std::string& query,
+                                                              const std::vector<SqlValue>& params = {});
+
+    // Close connections beyond minSize that have been idle past idleTimeout
+    void reapIdle();
+
+    void setWaitTimeout(std::chrono::milliseconds timeout);
+    void setValidateAfter(std::chrono::seconds interval);
+
+    size_t size() const;
+    size_t idleCount() const;
+    size_t maxConnections() const { return maxSize; }
+};
+
+#endif // CONNECTION_POOL_H
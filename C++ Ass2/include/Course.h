@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include "Database.h"
+#include "EntityFields.h"
 
 // NOTE: Do NOT use "using namespace std;" in header files as it causes
 // conflicts with Windows SDK types like "byte" when used with C++17.
@@ -99,6 +100,10 @@ public:
     static std::vector<Course> getByDepartment(Database& db, const std::string& departmentId);
     static std::vector<Course> getByAcademicLevel(Database& db, const std::string& levelId);
 
+    // Field table: column, JSON key and member of every course field
+    // (SELECT list, row decoder and toJson are generated from it)
+    static const auto& fields();
+
     // Instance database operations
     bool save(Database& db);
     bool update(Database& db);
@@ -109,4 +114,30 @@ public:
     bool isEmpty() const;
 };
 
+inline const auto& Course::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &Course::id),
+        member("code", "code", &Course::code),
+        member("name_en", "nameEn", &Course::nameEn),
+        member("name_ar", "nameAr", &Course::nameAr),
+        member("description", "description", &Course::description),
+        member("department_id", "departmentId", &Course::departmentId),
+        member("academic_level_id", "academicLevelId", &Course::academicLevelId),
+        member("semester_number", "semesterNumber", &Course::semesterNumber),
+        member("course_type_id", "courseTypeId", &Course::courseTypeId),
+        member("credit_hours", "creditHours", &Course::creditHours),
+        member("lecture_hours", "lectureHours", &Course::lectureHours),
+        member("tutorial_hours", "tutorialHours", &Course::tutorialHours),
+        member("lab_hours", "labHours", &Course::labHours),
+        member("practical_hours", "practicalHours", &Course::practicalHours),
+        member("max_marks", "maxMarks", &Course::maxMarks),
+        member("assignment1_marks", "assignment1Marks", &Course::assignment1Marks),
+        member("assignment2_marks", "assignment2Marks", &Course::assignment2Marks),
+        member("year_work_marks", "yearWorkMarks", &Course::yearWorkMarks),
+        member("final_exam_marks", "finalExamMarks", &Course::finalExamMarks)
+    );
+    return table;
+}
+
 #endif // COURSE_H
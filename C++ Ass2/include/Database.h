@@ -30,85 +30,351 @@
 #endif
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <list>
+#include <unordered_map>
 #include <memory>
+#include <future>
 #include <iostream>
 #include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include "QueryStats.h"
+
+// Flag type used by MYSQL_BIND (bool in MySQL 8, my_bool in older clients)
+using MysqlFlag = std::remove_pointer_t<decltype(MYSQL_BIND::is_null)>;
+
+/*
+ * ColumnIndex - Column positions resolved once per result set
+ * Entities index it with their own column enum, so decoding a row
+ * never compares field names.
+ */
+template <size_t N>
+struct ColumnIndex {
+    std::array<int, N> positions;
+
+    int operator[](size_t column) const {
+        return positions[column];
+    }
+};
+
+/*
+ * StatementScratch - Buffers reused by every execution of one statement
+ * Lives next to the cached MYSQL_STMT, so executing a statement again
+ * does not allocate new bind arrays or fetch buffers.
+ */
+struct StatementScratch {
+    struct ColumnState {
+        unsigned long length;
+        MysqlFlag isNull;
+        MysqlFlag error;
+    };
+
+    std::vector<MYSQL_BIND> params;
+    std::vector<MYSQL_BIND> results;
+    std::vector<ColumnState> columns;
+    std::vector<char> staging;          // Fetch buffer shared by all columns
+    std::vector<long long> offsets;     // Cell offsets while rows are copied
+};
 
 /*
  * ResultSet - Wrapper for MySQL result set
+ * Either walks a MYSQL_RES from the text protocol, or owns rows
+ * copied out of a prepared statement (binary protocol).
  */
 class ResultSet {
 private:
     MYSQL_RES* result;
+    MYSQL* streamingConn;           // Set for mysql_use_result() results
     MYSQL_ROW currentRow;
+    unsigned long* currentLengths;
     MYSQL_FIELD* fields;
     unsigned int numFields;
-    
+
+    // Rows materialized from a prepared statement
+    MYSQL_RES* metadata;            // Column names and widths
+    std::string data;               // Every cell, NUL terminated
+    std::vector<char*> cells;       // numFields pointers per row (nullptr = SQL NULL)
+    std::vector<unsigned long> cellLengths;
+    size_t rowCount;
+    size_t rowIndex;
+
+    void loadStatementRows(MYSQL_STMT* stmt, StatementScratch& scratch) {
+        metadata = mysql_stmt_result_metadata(stmt);
+        if (!metadata) return;
+
+        numFields = mysql_num_fields(metadata);
+        fields = mysql_fetch_fields(metadata);
+        size_t rows = (size_t)mysql_stmt_num_rows(stmt);
+
+        // Bind every column as text into one staging buffer, sized from the
+        // stored result's max lengths
+        size_t stagingSize = 0;
+        size_t rowBytes = 0;
+        for (unsigned int i = 0; i < numFields; i++) {
+            stagingSize += std::max<unsigned long>(fields[i].max_length, 64) + 1;
+            rowBytes += fields[i].max_length + 1;
+        }
+        if (scratch.staging.size() < stagingSize) scratch.staging.resize(stagingSize);
+        scratch.results.assign(numFields, MYSQL_BIND());
+        scratch.columns.assign(numFields, StatementScratch::ColumnState());
+
+        size_t at = 0;
+        for (unsigned int i = 0; i < numFields; i++) {
+            size_t width = std::max<unsigned long>(fields[i].max_length, 64) + 1;
+            MYSQL_BIND& bind = scratch.results[i];
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = scratch.staging.data() + at;
+            bind.buffer_length = (unsigned long)width;
+            bind.length = &scratch.columns[i].length;
+            bind.is_null = &scratch.columns[i].isNull;
+            bind.error = &scratch.columns[i].error;
+            at += width;
+        }
+
+        if (numFields > 0 && mysql_stmt_bind_result(stmt, scratch.results.data())) {
+            throw std::runtime_error(std::string("Query error: ") + mysql_stmt_error(stmt));
+        }
+
+        // max_length bounds the text cells, so the copies below normally never reallocate
+        std::vector<long long>& offsets = scratch.offsets;
+        offsets.clear();
+        offsets.reserve(rows * numFields);
+        cellLengths.reserve(rows * numFields);
+        data.reserve(rows * rowBytes);
+        while (true) {
+            int rc = mysql_stmt_fetch(stmt);
+            if (rc == MYSQL_NO_DATA) break;
+            if (rc == 1) {
+                throw std::runtime_error(std::string("Query error: ") + mysql_stmt_error(stmt));
+            }
+            for (unsigned int i = 0; i < numFields; i++) {
+                const StatementScratch::ColumnState& column = scratch.columns[i];
+                if (column.isNull) {
+                    offsets.push_back(-1);
+                    cellLengths.push_back(0);
+                    continue;
+                }
+                size_t start = data.size();
+                offsets.push_back((long long)start);
+                if (column.length < scratch.results[i].buffer_length) {
+                    data.append((const char*)scratch.results[i].buffer, column.length);
+                } else {
+                    // Value longer than the bound buffer - fetch it again in full, in place
+                    data.resize(start + column.length + 1);
+                    unsigned long fullLength = 0;
+                    MYSQL_BIND full = {};
+                    full.buffer_type = MYSQL_TYPE_STRING;
+                    full.buffer = &data[start];
+                    full.buffer_length = column.length + 1;
+                    full.length = &fullLength;
+                    mysql_stmt_fetch_column(stmt, &full, i, 0);
+                    data.resize(start + std::min(fullLength, column.length));
+                }
+                cellLengths.push_back((unsigned long)(data.size() - start));
+                data.push_back('\0');
+            }
+            rowCount++;
+        }
+
+        // data no longer grows, so cell pointers stay valid
+        cells.resize(offsets.size());
+        for (size_t k = 0; k < offsets.size(); k++) {
+            cells[k] = offsets[k] < 0 ? nullptr : &data[(size_t)offsets[k]];
+        }
+    }
+
 public:
-    ResultSet(MYSQL_RES* res) : result(res), currentRow(nullptr), fields(nullptr), numFields(0) {
+    ResultSet(MYSQL_RES* res, MYSQL* streamingConnection = nullptr)
+        : result(res), streamingConn(streamingConnection), currentRow(nullptr), currentLengths(nullptr),
+          fields(nullptr), numFields(0), metadata(nullptr), rowCount(0), rowIndex(0) {
         if (result) {
             fields = mysql_fetch_fields(result);
             numFields = mysql_num_fields(result);
         }
     }
+
+    // Copies the stored result of an executed prepared statement
+    // scratch supplies reusable fetch buffers (see StatementScratch)
+    explicit ResultSet(MYSQL_STMT* stmt, StatementScratch* scratch = nullptr)
+        : result(nullptr), streamingConn(nullptr), currentRow(nullptr), currentLengths(nullptr),
+          fields(nullptr), numFields(0), metadata(nullptr), rowCount(0), rowIndex(0) {
+        try {
+            if (scratch) {
+                loadStatementRows(stmt, *scratch);
+            } else {
+                StatementScratch local;
+                loadStatementRows(stmt, local);
+            }
+        } catch (...) {
+            if (metadata) mysql_free_result(metadata);
+            throw;
+        }
+    }
     
     ~ResultSet() {
         if (result) {
             mysql_free_result(result);
         }
+        if (metadata) {
+            mysql_free_result(metadata);
+        }
     }
+
+    ResultSet(const ResultSet&) = delete;
+    ResultSet& operator=(const ResultSet&) = delete;
     
     bool next() {
-        if (!result) return false;
-        currentRow = mysql_fetch_row(result);
-        return currentRow != nullptr;
+        if (result) {
+            currentRow = mysql_fetch_row(result);
+            currentLengths = currentRow ? mysql_fetch_lengths(result) : nullptr;
+            // A streamed result can fail part way through (e.g. lost connection)
+            if (!currentRow && streamingConn && mysql_errno(streamingConn) != 0) {
+                throw std::runtime_error(std::string("Query error: ") + mysql_error(streamingConn));
+            }
+            return currentRow != nullptr;
+        }
+        if (rowIndex < rowCount) {
+            currentRow = cells.data() + rowIndex * numFields;
+            currentLengths = cellLengths.data() + rowIndex * numFields;
+            rowIndex++;
+            return true;
+        }
+        currentRow = nullptr;
+        currentLengths = nullptr;
+        return false;
     }
     
-    int getFieldIndex(const std::string& fieldName) const {
+    // Back to before the first row, for a second pass (not for streamed results)
+    void rewind() {
+        if (streamingConn) {
+            throw std::logic_error("A streamed result cannot be rewound");
+        }
+        if (result) {
+            mysql_data_seek(result, 0);
+        }
+        rowIndex = 0;
+        currentRow = nullptr;
+        currentLengths = nullptr;
+    }
+    
+    int getFieldIndex(std::string_view fieldName) const {
         for (unsigned int i = 0; i < numFields; i++) {
-            if (fields[i].name == fieldName) {
+            if (fieldName == fields[i].name) {
                 return i;
             }
         }
         return -1;
     }
-    
-    std::string getString(const std::string& fieldName) const {
-        int idx = getFieldIndex(fieldName);
-        if (idx >= 0 && currentRow && currentRow[idx]) {
-            return std::string(currentRow[idx]);
+
+    // Resolve several column names in one go, e.g. resolveColumns({"id", "code"})
+    // Missing columns resolve to -1 and read as empty/0.
+    template <size_t N>
+    ColumnIndex<N> resolveColumns(const std::string_view (&names)[N]) const {
+        ColumnIndex<N> index;
+        for (size_t i = 0; i < N; i++) {
+            index.positions[i] = getFieldIndex(names[i]);
         }
-        return "";
+        return index;
     }
-    
-    std::string getString(int index) const {
+
+    size_t getColumnCount() const {
+        return numFields;
+    }
+
+    // Rows held by a buffered result (0 for a streamed one)
+    unsigned long long getRowCount() const {
+        if (result) {
+            return streamingConn ? 0 : (unsigned long long)mysql_num_rows(result);
+        }
+        return rowCount;
+    }
+
+    // Bytes of cell data in a buffered result (0 for a streamed one)
+    // Walks a stored text-protocol result once, so call it before next().
+    unsigned long long getPayloadBytes() {
+        if (!result) {
+            unsigned long long bytes = 0;
+            for (unsigned long length : cellLengths) bytes += length;
+            return bytes;
+        }
+        if (streamingConn) return 0;
+        unsigned long long bytes = 0;
+        mysql_data_seek(result, 0);
+        while (MYSQL_ROW row = mysql_fetch_row(result)) {
+            unsigned long* lengths = mysql_fetch_lengths(result);
+            for (unsigned int i = 0; i < numFields; i++) bytes += lengths[i];
+            (void)row;
+        }
+        mysql_data_seek(result, 0);
+        currentRow = nullptr;
+        currentLengths = nullptr;
+        return bytes;
+    }
+
+    // Parse a numeric column without building a temporary string
+    template <typename T>
+    static T parseNumber(std::string_view text) {
+        T value{};
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+    // View of a column in the current row; valid until next() is called
+    std::string_view getStringView(int index) const {
         if (currentRow && index >= 0 && index < (int)numFields && currentRow[index]) {
-            return std::string(currentRow[index]);
+            size_t length = currentLengths ? currentLengths[index] : std::strlen(currentRow[index]);
+            return std::string_view(currentRow[index], length);
         }
-        return "";
+        return std::string_view();
+    }
+
+    std::string_view getStringView(std::string_view fieldName) const {
+        return getStringView(getFieldIndex(fieldName));
     }
     
-    int getInt(const std::string& fieldName) const {
-        std::string val = getString(fieldName);
-        return val.empty() ? 0 : std::stoi(val);
+    // Copying accessors; prefer getStringView when the value is consumed right away
+    std::string getString(std::string_view fieldName) const {
+        return std::string(getStringView(getFieldIndex(fieldName)));
+    }
+    
+    std::string getString(int index) const {
+        return std::string(getStringView(index));
+    }
+    
+    int getInt(std::string_view fieldName) const {
+        return getInt(getFieldIndex(fieldName));
     }
     
     int getInt(int index) const {
-        std::string val = getString(index);
-        return val.empty() ? 0 : std::stoi(val);
+        return parseNumber<int>(getStringView(index));
+    }
+
+    long long getLong(int index) const {
+        return parseNumber<long long>(getStringView(index));
     }
     
-    double getDouble(const std::string& fieldName) const {
-        std::string val = getString(fieldName);
-        return val.empty() ? 0.0 : std::stod(val);
+    double getDouble(std::string_view fieldName) const {
+        return getDouble(getFieldIndex(fieldName));
+    }
+
+    double getDouble(int index) const {
+        return parseNumber<double>(getStringView(index));
     }
     
-    bool getBoolean(const std::string& fieldName) const {
+    bool getBoolean(std::string_view fieldName) const {
         return getInt(fieldName) != 0;
     }
+
+    bool getBoolean(int index) const {
+        return getInt(index) != 0;
+    }
     
-    bool isNull(const std::string& fieldName) const {
+    bool isNull(std::string_view fieldName) const {
         int idx = getFieldIndex(fieldName);
         if (idx >= 0 && currentRow) {
             return currentRow[idx] == nullptr;
@@ -125,116 +391,375 @@ public:
 };
 
 /*
- * PreparedStatement - Simple prepared statement wrapper
+ * StatementCache - Per-connection LRU cache of server-side statements
+ * Keyed by SQL text, so each distinct statement is parsed by the
+ * server once per connection and reused by later prepareStatement calls.
+ */
+class StatementCache {
+public:
+    struct Entry {
+        std::string sql;
+        MYSQL_STMT* stmt;
+        StatementScratch scratch;
+    };
+
+private:
+    size_t capacity;
+    std::list<Entry> entries;                                           // Most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index;  // Keys point into entries
+
+public:
+    explicit StatementCache(size_t capacity = 64) : capacity(std::max<size_t>(capacity, 1)) {}
+
+    ~StatementCache() {
+        clear();
+    }
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // Get the cached statement for sql, preparing it on first use
+    // The entry stays valid until it is evicted by a later get()
+    Entry& get(MYSQL* conn, const std::string& sql) {
+        auto found = index.find(sql);
+        if (found != index.end()) {
+            entries.splice(entries.begin(), entries, found->second);
+            return *found->second;
+        }
+
+        MYSQL_STMT* stmt = mysql_stmt_init(conn);
+        if (!stmt) {
+            throw std::runtime_error(std::string("Query error: ") + mysql_error(conn));
+        }
+        if (mysql_stmt_prepare(stmt, sql.c_str(), (unsigned long)sql.length()) != 0) {
+            std::string error = mysql_stmt_error(stmt);
+            mysql_stmt_close(stmt);
+            throw std::runtime_error("Query error: " + error);
+        }
+        // Have mysql_stmt_store_result() compute column widths for the result buffers
+        MysqlFlag updateMaxLength = 1;
+        mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+        if (entries.size() >= capacity) {
+            Entry& oldest = entries.back();
+            index.erase(oldest.sql);
+            mysql_stmt_close(oldest.stmt);
+            entries.pop_back();
+        }
+        entries.push_front({sql, stmt, StatementScratch()});
+        index.emplace(entries.front().sql, entries.begin());
+        return entries.front();
+    }
+
+    // Close and forget a statement (e.g. after the connection dropped it)
+    void evict(const std::string& sql) {
+        auto found = index.find(sql);
+        if (found == index.end()) return;
+        auto entry = found->second;
+        index.erase(found);
+        mysql_stmt_close(entry->stmt);
+        entries.erase(entry);
+    }
+
+    // Close every statement - must run before the connection is closed
+    void clear() {
+        index.clear();
+        for (auto& entry : entries) {
+            mysql_stmt_close(entry.stmt);
+        }
+        entries.clear();
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+};
+
+/*
+ * PreparedStatement - Server-side prepared statement
+ * Parameters are sent with the binary protocol, never spliced into
+ * the SQL text. The MYSQL_STMT handle comes from the connection's
+ * StatementCache when one is given.
  */
 class PreparedStatement {
 private:
+    struct Param {
+        enum Kind { Null, Text, Integer, Real } kind = Null;
+        std::string_view view;      // Bound text: points at text or at the caller's buffer
+        std::string text;           // Copy made by setString (capacity reused)
+        long long integer = 0;
+        double real = 0.0;
+        unsigned long length = 0;
+    };
+
     MYSQL* conn;
+    StatementCache* cache;
+    MYSQL_STMT* ownStmt;
+    StatementScratch ownScratch;    // Scratch for ownStmt (cached statements keep their own)
+    StatementScratch* scratch;      // Scratch of the handle from the last handle() call
     std::string query;
-    std::vector<std::string> params;
+    std::vector<Param> params;
     int paramCount;
+
+    MYSQL_STMT* handle() {
+        if (cache) {
+            StatementCache::Entry& entry = cache->get(conn, query);
+            scratch = &entry.scratch;
+            return entry.stmt;
+        }
+        scratch = &ownScratch;
+        if (!ownStmt) {
+            ownStmt = mysql_stmt_init(conn);
+            if (!ownStmt || mysql_stmt_prepare(ownStmt, query.c_str(), (unsigned long)query.length()) != 0) {
+                std::string error = ownStmt ? mysql_stmt_error(ownStmt) : mysql_error(conn);
+                if (ownStmt) mysql_stmt_close(ownStmt);
+                ownStmt = nullptr;
+                throw std::runtime_error("Query error: " + error);
+            }
+            MysqlFlag updateMaxLength = 1;
+            mysql_stmt_attr_set(ownStmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+        }
+        return ownStmt;
+    }
+
+    [[noreturn]] void fail(MYSQL_STMT* stmt) {
+        std::string error = mysql_stmt_error(stmt);
+        unsigned int code = mysql_stmt_errno(stmt);
+        // Client errors (CR_*, 2000+) and unknown-handler (1243) leave the handle unusable
+        if (code >= 2000 || code == 1243) {
+            if (cache) {
+                cache->evict(query);
+            } else {
+                mysql_stmt_close(ownStmt);
+                ownStmt = nullptr;
+            }
+        } else {
+            mysql_stmt_free_result(stmt);
+        }
+        throw std::runtime_error("Query error: " + error);
+    }
+
+    // Bind parameters and execute
+    MYSQL_STMT* run() {
+        MYSQL_STMT* stmt = handle();
+
+        std::vector<MYSQL_BIND>& binds = scratch->params;
+        binds.assign(params.size(), MYSQL_BIND());
+        for (size_t i = 0; i < params.size(); i++) {
+            Param& p = params[i];
+            switch (p.kind) {
+                case Param::Null:
+                    binds[i].buffer_type = MYSQL_TYPE_NULL;
+                    break;
+                case Param::Text:
+                    p.length = (unsigned long)p.view.length();
+                    binds[i].buffer_type = MYSQL_TYPE_STRING;
+                    binds[i].buffer = (void*)p.view.data();
+                    binds[i].buffer_length = p.length;
+                    binds[i].length = &p.length;
+                    break;
+                case Param::Integer:
+                    binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+                    binds[i].buffer = &p.integer;
+                    break;
+                case Param::Real:
+                    binds[i].buffer_type = MYSQL_TYPE_DOUBLE;
+                    binds[i].buffer = &p.real;
+                    break;
+            }
+        }
+
+        if (!binds.empty() && mysql_stmt_bind_param(stmt, binds.data())) {
+            fail(stmt);
+        }
+        if (mysql_stmt_execute(stmt) != 0) {
+            fail(stmt);
+        }
+        return stmt;
+    }
+
+    Param* param(int index) {
+        if (index > 0 && index <= paramCount) {
+            return &params[index - 1];
+        }
+        return nullptr;
+    }
     
 public:
-    PreparedStatement(MYSQL* connection, const std::string& sql) 
-        : conn(connection), query(sql), paramCount(0) {
-        // Count placeholders
-        for (char c : sql) {
-            if (c == '?') paramCount++;
+    PreparedStatement(MYSQL* connection, const std::string& sql, StatementCache* statementCache = nullptr)
+        : conn(connection), cache(statementCache), ownStmt(nullptr), scratch(nullptr), query(sql), paramCount(0) {
+        paramCount = (int)mysql_stmt_param_count(handle());
+        params.resize(paramCount);
+    }
+
+    ~PreparedStatement() {
+        if (ownStmt) {
+            mysql_stmt_close(ownStmt);
         }
-        params.assign(paramCount, "NULL");
     }
 
-    void setString(int index, const std::string& value) {
-        if (index > 0 && index <= paramCount) {
-            // Escape the string
-            char* escaped = new char[value.length() * 2 + 1];
-            mysql_real_escape_string(conn, escaped, value.c_str(), (unsigned long)value.length());
-            params[index - 1] = "'" + std::string(escaped) + "'";
-            delete[] escaped;
+    PreparedStatement(const PreparedStatement&) = delete;
+    PreparedStatement& operator=(const PreparedStatement&) = delete;
+
+    // Copies value into the parameter's buffer
+    void setString(int index, std::string_view value) {
+        if (Param* p = param(index)) {
+            p->kind = Param::Text;
+            p->text.assign(value.data(), value.size());
+            p->view = p->text;
+        }
+    }
+
+    // Binds value without copying; it must stay alive until the statement is executed
+    void setStringView(int index, std::string_view value) {
+        if (Param* p = param(index)) {
+            p->kind = Param::Text;
+            p->view = value;
         }
     }
 
     void setNull(int index) {
-        if (index > 0 && index <= paramCount) {
-            params[index - 1] = "NULL";
+        if (Param* p = param(index)) {
+            p->kind = Param::Null;
         }
     }
 
     void setInt(int index, int value) {
-        if (index > 0 && index <= paramCount) {
-            params[index - 1] = std::to_string(value);
+        if (Param* p = param(index)) {
+            p->kind = Param::Integer;
+            p->integer = value;
         }
     }
     
     void setDouble(int index, double value) {
-        if (index > 0 && index <= paramCount) {
-            params[index - 1] = std::to_string(value);
+        if (Param* p = param(index)) {
+            p->kind = Param::Real;
+            p->real = value;
         }
     }
-    
-    std::string buildQuery() const {
-        std::string result;
-        int paramIdx = 0;
-        for (char c : query) {
-            if (c == '?' && paramIdx < paramCount) {
-                result += params[paramIdx++];
-            } else {
-                result += c;
-            }
-        }
-        return result;
+
+    const std::string& getQuery() const {
+        return query;
     }
     
     std::unique_ptr<ResultSet> executeQuery() {
-        std::string finalQuery = buildQuery();
-        if (mysql_query(conn, finalQuery.c_str()) != 0) {
-            throw std::runtime_error(std::string("Query error: ") + mysql_error(conn));
+        auto started = QueryStats::Clock::now();
+        MYSQL_STMT* stmt = run();
+        if (mysql_stmt_store_result(stmt) != 0) {
+            fail(stmt);
+        }
+        std::unique_ptr<ResultSet> rs;
+        try {
+            rs = std::make_unique<ResultSet>(stmt, scratch);
+        } catch (...) {
+            mysql_stmt_free_result(stmt);
+            throw;
         }
-        MYSQL_RES* res = mysql_store_result(conn);
-        return std::make_unique<ResultSet>(res);
+        // Release the rows so the cached handle can be executed again
+        mysql_stmt_free_result(stmt);
+        QueryStats& stats = QueryStats::instance();
+        if (stats.isEnabled()) {
+            stats.record(query, started, rs->getRowCount(), query.size() + rs->getPayloadBytes());
+        }
+        return rs;
     }
     
     int executeUpdate() {
-        std::string finalQuery = buildQuery();
-        if (mysql_query(conn, finalQuery.c_str()) != 0) {
-            throw std::runtime_error(std::string("Query error: ") + mysql_error(conn));
+        auto started = QueryStats::Clock::now();
+        MYSQL_STMT* stmt = run();
+        int affected = (int)mysql_stmt_affected_rows(stmt);
+        if (mysql_stmt_field_count(stmt) > 0) {
+            mysql_stmt_store_result(stmt);
+            mysql_stmt_free_result(stmt);
         }
-        return (int)mysql_affected_rows(conn);
+        QueryStats::instance().record(query, started, (uint64_t)std::max(affected, 0), query.size());
+        return affected;
     }
 };
 
+class SqlValue;
+struct BatchResult;
+
 /*
  * Database - Main database connection class
  */
 class Database {
 private:
     MYSQL* connection;
+    MYSQL* pipelineConnection;  // Opened on first executeMulti, multi-statements on
     std::string host;
     std::string user;
     std::string password;
     std::string database;
     int port;
+    StatementCache statements;   // Server-side statements prepared on this connection
+    unsigned long long maxAllowedPacket;    // Session limits, read on first use
+    unsigned long long autoIncrementStep;
+
+    // Open a handle to the configured server (nullptr on failure)
+    MYSQL* openHandle(unsigned long clientFlags) {
+        MYSQL* handle = mysql_init(nullptr);
+        if (!handle) {
+            std::cerr << "[Database] Failed to initialize MySQL" << std::endl;
+            return nullptr;
+        }
+        
+        if (!mysql_real_connect(handle, host.c_str(), user.c_str(), 
+                                password.c_str(), database.c_str(), 
+                                port, nullptr, clientFlags)) {
+            std::cerr << "[Database] Connection failed: " << mysql_error(handle) << std::endl;
+            mysql_close(handle);
+            return nullptr;
+        }
+        
+        // Set UTF-8 encoding
+        mysql_set_character_set(handle, "utf8mb4");
+        return handle;
+    }
+    
+    void closePipelineConnection() {
+        if (pipelineConnection) {
+            mysql_close(pipelineConnection);
+            pipelineConnection = nullptr;
+        }
+    }
+    
+    void loadSessionLimits() {
+        auto result = executeQuery("SELECT @@max_allowed_packet, @@auto_increment_increment");
+        maxAllowedPacket = 1024 * 1024;
+        autoIncrementStep = 1;
+        if (result->next()) {
+            maxAllowedPacket = (unsigned long long)result->getLong(0);
+            autoIncrementStep = (unsigned long long)std::max(1LL, result->getLong(1));
+        }
+    }
 
 public:
     // Constructor with default connection parameters
     Database() 
         : connection(nullptr),
+          pipelineConnection(nullptr),
           host("localhost"),
           user("root"),
           password("admin"),
           database("nctu_sis"),
-          port(3306) {
+          port(3306),
+          maxAllowedPacket(0),
+          autoIncrementStep(0) {
     }
     
     // Constructor with custom parameters
     Database(const std::string& host, const std::string& user, 
              const std::string& password, const std::string& database, int port = 3306)
         : connection(nullptr),
+          pipelineConnection(nullptr),
           host(host),
           user(user),
           password(password),
           database(database),
-          port(port) {
+          port(port),
+          maxAllowedPacket(0),
+          autoIncrementStep(0) {
     }
     
     // Destructor
@@ -242,27 +767,16 @@ public:
         disconnect();
     }
     
+    // A Database owns its MYSQL handle, so it cannot be copied
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
+    
     // Connect to database
     bool connect() {
         if (connection) return true;  // Already connected
         
-        connection = mysql_init(nullptr);
-        if (!connection) {
-            std::cerr << "[Database] Failed to initialize MySQL" << std::endl;
-            return false;
-        }
-        
-        if (!mysql_real_connect(connection, host.c_str(), user.c_str(), 
-                                password.c_str(), database.c_str(), 
-                                port, nullptr, 0)) {
-            std::cerr << "[Database] Connection failed: " << mysql_error(connection) << std::endl;
-            mysql_close(connection);
-            connection = nullptr;
-            return false;
-        }
-        
-        // Set UTF-8 encoding
-        mysql_set_character_set(connection, "utf8mb4");
+        connection = openHandle(0);
+        if (!connection) return false;
         
         std::cout << "[Database] Connected to " << database << " on " << host << std::endl;
         return true;
@@ -271,8 +785,12 @@ public:
     // Disconnect from database
     void disconnect() {
         if (connection) {
+            statements.clear();
             mysql_close(connection);
             connection = nullptr;
+            closePipelineConnection();
+            maxAllowedPacket = 0;
+            autoIncrementStep = 0;
             std::cout << "[Database] Disconnected" << std::endl;
         }
     }
@@ -291,18 +809,132 @@ public:
         return connection != nullptr;
     }
     
+    // Underlying MYSQL handle (nullptr when disconnected)
+    MYSQL* getHandle() const {
+        return connection;
+    }
+    
+    // Check that the server is still reachable (mysql_ping)
+    bool ping() {
+        if (!connection) return false;
+        return mysql_ping(connection) == 0;
+    }
+    
     // Execute a query and return results
     std::unique_ptr<ResultSet> executeQuery(const std::string& query) {
         if (!connect()) {
             throw std::runtime_error("Not connected to database");
         }
         
+        auto started = QueryStats::Clock::now();
         if (mysql_query(connection, query.c_str()) != 0) {
             throw std::runtime_error(std::string("Query error: ") + mysql_error(connection));
         }
         
         MYSQL_RES* res = mysql_store_result(connection);
-        return std::make_unique<ResultSet>(res);
+        auto rs = std::make_unique<ResultSet>(res);
+        QueryStats& stats = QueryStats::instance();
+        if (stats.isEnabled()) {
+            stats.record(query, started, rs->getRowCount(), query.size() + rs->getPayloadBytes());
+        }
+        return rs;
+    }
+    
+    // Execute a query whose rows are streamed from the server (mysql_use_result)
+    // Rows are fetched one at a time as next() is called, so only the current
+    // row is held in memory. The connection cannot run other statements until
+    // the returned ResultSet is destroyed.
+    std::unique_ptr<ResultSet> executeStreamingQuery(const std::string& query) {
+        if (!connect()) {
+            throw std::runtime_error("Not connected to database");
+        }
+        
+        auto started = QueryStats::Clock::now();
+        if (mysql_real_query(connection, query.c_str(), (unsigned long)query.length()) != 0) {
+            throw std::runtime_error(std::string("Query error: ") + mysql_error(connection));
+        }
+        
+        MYSQL_RES* res = mysql_use_result(connection);
+        if (!res && mysql_field_count(connection) > 0) {
+            throw std::runtime_error(std::string("Query error: ") + mysql_error(connection));
+        }
+        // Rows arrive later while the caller reads them: this is time to first row
+        QueryStats::instance().record(query, started, 0, query.size());
+        return std::make_unique<ResultSet>(res, connection);
+    }
+    
+    // Start a query on the background event loop (see QueryEventLoop)
+    // params fill ? placeholders. This connection must not be used again
+    // until the future is ready. Outside pooled bindings,
+    // ConnectionPool::executeQueryAsync runs several queries side by side.
+    std::future<std::unique_ptr<ResultSet>> executeQueryAsync(const std::string& query,
+                                                              const std::vector<SqlValue>& params = {});
+    
+    // Execute several ';'-separated statements in one round trip
+    // Returns one ResultSet per statement, in order (statements without a
+    // result set, e.g. UPDATE, get an empty ResultSet). See QueryPipeline.
+    // The batch runs on a second handle opened with CLIENT_MULTI_STATEMENTS,
+    // used for nothing else: string-built SQL on the main connection can
+    // never run stacked queries, and no per-call option toggle is needed.
+    // It does not see the main connection's open transaction, so only
+    // pipeline independent reads (values rendered by QueryPipeline).
+    std::vector<std::unique_ptr<ResultSet>> executeMulti(const std::string& statements) {
+        if (!connect()) {
+            throw std::runtime_error("Not connected to database");
+        }
+        if (!pipelineConnection) {
+            pipelineConnection = openHandle(CLIENT_MULTI_STATEMENTS);
+            if (!pipelineConnection) {
+                throw std::runtime_error("Not connected to database");
+            }
+        }
+        MYSQL* handle = pipelineConnection;
+        
+        auto started = QueryStats::Clock::now();
+        if (mysql_real_query(handle, statements.c_str(), (unsigned long)statements.length()) != 0) {
+            std::string error = std::string("Query error: ") + mysql_error(handle);
+            // Client-side errors (2000 and up) mean the link is gone: reopen next time
+            if (mysql_errno(handle) >= 2000) closePipelineConnection();
+            throw std::runtime_error(error);
+        }
+        // Results left after an error are discarded so the handle stays in sync
+        struct PendingResults {
+            MYSQL* handle;
+            ~PendingResults() {
+                while (mysql_more_results(handle) && mysql_next_result(handle) == 0) {
+                    MYSQL_RES* res = mysql_store_result(handle);
+                    if (res) mysql_free_result(res);
+                }
+            }
+        } pendingResults{handle};
+        
+        std::vector<std::unique_ptr<ResultSet>> results;
+        while (true) {
+            MYSQL_RES* res = mysql_store_result(handle);
+            if (!res && mysql_field_count(handle) > 0) {
+                throw std::runtime_error(std::string("Query error: ") + mysql_error(handle));
+            }
+            results.push_back(std::make_unique<ResultSet>(res));
+            
+            int status = mysql_next_result(handle);
+            if (status == -1) break;    // No more results
+            if (status > 0) {
+                // The server stops at the failing statement, nothing is left pending
+                throw std::runtime_error("Query error in statement " + std::to_string(results.size() + 1) +
+                                         ": " + mysql_error(handle));
+            }
+        }
+        QueryStats& stats = QueryStats::instance();
+        if (stats.isEnabled()) {
+            unsigned long long rows = 0;
+            unsigned long long bytes = statements.size();
+            for (auto& rs : results) {
+                rows += rs->getRowCount();
+                bytes += rs->getPayloadBytes();
+            }
+            stats.record(statements, started, rows, bytes);
+        }
+        return results;
     }
     
     // Execute an update (INSERT, UPDATE, DELETE)
@@ -311,19 +943,27 @@ public:
             throw std::runtime_error("Not connected to database");
         }
         
+        auto started = QueryStats::Clock::now();
         if (mysql_query(connection, query.c_str()) != 0) {
             throw std::runtime_error(std::string("Query error: ") + mysql_error(connection));
         }
         
-        return (int)mysql_affected_rows(connection);
+        int affected = (int)mysql_affected_rows(connection);
+        QueryStats::instance().record(query, started, (uint64_t)std::max(affected, 0), query.size());
+        return affected;
     }
     
-    // Prepare a statement
+    // Prepare a statement (reuses the cached server-side handle for this SQL)
     std::unique_ptr<PreparedStatement> prepareStatement(const std::string& query) {
         if (!connect()) {
             throw std::runtime_error("Not connected to database");
         }
-        return std::make_unique<PreparedStatement>(connection, query);
+        return std::make_unique<PreparedStatement>(connection, query, &statements);
+    }
+    
+    // Number of statements currently held in the statement cache
+    size_t cachedStatementCount() const {
+        return statements.size();
     }
     
     // Get last insert ID
@@ -343,6 +983,340 @@ public:
         delete[] escaped;
         return result;
     }
+    
+    // Escape value straight onto the end of out (no temporary buffer)
+    void appendEscaped(std::string& out, std::string_view value) {
+        if (!connect()) {
+            throw std::runtime_error("Not connected to database");
+        }
+        size_t start = out.size();
+        out.resize(start + value.size() * 2 + 1);
+        unsigned long written = mysql_real_escape_string(connection, &out[start], value.data(),
+                                                         (unsigned long)value.size());
+        out.resize(start + written);
+    }
+    
+    // Render value as an SQL literal ('escaped text', number or NULL) onto out
+    void appendLiteral(std::string& out, const SqlValue& value);
+    
+    // Append one statement with its ? placeholders (outside quoted strings)
+    // replaced by params as literals, for text-protocol execution
+    void appendBound(std::string& out, std::string_view statement, const std::vector<SqlValue>& params);
+    
+    // Largest statement the server accepts (@@max_allowed_packet)
+    unsigned long long getMaxAllowedPacket() {
+        if (maxAllowedPacket == 0) loadSessionLimits();
+        return maxAllowedPacket;
+    }
+    
+    // Gap between consecutive AUTO_INCREMENT values (@@auto_increment_increment)
+    unsigned long long getAutoIncrementStep() {
+        if (autoIncrementStep == 0) loadSessionLimits();
+        return autoIncrementStep;
+    }
+    
+    // Insert many rows with multi-row INSERT statements (see BatchInserter)
+    BatchResult executeBatch(const std::string& table, const std::vector<std::string>& columns,
+                             const std::vector<std::vector<SqlValue>>& rows,
+                             const std::string& onDuplicateKeyUpdate = "");
+};
+
+/*
+ * SqlValue - One literal in a BatchInserter row
+ * Converts implicitly from strings, numbers and nullptr (SQL NULL).
+ */
+class SqlValue {
+public:
+    enum Kind { Null, Text, Integer, Unsigned, Real };
+
+    Kind kind;
+    std::string text;
+    long long integer;
+    unsigned long long unsignedInteger;
+    double real;
+
+    SqlValue(std::nullptr_t) : kind(Null), integer(0), unsignedInteger(0), real(0) {}
+    SqlValue(const char* value) : kind(value ? Text : Null), text(value ? value : ""),
+                                  integer(0), unsignedInteger(0), real(0) {}
+    SqlValue(std::string value) : kind(Text), text(std::move(value)), integer(0), unsignedInteger(0), real(0) {}
+    SqlValue(std::string_view value) : kind(Text), text(value), integer(0), unsignedInteger(0), real(0) {}
+    SqlValue(int value) : kind(Integer), integer(value), unsignedInteger(0), real(0) {}
+    SqlValue(long long value) : kind(Integer), integer(value), unsignedInteger(0), real(0) {}
+    SqlValue(unsigned long long value) : kind(Unsigned), integer(0), unsignedInteger(value), real(0) {}
+    SqlValue(double value) : kind(Real), integer(0), unsignedInteger(0), real(value) {}
+};
+
+inline void Database::appendLiteral(std::string& out, const SqlValue& value) {
+    char buffer[32];
+    switch (value.kind) {
+        case SqlValue::Null:
+            out += "NULL";
+            break;
+        case SqlValue::Text:
+            out += '\'';
+            appendEscaped(out, value.text);
+            out += '\'';
+            break;
+        case SqlValue::Integer:
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value.integer).ptr);
+            break;
+        case SqlValue::Unsigned:
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value.unsignedInteger).ptr);
+            break;
+        case SqlValue::Real:
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value.real).ptr);
+            break;
+    }
+}
+
+inline void Database::appendBound(std::string& out, std::string_view statement,
+                                  const std::vector<SqlValue>& params) {
+    // Size the output once: escaping at most doubles text, numbers fit in 32 bytes
+    size_t needed = statement.size();
+    for (const SqlValue& value : params) {
+        needed += value.kind == SqlValue::Text ? value.text.size() * 2 + 2 : 32;
+    }
+    out.reserve(out.size() + needed);
+
+    size_t next = 0;
+    char quote = 0;
+    for (size_t i = 0; i < statement.size(); i++) {
+        char c = statement[i];
+        if (quote) {
+            if (c == '\\' && i + 1 < statement.size()) {
+                out += c;
+                c = statement[++i];
+            } else if (c == quote) {
+                quote = 0;
+            }
+            out += c;
+        } else if (c == '\'' || c == '"' || c == '`') {
+            quote = c;
+            out += c;
+        } else if (c == '?') {
+            if (next >= params.size()) {
+                throw std::invalid_argument("Not enough parameters for: " + std::string(statement));
+            }
+            appendLiteral(out, params[next++]);
+        } else if (c == ';') {
+            throw std::invalid_argument("Expected a single statement: " + std::string(statement));
+        } else {
+            out += c;
+        }
+    }
+    if (next != params.size()) {
+        throw std::invalid_argument("Too many parameters for: " + std::string(statement));
+    }
+}
+
+/*
+ * BatchResult - What a BatchInserter sent and the IDs it generated
+ */
+struct BatchResult {
+    // AUTO_INCREMENT IDs of one INSERT statement: first, first + step, ...
+    struct IdRange {
+        unsigned long long first;
+        size_t count;
+        unsigned long long step;
+    };
+
+    size_t rows = 0;                        // Rows sent
+    size_t statements = 0;                  // INSERT statements executed
+    unsigned long long affectedRows = 0;    // Sum of affected rows (2 per updated duplicate)
+    std::vector<IdRange> idRanges;          // Empty for tables without AUTO_INCREMENT or with
+                                            // ON DUPLICATE KEY UPDATE (IDs are not contiguous)
+
+    // Generated ID of the n-th row added (0 if not known)
+    unsigned long long idAt(size_t row) const {
+        for (const auto& range : idRanges) {
+            if (row < range.count) {
+                return range.first + row * range.step;
+            }
+            row -= range.count;
+        }
+        return 0;
+    }
+};
+
+/*
+ * BatchInserter - Multi-row INSERT builder
+ * Rows are rendered as escaped literals and sent as
+ * INSERT ... VALUES (...),(...) statements, each kept below
+ * max_allowed_packet. Run it inside a transaction when the
+ * rows must be written all-or-nothing.
+ *
+ *   BatchInserter batch(db, "role_permissions", {"role_id", "permission_id"});
+ *   batch.addRow({roleId, permissionId});
+ *   const BatchResult& result = batch.finish();
+ */
+class BatchInserter {
+private:
+    Database& db;
+    std::string header;             // INSERT INTO t (a, b) VALUES
+    std::string suffix;             // ON DUPLICATE KEY UPDATE ...
+    size_t columnCount;
+    std::string pending;            // header + rows not yet sent
+    std::string row;                // Scratch buffer for the row being added
+    size_t pendingRows;
+    size_t packetLimit;
+    BatchResult result;
+
+public:
+    BatchInserter(Database& database, const std::string& table, const std::vector<std::string>& columns)
+        : db(database), columnCount(columns.size()), pendingRows(0), packetLimit(0) {
+        header = "INSERT INTO " + table + " (";
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (i > 0) header += ", ";
+            header += columns[i];
+        }
+        header += ") VALUES ";
+        pending = header;
+    }
+
+    BatchInserter(const BatchInserter&) = delete;
+    BatchInserter& operator=(const BatchInserter&) = delete;
+
+    // Raw ON DUPLICATE KEY UPDATE clause, e.g. "status = VALUES(status)"
+    BatchInserter& onDuplicateKeyUpdate(const std::string& assignments) {
+        suffix = assignments.empty() ? "" : " ON DUPLICATE KEY UPDATE " + assignments;
+        return *this;
+    }
+
+    // Overwrite the listed columns from the new row when the key already exists
+    BatchInserter& updateOnDuplicate(const std::vector<std::string>& columns) {
+        std::string assignments;
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (i > 0) assignments += ", ";
+            assignments += columns[i] + " = VALUES(" + columns[i] + ")";
+        }
+        return onDuplicateKeyUpdate(assignments);
+    }
+
+    // Queue one row; sends the pending statement first if the row would not fit
+    void addRow(const std::vector<SqlValue>& values) {
+        if (values.size() != columnCount) {
+            throw std::invalid_argument("BatchInserter: row has " + std::to_string(values.size()) +
+                                        " values, expected " + std::to_string(columnCount));
+        }
+        if (packetLimit == 0) {
+            // Leave room for the protocol header and the client's own framing
+            packetLimit = (size_t)std::min<unsigned long long>(db.getMaxAllowedPacket(), 16ULL * 1024 * 1024) - 1024;
+        }
+
+        row.clear();
+        row += '(';
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i > 0) row += ", ";
+            db.appendLiteral(row, values[i]);
+        }
+        row += ')';
+
+        if (pendingRows > 0 && pending.size() + 2 + row.size() + suffix.size() > packetLimit) {
+            flush();
+        }
+        if (header.size() + row.size() + suffix.size() > packetLimit) {
+            throw std::length_error("BatchInserter: row exceeds max_allowed_packet");
+        }
+        if (pendingRows > 0) pending += ", ";
+        pending += row;
+        pendingRows++;
+    }
+
+    // Send the queued rows as one INSERT statement
+    void flush() {
+        if (pendingRows == 0) return;
+
+        pending += suffix;
+        int affected = db.executeUpdate(pending);
+        unsigned long long firstId = db.getLastInsertId();
+
+        result.rows += pendingRows;
+        result.statements++;
+        result.affectedRows += (unsigned long long)affected;
+        // A multi-row INSERT gets consecutive IDs starting at mysql_insert_id()
+        if (firstId != 0 && suffix.empty()) {
+            result.idRanges.push_back({firstId, pendingRows, db.getAutoIncrementStep()});
+        }
+
+        pending.resize(header.size());
+        pendingRows = 0;
+    }
+
+    // Send anything still queued and return the totals
+    const BatchResult& finish() {
+        flush();
+        return result;
+    }
+
+    size_t getPendingRows() const {
+        return pendingRows;
+    }
 };
 
+/*
+ * QueryPipeline - Independent statements sent in one round trip
+ * Each statement may use ? placeholders; values are escaped into
+ * literals (outside quoted strings) because multi-statement
+ * packets go through the text protocol. Results come back in the
+ * order the statements were added. Do not pipeline statements
+ * that depend on each other's results, or reads that must see the
+ * caller's open transaction (the batch runs on its own handle).
+ *
+ *   QueryPipeline pipeline(db);
+ *   pipeline.add("SELECT COUNT(*) FROM students");
+ *   pipeline.add("SELECT name_en FROM courses WHERE id = ?", {courseId});
+ *   auto results = pipeline.execute();
+ */
+class QueryPipeline {
+private:
+    Database& db;
+    std::string sql;
+    size_t count;
+
+public:
+    explicit QueryPipeline(Database& database) : db(database), count(0) {}
+
+    QueryPipeline(const QueryPipeline&) = delete;
+    QueryPipeline& operator=(const QueryPipeline&) = delete;
+
+    // Queue a statement; params fill its ? placeholders in order
+    QueryPipeline& add(std::string_view statement, const std::vector<SqlValue>& params = {}) {
+        // A statement that fails to render leaves the pipeline unchanged
+        size_t start = sql.size();
+        if (count > 0) sql += ";\n";
+        try {
+            db.appendBound(sql, statement, params);
+        } catch (...) {
+            sql.resize(start);
+            throw;
+        }
+        count++;
+        return *this;
+    }
+
+    // Send every queued statement and collect their results
+    std::vector<std::unique_ptr<ResultSet>> execute() {
+        if (count == 0) return {};
+        auto results = db.executeMulti(sql);
+        sql.clear();
+        count = 0;
+        return results;
+    }
+
+    size_t size() const {
+        return count;
+    }
+};
+
+inline BatchResult Database::executeBatch(const std::string& table, const std::vector<std::string>& columns,
+                                          const std::vector<std::vector<SqlValue>>& rows,
+                                          const std::string& onDuplicateKeyUpdate) {
+    BatchInserter batch(*this, table, columns);
+    batch.onDuplicateKeyUpdate(onDuplicateKeyUpdate);
+    for (const auto& values : rows) {
+        batch.addRow(values);
+    }
+    return batch.finish();
+}
+
 #endif // DATABASE_H
@@ -0,0 +1,277 @@
+/*
+ * ============================================
+ * ENTITYFIELDS.H - Compile-Time Field Tables
+ * ============================================
+ * One table per entity lists every field once: result
+ * column, JSON key and member. The SELECT column list,
+ * the row decoder and the JSON serializer are generated
+ * from it, with the per-field work unrolled at compile
+ * time (a fold over the table, no runtime loop or lookup
+ * by name per row).
+ *
+ *   const auto& Grade::fields() {
+ *       static constexpr auto table = EntityFields::table(
+ *           EntityFields::member("id", "id", &Grade::id),
+ *           EntityFields::member("total_marks", "total", &Grade::total));
+ *       return table;
+ *   }
+ *
+ *   "SELECT " + EntityFields::selectList(fields(), "g.") + " FROM grades g"
+ *   vector<Grade> grades = EntityFields::readAll<Grade>(*result, fields());
+ *   EntityFields::writeObject(json, fields(), grade);
+ */
+
+#ifndef ENTITY_FIELDS_H
+#define ENTITY_FIELDS_H
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "Database.h"
+#include "JsonWriter.h"
+
+namespace EntityFields {
+
+/*
+ * MemberField - A column stored in a data member, or (with an empty
+ * column) a JSON-only value read through a const getter.
+ * An empty jsonKey keeps the field out of the JSON.
+ * source is the SQL expression when it is not simply the column
+ * (e.g. "u.email" or "CONCAT(...)"); it is selected AS column.
+ */
+template <typename Entity, typename Access>
+struct MemberField {
+    std::string_view column;
+    std::string_view jsonKey;
+    Access access;
+    std::string_view source;
+};
+
+/*
+ * ColumnField - A result column copied straight to JSON as T,
+ * for listings that never build an entity
+ */
+template <typename T>
+struct ColumnField {
+    std::string_view column;
+    std::string_view jsonKey;
+    std::string_view source;
+};
+
+template <typename Entity, typename Member>
+constexpr MemberField<Entity, Member Entity::*> member(std::string_view column, std::string_view jsonKey,
+                                                       Member Entity::* access,
+                                                       std::string_view source = {}) {
+    return { column, jsonKey, access, source };
+}
+
+template <typename Entity, typename Result>
+constexpr MemberField<Entity, Result (Entity::*)() const> computed(std::string_view jsonKey,
+                                                                   Result (Entity::* getter)() const) {
+    return { {}, jsonKey, getter, {} };
+}
+
+template <typename T>
+constexpr ColumnField<T> column(std::string_view column, std::string_view jsonKey,
+                                std::string_view source = {}) {
+    return { column, jsonKey, source };
+}
+
+template <typename... Fields>
+constexpr std::tuple<Fields...> table(Fields... fields) {
+    return std::tuple<Fields...>(fields...);
+}
+
+template <typename Table>
+constexpr size_t fieldCount = std::tuple_size<std::decay_t<Table>>::value;
+
+template <typename Table>
+using Columns = ColumnIndex<fieldCount<Table>>;
+
+// ========================================
+// Implementation details
+// ========================================
+namespace detail {
+
+inline void read(const ResultSet& result, int position, std::string& out) {
+    out.assign(result.getStringView(position));
+}
+inline void read(const ResultSet& result, int position, int& out) {
+    out = result.getInt(position);
+}
+inline void read(const ResultSet& result, int position, double& out) {
+    out = result.getDouble(position);
+}
+inline void read(const ResultSet& result, int position, bool& out) {
+    out = result.getBoolean(position);
+}
+
+template <typename T, typename Writer>
+void copy(Writer& json, const ResultSet& result, int position) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        json.value(result.getStringView(position));
+    } else if constexpr (std::is_same<T, bool>::value) {
+        json.value(result.getBoolean(position));
+    } else if constexpr (std::is_same<T, double>::value) {
+        json.value(result.getDouble(position));
+    } else {
+        json.value(static_cast<T>(result.getInt(position)));
+    }
+}
+
+template <typename Field>
+void appendSelected(std::string& out, const Field& field, std::string_view qualifier) {
+    if (field.column.empty()) {
+        return;
+    }
+    if (!out.empty()) {
+        out += ", ";
+    }
+    if (field.source.empty()) {
+        out.append(qualifier.data(), qualifier.size());
+        out.append(field.column.data(), field.column.size());
+        return;
+    }
+    out.append(field.source.data(), field.source.size());
+    // "u.email" already comes back as email
+    std::string_view source = field.source;
+    size_t dot = source.rfind('.');
+    std::string_view tail = dot == std::string_view::npos ? source : source.substr(dot + 1);
+    if (tail != field.column) {
+        out += " AS ";
+        out.append(field.column.data(), field.column.size());
+    }
+}
+
+template <typename Entity, typename Access>
+void decodeField(const ResultSet& result, int position, const MemberField<Entity, Access>& field,
+                 Entity& entity) {
+    if constexpr (std::is_member_object_pointer<Access>::value) {
+        if (!field.column.empty()) {
+            read(result, position, entity.*(field.access));
+        }
+    }
+}
+
+template <typename Entity, typename Access>
+void writeField(JsonWriter& json, const MemberField<Entity, Access>& field, const Entity& entity) {
+    if (!field.jsonKey.empty()) {
+        json.field(field.jsonKey, std::invoke(field.access, entity));
+    }
+}
+
+template <typename Writer, typename T>
+void copyField(Writer& json, const ResultSet& result, int position, const ColumnField<T>& field) {
+    json.key(field.jsonKey);
+    copy<T>(json, result, position);
+}
+
+template <typename Table, typename Entity, size_t... I>
+void decodeAll(const ResultSet& result, const Columns<Table>& columns, const Table& fields,
+               Entity& entity, std::index_sequence<I...>) {
+    (decodeField(result, columns[I], std::get<I>(fields), entity), ...);
+}
+
+template <typename Table, typename Entity, size_t... I>
+void writeAll(JsonWriter& json, const Table& fields, const Entity& entity, std::index_sequence<I...>) {
+    (writeField(json, std::get<I>(fields), entity), ...);
+}
+
+template <typename Writer, typename Table, size_t... I>
+void copyAll(Writer& json, const ResultSet& result, const Columns<Table>& columns,
+             const Table& fields, std::index_sequence<I...>) {
+    (copyField(json, result, columns[I], std::get<I>(fields)), ...);
+}
+
+} // namespace detail
+
+// ========================================
+// Generated operations
+// ========================================
+
+// "id, code, name_en" - every selected column, each prefixed with qualifier ("c.")
+// unless it has its own source expression
+template <typename Table>
+std::string selectList(const Table& fields, std::string_view qualifier = {}) {
+    std::string out;
+    std::apply([&](const auto&... field) {
+        (detail::appendSelected(out, field, qualifier), ...);
+    }, fields);
+    return out;
+}
+
+// Column positions, found once per result set
+template <typename Table>
+Columns<Table> resolve(const ResultSet& result, const Table& fields) {
+    Columns<Table> columns;
+    size_t i = 0;
+    std::apply([&](const auto&... field) {
+        ((columns.positions[i++] = field.column.empty() ? -1 : result.getFieldIndex(field.column)), ...);
+    }, fields);
+    return columns;
+}
+
+// Fill entity from the current row
+template <typename Table, typename Entity>
+void decode(const ResultSet& result, const Columns<Table>& columns, const Table& fields, Entity& entity) {
+    detail::decodeAll(result, columns, fields, entity, std::make_index_sequence<fieldCount<Table>>());
+}
+
+template <typename Entity, typename Table>
+Entity fromRow(const ResultSet& result, const Columns<Table>& columns, const Table& fields) {
+    Entity entity;
+    decode(result, columns, fields, entity);
+    return entity;
+}
+
+// Every remaining row of result
+template <typename Entity, typename Table>
+std::vector<Entity> readAll(ResultSet& result, const Table& fields) {
+    std::vector<Entity> entities;
+    entities.reserve(static_cast<size_t>(result.getRowCount()));
+    auto columns = resolve(result, fields);
+    while (result.next()) {
+        entities.push_back(fromRow<Entity>(result, columns, fields));
+    }
+    return entities;
+}
+
+// The next row of result, or an empty entity
+template <typename Entity, typename Table>
+Entity readFirst(ResultSet& result, const Table& fields) {
+    auto columns = resolve(result, fields);
+    return result.next() ? fromRow<Entity>(result, columns, fields) : Entity();
+}
+
+// {"key":value,...} for one entity
+template <typename Table, typename Entity>
+void writeObject(JsonWriter& json, const Table& fields, const Entity& entity) {
+    json.beginObject();
+    detail::writeAll(json, fields, entity, std::make_index_sequence<fieldCount<Table>>());
+    json.endObject();
+}
+
+template <typename Table, typename Entity>
+std::string toJson(const Table& fields, const Entity& entity) {
+    JsonWriter json;
+    writeObject(json, fields, entity);
+    return json.release();
+}
+
+// {"key":value,...} straight from the current row, for ColumnField tables.
+// Writer is a JsonWriter or a GridWriter.
+template <typename Writer, typename Table>
+void writeRow(Writer& json, const ResultSet& result, const Columns<Table>& columns,
+              const Table& fields) {
+    json.beginObject();
+    detail::copyAll(json, result, columns, fields, std::make_index_sequence<fieldCount<Table>>());
+    json.endObject();
+}
+
+} // namespace EntityFields
+
+#endif // ENTITY_FIELDS_H
@@ -10,7 +10,9 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include "Database.h"
+#include "EntityFields.h"
 
 class Grade {
 private:
@@ -35,6 +37,28 @@ public:
         double totalMax;
     };
 
+    // Every row of a grade listing run through GradeKernel in one pass:
+    // components in, grading out, band indexing GradeKernel's tables
+    struct GradedRows {
+        std::vector<double> assignment1, assignment2, yearWork, finalExam, maxMarks;
+        std::vector<double> total, percentage, gpa;
+        std::vector<uint8_t> band;
+        std::vector<char> dirty;        // Stored grading is out of date
+        bool anyDirty = false;
+    };
+
+    // A row of the GPA totals that differs from a rebuild from the grades
+    struct GpaTotalsMismatch {
+        std::string studentId;
+        std::string semesterId;             // Empty for the student's overall row
+        double storedPoints;
+        double expectedPoints;
+        int storedCredits;
+        int expectedCredits;
+        int storedDirty;
+        int expectedDirty;
+    };
+
     // Constructors
     Grade();
     Grade(const std::string& id, const std::string& registrationId);
@@ -65,12 +89,25 @@ public:
     static double getGpaFromPercentage(double percentage);
     static std::string getLetterGrade(double percentage);
 
+    // Reads the assignment1, assignment2, year_work, final_exam, max_marks
+    // and is_dirty columns of every row, grades them with GradeKernel::compute
+    // when any row is dirty, and rewinds result for the caller's own pass.
+    // Clean rows should keep their stored grading.
+    static GradedRows gradeRows(ResultSet& result);
+
+    // From the cache when the registration's course is in it (see
+    // GradeDistributionCache); otherwise loaded and cached
     static GradeDistribution getDistributionForRegistration(Database& db,
                                                             const std::string& registrationId);
+    // Distribution of the current row (max_marks, assignment1_marks,
+    // assignment2_marks, year_work_marks and final_exam_marks columns)
+    static GradeDistribution readDistribution(ResultSet& row);
 
     // Validation (returns empty string if valid, error message if invalid)
     static std::string validateGradeComponent(Database& db, const std::string& registrationId,
                                               const std::string& component, double value);
+    static std::string validateGradeComponent(const GradeDistribution& dist,
+                                              const std::string& component, double value);
 
     // Static database operations
     static std::vector<Grade> getAllGrades(Database& db);
@@ -80,10 +117,33 @@ public:
     static std::vector<Grade> getByCourseId(Database& db, const std::string& courseId,
                                             const std::string& semesterId);
     static bool calculateGrade(Database& db, const std::string& registrationId);
+
+    // Change tracking: component writes (save, update, updateComponent)
+    // only set grades.is_dirty and bump row_version, then notify
+    // GradeRecalculator. recalculateDirty grades every dirty row in one
+    // UPDATE ... JOIN and clears the flag. Readers grade dirty rows from
+    // their components (gradeRows) until they are drained.
+    // Return the number of rows changed, or -1 on error.
+    static int markCourseDirty(Database& db, const std::string& courseId);
+    static int recalculateDirty(Database& db);
+
+    // Read the student's row of student_gpa_totals (or of
+    // student_semester_gpa_totals), which triggers keep current. While
+    // the student has dirty grades the GPA is computed from the rows.
+    // Registered and completed courses count.
     static double calculateStudentCGPA(Database& db, const std::string& studentId);
     static double calculateStudentSemesterGPA(Database& db, const std::string& studentId,
                                               const std::string& semesterId);
 
+    // Rebuilds the GPA totals from the grades and returns the rows that
+    // differ from the tables. With repair, both tables are replaced by
+    // the rebuild in one transaction. Throws on database errors.
+    static std::vector<GpaTotalsMismatch> verifyGpaTotals(Database& db, bool repair = false);
+
+    // Field table: column, JSON key and member of every grade field
+    // (SELECT list, row decoder and toJson are generated from it)
+    static const auto& fields();
+
     // Instance database operations
     bool save(Database& db);
     bool update(Database& db);
@@ -95,4 +155,22 @@ public:
     bool isEmpty() const;
 };
 
+inline const auto& Grade::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &Grade::id),
+        member("registration_id", "registrationId", &Grade::registrationId),
+        member("assignment1", "assignment1", &Grade::assignment1),
+        member("assignment2", "assignment2", &Grade::assignment2),
+        member("year_work", "yearWork", &Grade::yearWork),
+        member("final_exam", "finalExam", &Grade::finalExam),
+        member("total_marks", "total", &Grade::total),
+        member("percentage", "percentage", &Grade::percentage),
+        member("gpa", "gpa", &Grade::gpa),
+        member("evaluation", "evaluation", &Grade::evaluation),
+        member("letter_grade", "letterGrade", &Grade::letterGrade)
+    );
+    return table;
+}
+
 #endif // GRADE_H
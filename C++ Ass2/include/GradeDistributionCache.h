@@ -0,0 +1,80 @@
+/*
+ * ============================================
+ * GRADEDISTRIBUTIONCACHE.H - Cached Mark Limits
+ * ============================================
+ * Every grade entry is validated against its course's
+ * distribution (the assignment, year work, final exam and
+ * total marks), which only changes when the course is
+ * edited. Distributions are kept here by course ID, along
+ * with the course and semester of each registration seen
+ * in a roster load, so validating an entry needs no query.
+ *
+ * Code that edits or deletes a course calls
+ * invalidateCourse(); deleting a registration calls
+ * forgetRegistration(). Each of them bumps a generation
+ * counter, and a load that started before the bump is not
+ * stored, so a racing reader cannot put back stale limits.
+ */
+
+#ifndef GRADE_DISTRIBUTION_CACHE_H
+#define GRADE_DISTRIBUTION_CACHE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "Grade.h"
+
+/*
+ * GradeDistributionCache - Process-wide course distributions and
+ * registration -> course map
+ */
+class GradeDistributionCache {
+public:
+    struct Placement {
+        std::string courseId;
+        std::string semesterId;
+    };
+
+    // Registrations remembered before the map is cleared and refilled
+    static constexpr size_t MAX_REGISTRATIONS = 200000;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Grade::GradeDistribution> courses;
+    std::unordered_map<std::string, Placement> registrations;
+    std::atomic<uint64_t> generation{1};
+
+    GradeDistributionCache() = default;
+
+public:
+    static GradeDistributionCache& instance();
+
+    GradeDistributionCache(const GradeDistributionCache&) = delete;
+    GradeDistributionCache& operator=(const GradeDistributionCache&) = delete;
+
+    // Read before loading from the database and pass to store()
+    uint64_t currentGeneration() const { return generation.load(); }
+
+    // Distribution of registrationId's course; false unless both are cached
+    bool find(const std::string& registrationId, Grade::GradeDistribution& dist) const;
+
+    // Course and semester of registrationId; false when it is not cached
+    bool findPlacement(const std::string& registrationId, Placement& placement) const;
+
+    // A course's distribution and registrations of it (e.g. a roster).
+    // Dropped when anything was invalidated since loadedGeneration.
+    void store(const std::string& courseId, const std::string& semesterId,
+               const Grade::GradeDistribution& dist,
+               const std::vector<std::string>& registrationIds, uint64_t loadedGeneration);
+
+    // The course's marks changed or it was deleted
+    void invalidateCourse(const std::string& courseId);
+
+    // The registration was deleted
+    void forgetRegistration(const std::string& registrationId);
+};
+
+#endif // GRADE_DISTRIBUTION_CACHE_H
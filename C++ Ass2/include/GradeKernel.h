@@ -0,0 +1,74 @@
+/*
+ * ============================================
+ * GRADEKERNEL.H - Batch Grade Computation
+ * ============================================
+ * Grades many registrations at once from structure-of-
+ * arrays input: one array per component instead of one
+ * struct per row, so totals and percentages are computed
+ * several rows per instruction (AVX2: 4, SSE2: 2).
+ *
+ * The grading band is found without branches: it is the
+ * number of band thresholds the percentage falls below,
+ * and indexes the GPA, evaluation and letter tables.
+ * The scalar functions give the same results row by row.
+ */
+
+#ifndef GRADE_KERNEL_H
+#define GRADE_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * GradeKernel - Grading bands and the batch kernel
+ */
+class GradeKernel {
+public:
+    // Band codes, best first
+    enum Band : uint8_t { BAND_A, BAND_B, BAND_C, BAND_D, BAND_F, BAND_COUNT };
+
+    // Lowest percentage of each band (BAND_F has no threshold)
+    static const double MIN_PERCENTAGE[BAND_COUNT];
+    static const double GPA[BAND_COUNT];
+    static const char* const EVALUATION[BAND_COUNT];
+    static const char* const LETTER[BAND_COUNT];
+
+    // Component arrays of count rows
+    struct Input {
+        const double* assignment1;
+        const double* assignment2;
+        const double* yearWork;
+        const double* finalExam;
+        const double* maxMarks;
+        size_t count;
+    };
+
+    // Result arrays, count rows each
+    struct Output {
+        double* total;
+        double* percentage;
+        double* gpa;
+        uint8_t* band;
+    };
+
+    // Counts the thresholds not reached; NaN reaches none and lands in BAND_F
+    static Band bandOf(double percentage) {
+        return static_cast<Band>(!(percentage >= MIN_PERCENTAGE[BAND_A]) + !(percentage >= MIN_PERCENTAGE[BAND_B]) +
+                                 !(percentage >= MIN_PERCENTAGE[BAND_C]) + !(percentage >= MIN_PERCENTAGE[BAND_D]));
+    }
+
+    static double percentageOf(double total, double maxMarks) {
+        return maxMarks > 0 ? total / maxMarks * 100.0 : 0.0;
+    }
+
+    // Grades every row of in; SIMD where the target supports it
+    static void compute(const Input& in, const Output& out);
+
+    // The same, one row at a time (reference and fallback)
+    static void computeScalar(const Input& in, const Output& out, size_t first = 0);
+
+    // Name of the instruction set compute() uses
+    static const char* vectorPath();
+};
+
+#endif // GRADE_KERNEL_H
@@ -0,0 +1,57 @@
+/*
+ * ============================================
+ * GRADERECALCULATOR.H - Background Grade Drain
+ * ============================================
+ * Writes that change a grade's components or its course's
+ * mark distribution only mark the grade dirty. This thread
+ * recomputes every dirty grade in one statement, shortly
+ * after being notified or every INTERVAL otherwise, so
+ * readers almost never see a dirty row.
+ */
+
+#ifndef GRADE_RECALCULATOR_H
+#define GRADE_RECALCULATOR_H
+
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "ConnectionPool.h"
+
+/*
+ * GradeRecalculator - Process-wide drain of grades.is_dirty
+ */
+class GradeRecalculator {
+public:
+    static constexpr std::chrono::seconds INTERVAL{5};
+
+private:
+    ConnectionPool* pool;
+    bool running;
+    bool pending;                   // Notified since the last drain
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::thread worker;
+
+    GradeRecalculator();
+    void run();
+
+public:
+    ~GradeRecalculator();
+
+    GradeRecalculator(const GradeRecalculator&) = delete;
+    GradeRecalculator& operator=(const GradeRecalculator&) = delete;
+
+    static GradeRecalculator& instance();
+
+    // Start draining with connections from connectionPool
+    void start(ConnectionPool& connectionPool);
+
+    // Finish the current drain and stop the thread
+    void stop();
+
+    // Grades were marked dirty: drain soon
+    void notify();
+};
+
+#endif // GRADE_RECALCULATOR_H
@@ -10,6 +10,7 @@
 #define JSONHELPER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <sstream>
@@ -37,6 +38,22 @@ public:
      */
     static std::string makeString(const std::string& value);
 
+    /*
+     * appendString - Appends a quoted, escaped JSON string to out
+     * 
+     * Writes straight into the caller's buffer, so large responses
+     * can be built in one string without per-value temporaries.
+     */
+    static void appendString(std::string& out, std::string_view value);
+
+    /*
+     * appendEscaped - Appends the escaped contents without quotes
+     * 
+     * Scans 16 (SSE2) or 32 (AVX2) bytes at a time for characters
+     * that need escaping and copies the clean spans in bulk.
+     */
+    static void appendEscaped(std::string& out, std::string_view value);
+
     /*
      * makeNumber - Creates a JSON number value
      */
@@ -68,10 +85,10 @@ public:
     static std::string makeObject(const std::vector<std::pair<std::string, std::string>>& pairs);
 
     /*
-     * parseSimpleValue - Extracts a simple value from JSON
+     * parseSimpleValue - Extracts one top-level value from a request
      * 
-     * WARNING: This is a very basic parser. For complex JSON,
-     * use nlohmann/json library.
+     * Convenience wrapper around JsonRequest for a single key;
+     * returns "" when the key is missing.
      */
     static std::string parseSimpleValue(const std::string& json, const std::string& key);
 
@@ -0,0 +1,114 @@
+/*
+ * ============================================
+ * JSONREQUEST.H - Binding Request Parser
+ * ============================================
+ * Parses the arguments of a binding call once and indexes
+ * the top-level keys, so handlers look each field up in
+ * O(1) instead of rescanning the request per key.
+ *
+ *   JsonRequest args(request);
+ *   string courseId = args.getString("courseId");
+ *   int creditHours = args.getInt("creditHours");
+ *   int labHours = args.getInt("labHours", 0);
+ */
+
+#ifndef JSON_REQUEST_H
+#define JSON_REQUEST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/*
+ * JsonRequest - Flat key -> value index over one JSON object
+ *
+ * Accepts the object itself, or the argument array webview
+ * passes to a binding ([{...}] or ["{...}"] when the page
+ * sent JSON.stringify output); the first argument is used.
+ *
+ * String values are unescaped (\" \\ \/ \b \f \n \r \t and
+ * \uXXXX including surrogate pairs, as UTF-8) into an arena
+ * owned by the request; values without escapes point straight
+ * into the source text. Numbers, true/false/null and nested
+ * objects or arrays are returned as their raw JSON text.
+ *
+ * The source text must outlive the JsonRequest.
+ */
+class JsonRequest {
+public:
+    enum class Type : uint8_t { STRING, NUMBER, BOOLEAN, NUL, OBJECT, ARRAY };
+
+private:
+    struct Field {
+        std::string_view key;
+        std::string_view value;
+        Type type;
+    };
+
+    static constexpr int MAX_DEPTH = 64;
+
+    std::vector<Field> fields;
+    std::vector<uint32_t> slots;            // Open-addressing table of field index + 1
+    std::unique_ptr<char[]> arena;          // Unescaped strings; sized so it never moves
+    size_t arenaUsed;
+    bool valid;
+
+    // Tokenizer state (only used while parsing)
+    const char* pos;
+    const char* end;
+
+    void parseDocument(std::string_view json);
+    bool parseObject(bool index);
+    bool parseValue(std::string_view& value, Type& type, int depth);
+    bool parseString(std::string_view& value);
+    bool skipContainer(char open, int depth);
+    void skipWhitespace();
+    void appendUtf8(char*& out, uint32_t codePoint);
+    bool readHex4(uint32_t& codePoint);
+
+    void addField(std::string_view key, std::string_view value, Type type);
+    const Field* find(std::string_view key) const;
+    static size_t hashKey(std::string_view key);
+
+public:
+    explicit JsonRequest(std::string_view json);
+
+    JsonRequest(const JsonRequest&) = delete;
+    JsonRequest& operator=(const JsonRequest&) = delete;
+
+    // false when the request was not well-formed; keys read before the error are kept
+    bool isValid() const { return valid; }
+    size_t size() const { return fields.size(); }
+
+    bool has(std::string_view key) const { return find(key) != nullptr; }
+    bool isNull(std::string_view key) const;
+
+    // Unescaped string or raw JSON text; empty when the key is missing
+    std::string_view get(std::string_view key) const;
+    std::string getString(std::string_view key) const { return std::string(get(key)); }
+
+    // Numbers given either as JSON numbers or as numeric strings.
+    // Without a fallback a missing or malformed value throws std::invalid_argument;
+    // with one, missing/empty/null values return it (malformed ones still throw).
+    int getInt(std::string_view key) const;
+    int getInt(std::string_view key, int fallback) const;
+    long long getLong(std::string_view key) const;
+    long long getLong(std::string_view key, long long fallback) const;
+    double getDouble(std::string_view key) const;
+    double getDouble(std::string_view key, double fallback) const;
+
+    // true, "true" and "1" are true; anything else (or missing) is false
+    bool getBool(std::string_view key) const;
+
+    /*
+     * elements - Raw JSON text of each element of a top-level array,
+     * e.g. the arguments webview passes to a binding. Strings keep
+     * their quotes and escapes. Empty when json is not a well-formed
+     * array. The views point into json.
+     */
+    static std::vector<std::string_view> elements(std::string_view json);
+};
+
+#endif // JSON_REQUEST_H
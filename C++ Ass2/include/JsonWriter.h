@@ -0,0 +1,214 @@
+/*
+ * ============================================
+ * JSONWRITER.H - Streaming JSON Writer
+ * ============================================
+ * Builds a JSON document directly into one growable
+ * buffer: no per-value temporaries, numbers formatted
+ * with std::to_chars, strings always escaped.
+ *
+ *   JsonWriter json;
+ *   json.beginArray();
+ *   while (result->next()) {
+ *       json.beginObject()
+ *           .field("id", result->getStringView(COL_ID))
+ *           .field("credits", result->getInt(COL_CREDITS))
+ *           .endObject();
+ *   }
+ *   json.endArray();
+ *   return json.release();
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include "JsonHelper.h"
+
+class JsonWriter {
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    std::string out;
+    uint64_t hasItems;      // Bit n: container at depth n already holds a value
+    int depth;
+    bool afterKey;          // A key was written; the next value belongs to it
+
+    // Comma before the next key or array element
+    void separate() {
+        if (afterKey) {
+            afterKey = false;
+            return;
+        }
+        if (depth > 0) {
+            uint64_t bit = 1ULL << (depth - 1);
+            if (hasItems & bit) out += ',';
+            hasItems |= bit;
+        }
+    }
+
+    void open(char bracket) {
+        separate();
+        if (depth >= MAX_DEPTH) {
+            throw std::length_error("JsonWriter: nesting too deep");
+        }
+        out += bracket;
+        hasItems &= ~(1ULL << depth);
+        depth++;
+    }
+
+    void close(char bracket) {
+        if (depth > 0) depth--;
+        out += bracket;
+    }
+
+    template <typename T>
+    void appendNumber(T number) {
+        char buffer[32];
+        out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), number).ptr);
+    }
+
+public:
+    explicit JsonWriter(size_t reserveBytes = 256) : hasItems(0), depth(0), afterKey(false) {
+        out.reserve(reserveBytes);
+    }
+
+    JsonWriter& beginObject() { open('{'); return *this; }
+    JsonWriter& endObject() { close('}'); return *this; }
+    JsonWriter& beginArray() { open('['); return *this; }
+    JsonWriter& endArray() { close(']'); return *this; }
+
+    JsonWriter& key(std::string_view name) {
+        separate();
+        JsonHelper::appendString(out, name);
+        out += ':';
+        afterKey = true;
+        return *this;
+    }
+
+    JsonWriter& value(std::string_view text) {
+        separate();
+        JsonHelper::appendString(out, text);
+        return *this;
+    }
+
+    JsonWriter& value(const char* text) {
+        return text ? value(std::string_view(text)) : null();
+    }
+
+    JsonWriter& value(const std::string& text) {
+        return value(std::string_view(text));
+    }
+
+    JsonWriter& value(int number) {
+        separate();
+        appendNumber(number);
+        return *this;
+    }
+
+    JsonWriter& value(long number) {
+        separate();
+        appendNumber(number);
+        return *this;
+    }
+
+    JsonWriter& value(unsigned long number) {
+        separate();
+        appendNumber(number);
+        return *this;
+    }
+
+    JsonWriter& value(long long number) {
+        separate();
+        appendNumber(number);
+        return *this;
+    }
+
+    JsonWriter& value(unsigned long long number) {
+        separate();
+        appendNumber(number);
+        return *this;
+    }
+
+    // Shortest form that reads back as the same double
+    JsonWriter& value(double number) {
+        separate();
+        if (!std::isfinite(number)) {
+            out += "null";
+        } else {
+            appendNumber(number);
+        }
+        return *this;
+    }
+
+    // Fixed number of decimals (like JsonHelper::makeNumber(double) with 2)
+    JsonWriter& value(double number, int decimals) {
+        separate();
+        if (!std::isfinite(number)) {
+            out += "null";
+        } else {
+            char buffer[64];
+            auto written = std::to_chars(buffer, buffer + sizeof(buffer), number,
+                                         std::chars_format::fixed, decimals);
+            out.append(buffer, written.ptr);
+        }
+        return *this;
+    }
+
+    JsonWriter& value(bool flag) {
+        separate();
+        out += flag ? "true" : "false";
+        return *this;
+    }
+
+    JsonWriter& null() {
+        separate();
+        out += "null";
+        return *this;
+    }
+
+    // Already serialized JSON (e.g. a cached fragment), written as is
+    JsonWriter& raw(std::string_view json) {
+        separate();
+        out.append(json.data(), json.size());
+        return *this;
+    }
+
+    // key(name).value(v) in one call
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+    JsonWriter& field(std::string_view name, double number, int decimals) {
+        key(name);
+        return value(number, decimals);
+    }
+
+    JsonWriter& nullField(std::string_view name) {
+        key(name);
+        return null();
+    }
+
+    // Direct access for callers that append their own pieces
+    std::string& buffer() { return out; }
+    const std::string& str() const { return out; }
+    size_t size() const { return out.size(); }
+
+    // Hand the document over and start again with an empty buffer
+    std::string release() {
+        std::string document = std::move(out);
+        out.clear();
+        hasItems = 0;
+        depth = 0;
+        afterKey = false;
+        return document;
+    }
+};
+
+#endif // JSON_WRITER_H
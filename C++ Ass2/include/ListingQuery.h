@@ -0,0 +1,165 @@
+/*
+ * ============================================
+ * LISTINGQUERY.H - Paged, Filtered Listings
+ * ============================================
+ * Builds the query behind a listing binding: optional
+ * filters from the request, keyset pagination and a
+ * capped total count. Pages continue from the last row
+ * sent (WHERE key > last key ... LIMIT n) instead of
+ * OFFSET, so every page costs an index range scan of n
+ * rows however deep into the table it is.
+ *
+ *   ListingQuery listing(columns, "students s ...", "students", {{"s.id", "id"}});
+ *   listing.whereEquals("s.department_id", args.get("departmentId"));
+ *   listing.wherePrefix({"s.id", "s.last_name"}, args.get("search"));
+ *   listing.page(args);
+ *   auto result = listing.execute(db);
+ *   return listing.respond(db, *result, [&](JsonWriter& json) { ... });
+ *
+ * Requests without "after" or "limit" get every matching
+ * row as a plain JSON array, as before. Paged requests get
+ *   {"items":[...],"next":"<cursor>"|null,"total":N,"totalExact":true|false}
+ * and send "next" back as "after" for the following page.
+ * total is only computed for the first page.
+ */
+
+#ifndef LISTING_QUERY_H
+#define LISTING_QUERY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <initializer_list>
+#include "Database.h"
+#include "JsonRequest.h"
+#include "JsonWriter.h"
+
+/*
+ * ListingQuery - SELECT with filters, a keyset cursor and a page size
+ */
+class ListingQuery {
+public:
+    /*
+     * SortKey - One ORDER BY term. The keys together must be unique
+     * (end with the primary key) and should match an index.
+     */
+    struct SortKey {
+        std::string expression;         // SQL expression, e.g. "r.created_at"
+        std::string column;             // Its name in the result, e.g. "created_at"
+        bool descending = false;
+    };
+
+    static constexpr int DEFAULT_LIMIT = 50;
+    static constexpr int MAX_LIMIT = 500;
+    static constexpr long long COUNT_CAP = 10000;   // Counting stops here
+
+private:
+    std::string columns;
+    std::string from;
+    std::string baseTable;              // For the row estimate past COUNT_CAP
+    std::vector<SortKey> keys;
+
+    std::string filters;                // " AND ..." terms
+    std::vector<std::string> filterParams;
+    std::vector<std::string> after;     // Key values of the last row sent
+    int limit;
+    bool paged;
+
+    static std::string encodeCursor(const std::vector<std::string_view>& values);
+    static std::vector<std::string> decodeCursor(std::string_view cursor);
+
+    void bindFilters(PreparedStatement& stmt, int& index) const;
+    void writeTotal(Database& db, JsonWriter& json) const;
+
+public:
+    ListingQuery(std::string columns, std::string from, std::string baseTable,
+                 std::vector<SortKey> keys);
+
+    // ========================================
+    // FILTERS (all must match)
+    // ========================================
+
+    // expression = value; skipped when value is empty
+    void whereEquals(std::string_view expression, std::string_view value);
+
+    // Any of expressions starts with prefix; skipped when prefix is empty.
+    // A prefix (LIKE 'abc%') can still use an index, unlike a substring.
+    void wherePrefix(std::initializer_list<std::string_view> expressions, std::string_view prefix);
+
+    // A fixed condition without parameters, e.g. "u.is_active = TRUE"
+    void where(std::string_view condition);
+
+    // ========================================
+    // PAGING
+    // ========================================
+
+    // Reads "after" and "limit" from the request. Throws std::invalid_argument
+    // for a cursor that does not belong to this listing.
+    void page(const JsonRequest& args);
+
+    bool isPaged() const { return paged; }
+    int pageLimit() const { return limit; }
+
+    // Full SQL text (filters, keyset condition, ORDER BY, LIMIT ?)
+    std::string sql() const;
+
+    // Runs the query; a paged query returns up to limit + 1 rows,
+    // the extra one only telling respond() that another page exists.
+    // With stream, an unpaged listing without filters streams its rows
+    // from the server instead of buffering the whole result first.
+    std::unique_ptr<ResultSet> execute(Database& db, bool stream = false) const;
+
+    /*
+     * respond - Writes the response for result
+     *
+     * writeRow(json) writes the current row as one JSON value.
+     * reserve is the initial buffer size.
+     */
+    template <typename WriteRow>
+    std::string respond(Database& db, ResultSet& result, WriteRow writeRow, size_t reserve = 4096) const {
+        JsonWriter json(reserve);
+        if (!paged) {
+            json.beginArray();
+            while (result.next()) {
+                writeRow(json);
+            }
+            json.endArray();
+            return json.release();
+        }
+
+        std::vector<int> keyColumns;
+        keyColumns.reserve(keys.size());
+        for (const SortKey& key : keys) {
+            keyColumns.push_back(result.getFieldIndex(key.column));
+        }
+
+        json.beginObject().key("items").beginArray();
+        std::string next;
+        int written = 0;
+        while (result.next()) {
+            if (written == limit) {
+                // One row past the page: the page's last key becomes the cursor
+                json.endArray().key("next").value(next);
+                writeTotal(db, json);
+                json.endObject();
+                return json.release();
+            }
+            writeRow(json);
+            if (++written == limit) {
+                std::vector<std::string_view> values;
+                values.reserve(keyColumns.size());
+                for (int column : keyColumns) {
+                    values.push_back(result.getStringView(column));
+                }
+                next = encodeCursor(values);
+            }
+        }
+        json.endArray().key("next").null();
+        writeTotal(db, json);
+        json.endObject();
+        return json.release();
+    }
+};
+
+#endif // LISTING_QUERY_H
@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 #include "Database.h"
+#include "EntityFields.h"
 
 // NOTE: Do NOT use "using namespace std;" in header files as it causes
 // conflicts with Windows SDK types like "byte" when used with C++17.
@@ -71,9 +72,30 @@ public:
     bool update(Database& db);
     bool remove(Database& db);
 
+    // Field table: column, JSON key and member of every professor field
+    // (SELECT list, row decoder and toJson are generated from it)
+    static const auto& fields();
+
     // Utility methods
     std::string toJson() const;
     bool isEmpty() const;
 };
 
+inline const auto& Professor::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &Professor::id),
+        member("user_id", "", &Professor::userId),
+        member("first_name", "firstName", &Professor::firstName),
+        member("last_name", "lastName", &Professor::lastName),
+        computed("fullName", &Professor::getFullName),
+        member("email", "email", &Professor::email, "u.email"),
+        member("phone", "phone", &Professor::phone, "u.phone"),
+        member("department_id", "departmentId", &Professor::departmentId),
+        member("hire_date", "hireDate", &Professor::hireDate),
+        member("specialization", "specialization", &Professor::specialization)
+    );
+    return table;
+}
+
 #endif // PROFESSOR_H
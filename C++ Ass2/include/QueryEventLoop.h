@@ -0,0 +1,92 @@
+/*
+ * ============================================
+ * QUERYEVENTLOOP.H - Asynchronous Query Execution
+ * ============================================
+ * A single background thread that drives many queries
+ * at once through the MySQL 8 non-blocking C API
+ * (mysql_real_query_nonblocking / mysql_store_result_nonblocking).
+ * Each query runs on its own connection and its result
+ * is delivered through a std::future. The loop thread
+ * starts with the first query; main() stops it on exit.
+ */
+
+#ifndef QUERY_EVENT_LOOP_H
+#define QUERY_EVENT_LOOP_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "Database.h"
+#include "ConnectionPool.h"
+#include "QueryStats.h"
+
+// The non-blocking API appeared in MySQL 8.0.16 (MariaDB has a different one)
+#if defined(MYSQL_VERSION_ID) && MYSQL_VERSION_ID >= 80016 && !defined(MARIADB_BASE_VERSION)
+#define SIS_HAVE_NONBLOCKING_MYSQL 1
+#else
+#define SIS_HAVE_NONBLOCKING_MYSQL 0
+#endif
+
+/*
+ * QueryEventLoop - Process-wide loop for in-flight queries
+ * Without the non-blocking API each query runs as a blocking
+ * call on its own std::async thread instead.
+ */
+class QueryEventLoop {
+private:
+    struct Operation {
+        MYSQL* conn;
+        std::string query;
+        PooledConnection lease;     // Keeps a pooled connection checked out until done
+        std::promise<std::unique_ptr<ResultSet>> promise;
+        bool sent = false;          // Query finished, fetching the result
+        QueryStats::Clock::time_point started;
+        const char* binding;        // Binding that submitted it, for the query stats
+    };
+
+    std::vector<std::unique_ptr<Operation>> incoming;
+    bool running;
+    std::mutex mtx;
+    std::condition_variable wake;   // Wakes the loop while no query is in flight
+    std::thread worker;
+
+#if SIS_HAVE_NONBLOCKING_MYSQL
+    // Wakes the loop out of poll() while queries are in flight: a pipe, or
+    // on Windows a loopback UDP socket connected to itself (send == receive)
+    my_socket wakeReceive;
+    my_socket wakeSend;
+    bool wakeReady = false;
+
+    void openWakeChannel();
+    void closeWakeChannel();
+    void signalWake();
+    void drainWake();
+    void waitForSockets(const std::vector<std::unique_ptr<Operation>>& active);
+#endif
+
+    QueryEventLoop();
+    void run();
+    bool step(Operation& op);       // true once the promise has been fulfilled
+
+public:
+    ~QueryEventLoop();
+
+    QueryEventLoop(const QueryEventLoop&) = delete;
+    QueryEventLoop& operator=(const QueryEventLoop&) = delete;
+
+    static QueryEventLoop& instance();
+
+    // Run query on conn; the connection must not be used until the future is ready.
+    // A lease passed along is released after the result has been fetched.
+    std::future<std::unique_ptr<ResultSet>> submit(MYSQL* conn, std::string query,
+                                                   PooledConnection lease = PooledConnection());
+
+    // Fail every queued query and stop the loop thread
+    void stop();
+};
+
+#endif // QUERY_EVENT_LOOP_H
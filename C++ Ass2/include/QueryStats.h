@@ -0,0 +1,136 @@
+/*
+ * ============================================
+ * QUERYSTATS.H - Per-Statement Query Statistics
+ * ============================================
+ * Groups executed SQL by fingerprint (literals replaced
+ * with ?) and keeps call counts, rows, bytes and a latency
+ * histogram for each, plus a log of slow queries with the
+ * binding that issued them.
+ */
+
+#ifndef QUERY_STATS_H
+#define QUERY_STATS_H
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/*
+ * LatencyHistogram - HDR-style log-linear histogram of microseconds
+ * Every power of two is split into 16 linear sub-buckets, so any
+ * recorded value is reported within ~6% of its true value.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_MAGNITUDE = 36;            // Clamp at 2^36 us (~19 hours)
+    static constexpr int BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> counts{};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t maxValue = 0;
+
+    static int indexOf(uint64_t micros);
+    static uint64_t upperBoundOf(int index);
+
+public:
+    void record(uint64_t micros);
+
+    // Smallest value at or above which (100 - percent)% of samples lie
+    uint64_t percentile(double percent) const;
+
+    uint64_t count() const { return total; }
+    uint64_t totalMicros() const { return sum; }
+    uint64_t max() const { return maxValue; }
+};
+
+/*
+ * QueryStats - Process-wide statement statistics
+ */
+class QueryStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct StatementStats {
+        std::string fingerprint;
+        uint64_t calls = 0;
+        uint64_t rows = 0;          // Rows returned (SELECT) or affected (writes)
+        uint64_t bytes = 0;         // Statement text sent plus result payload
+        LatencyHistogram latency;
+    };
+
+    struct SlowQuery {
+        std::chrono::system_clock::time_point at;
+        std::string binding;
+        std::string fingerprint;    // Never the raw SQL: it may carry passwords
+        uint64_t micros;
+        uint64_t rows;
+    };
+
+    /*
+     * BindingScope - Names the binding running on this thread
+     * Queries recorded while the scope is alive are attributed to it.
+     */
+    class BindingScope {
+    private:
+        const char* previous;
+
+    public:
+        explicit BindingScope(const char* name);
+        ~BindingScope();
+        BindingScope(const BindingScope&) = delete;
+        BindingScope& operator=(const BindingScope&) = delete;
+    };
+
+private:
+    mutable std::mutex mtx;
+    std::unordered_map<std::string, std::unique_ptr<StatementStats>> byFingerprint;
+    std::unordered_map<std::string_view, StatementStats*> byText;   // Raw SQL -> entry, skips re-fingerprinting
+    std::deque<std::string> texts;                                  // Owns the byText keys
+    std::deque<SlowQuery> slowLog;
+    uint64_t generation;                                            // Bumped by reset()
+    std::atomic<bool> enabled;
+    std::chrono::microseconds slowThreshold;
+    size_t slowLogCapacity;
+
+    static thread_local const char* currentBinding;
+
+    QueryStats();
+    StatementStats& entryFor(std::string_view sql, std::string key);
+
+public:
+    static QueryStats& instance();
+
+    // SQL with literals replaced by ?, whitespace collapsed and value lists folded
+    static std::string fingerprint(std::string_view sql);
+
+    // Name of the binding running on this thread ("" outside a binding)
+    static const char* bindingName();
+
+    // Record one execution that started at started
+    void record(std::string_view sql, Clock::time_point started, uint64_t rows, uint64_t bytes,
+                const char* binding = bindingName());
+
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool on);
+    void setSlowQueryThreshold(std::chrono::microseconds threshold);
+    void setSlowLogCapacity(size_t entries);
+
+    // Forget everything recorded so far
+    void reset();
+
+    // Statements ordered by total time, and the slow query log, as JSON
+    std::string toJson() const;
+};
+
+#endif // QUERY_STATS_H
@@ -0,0 +1,104 @@
+/*
+ * ============================================
+ * REFERENCECACHE.H - Cached Reference Data
+ * ============================================
+ * Levels, departments, colleges, semesters, course types,
+ * halls and labs change a few times a term but are loaded
+ * by every page. Their dropdown JSON is kept here already
+ * serialized, along with the current semester.
+ *
+ * Each table has a version counter. Code that writes one
+ * of these tables calls invalidate(), which bumps it; the
+ * next reader reloads. Entries also expire after MAX_AGE,
+ * so changes made outside the application show up too.
+ */
+
+#ifndef REFERENCE_CACHE_H
+#define REFERENCE_CACHE_H
+
+#include <string>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+#include "Database.h"
+
+/*
+ * ReferenceCache - Process-wide, versioned cache of reference tables
+ */
+class ReferenceCache {
+public:
+    enum Table {
+        ACADEMIC_LEVELS,
+        DEPARTMENTS,
+        COLLEGES,
+        SEMESTERS,
+        COURSE_TYPES,
+        LECTURE_HALLS,
+        LABORATORIES,
+        TABLE_COUNT
+    };
+
+    using Clock = std::chrono::steady_clock;
+    using Loader = std::function<std::string(Database&)>;
+
+    static constexpr std::chrono::minutes MAX_AGE{10};
+
+    struct CurrentSemester {
+        std::string id;
+        int semesterNumber = 0;
+        bool found = false;
+    };
+
+private:
+    struct Entry {
+        std::mutex loadMutex;                   // One loader at a time per table
+        std::shared_ptr<const std::string> json;
+        uint64_t version = 0;                   // Table version the JSON was built from
+        Clock::time_point loadedAt;
+    };
+
+    std::array<std::atomic<uint64_t>, TABLE_COUNT> versions;
+    std::array<Entry, TABLE_COUNT> entries;
+
+    std::mutex semesterMutex;
+    CurrentSemester semester;
+    uint64_t semesterVersion = 0;
+    Clock::time_point semesterLoadedAt;
+    bool semesterLoaded = false;
+
+    ReferenceCache();
+
+    bool isFresh(uint64_t loadedVersion, Clock::time_point loadedAt, Table table) const;
+
+public:
+    static ReferenceCache& instance();
+
+    ReferenceCache(const ReferenceCache&) = delete;
+    ReferenceCache& operator=(const ReferenceCache&) = delete;
+
+    /*
+     * get - JSON for table, from the cache or built by load(db)
+     *
+     * Concurrent callers of a stale table wait for one load instead of
+     * each querying. An exception from load is passed on and nothing is
+     * cached.
+     */
+    std::shared_ptr<const std::string> get(Table table, Database& db, const Loader& load);
+
+    // The semester marked is_current; found is false when there is none
+    CurrentSemester currentSemester(Database& db);
+
+    // A write touched table: cached data built from it is dropped
+    void invalidate(Table table);
+
+    // Drop everything (e.g. after a bulk import)
+    void invalidateAll();
+
+    uint64_t version(Table table) const { return versions[table].load(); }
+};
+
+#endif // REFERENCE_CACHE_H
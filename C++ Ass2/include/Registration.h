@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include "Database.h"
+#include "EntityFields.h"
 
 class Registration {
 private:
@@ -59,9 +60,26 @@ public:
     bool drop(Database& db);
     bool complete(Database& db);
 
+    // Field table: column, JSON key and member of every registration field
+    // (SELECT list, row decoder and toJson are generated from it)
+    static const auto& fields();
+
     // Utility
     std::string toJson() const;
     bool isEmpty() const;
 };
 
+inline const auto& Registration::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &Registration::id),
+        member("student_id", "studentId", &Registration::studentId),
+        member("course_id", "courseId", &Registration::courseId),
+        member("semester_id", "semesterId", &Registration::semesterId),
+        member("status", "status", &Registration::status),
+        member("created_at", "createdAt", &Registration::createdAt)
+    );
+    return table;
+}
+
 #endif // REGISTRATION_H
@@ -13,6 +13,8 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <memory>
+#include <mutex>
 #include "Database.h"
 
 // User session data
@@ -126,9 +128,19 @@ namespace ExclusivePermissions {
     }
 }
 
+/*
+ * SessionManager - The signed-in user, shared by every binding
+ *
+ * Bindings run on worker threads, so the session is published as an
+ * immutable snapshot: login/logout swap it under a mutex, and readers
+ * keep the snapshot they took for as long as they hold the pointer.
+ */
 class SessionManager {
 private:
-    static UserSession currentSession;
+    static std::shared_ptr<const UserSession> currentSession;
+    static std::mutex sessionMutex;
+
+    static void publish(std::shared_ptr<const UserSession> session);
     
 public:
     // Login and create session
@@ -137,8 +149,8 @@ public:
     // Logout and clear session
     static void logout();
     
-    // Get current session
-    static const UserSession& getSession();
+    // Snapshot of the current session (never null; inactive when logged out)
+    static std::shared_ptr<const UserSession> getSession();
     
     // Check if user is logged in
     static bool isLoggedIn();
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 #include "Database.h"
+#include "EntityFields.h"
 
 /*
  * Student class - Represents a student entity
@@ -159,6 +160,14 @@ public:
      */
     static std::string generateNextId(Database& db);
 
+    // ========================================
+    // FIELD TABLE
+    // ========================================
+    // Column, JSON key and member of every student field; the
+    // SELECT list, row decoder and toJson are generated from it.
+
+    static const auto& fields();    // Defined below the class
+
     // ========================================
     // INSTANCE DATABASE OPERATIONS
     // ========================================
@@ -205,4 +214,27 @@ public:
     bool isEmpty() const;
 };
 
+// ========================================
+// FIELD TABLE
+// ========================================
+
+inline const auto& Student::fields() {
+    using namespace EntityFields;
+    static constexpr auto table = EntityFields::table(
+        member("id", "id", &Student::id),
+        member("user_id", "", &Student::userId),
+        member("first_name", "firstName", &Student::firstName),
+        member("last_name", "lastName", &Student::lastName),
+        computed("fullName", &Student::getFullName),
+        member("date_of_birth", "dateOfBirth", &Student::dateOfBirth),
+        member("gender", "gender", &Student::gender),
+        member("email", "email", &Student::email, "u.email"),
+        member("phone", "phone", &Student::phone, "u.phone"),
+        member("enrollment_date", "registrationDate", &Student::registrationDate),
+        member("academic_level_id", "academicLevelId", &Student::academicLevelId),
+        member("department_id", "departmentId", &Student::departmentId)
+    );
+    return table;
+}
+
 #endif // STUDENT_H
@@ -6,11 +6,25 @@
  */
 
 #include "include/Database.h"
+#include "include/ConnectionPool.h"
+#include "include/BindingExecutor.h"
+#include "include/QueryStats.h"
 #include "include/Student.h"
 #include "include/Professor.h"
 #include "include/Course.h"
 #include "include/Grade.h"
+#include "include/GradeKernel.h"
+#include "include/EntityFields.h"
 #include "include/JsonHelper.h"
+#include "include/JsonWriter.h"
+#include "include/GridWriter.h"
+#include "include/JsonRequest.h"
+#include "include/ListingQuery.h"
+#include "include/ReferenceCache.h"
+#include "include/ChangeFeed.h"
+#include "include/GradeRecalculator.h"
+#include "include/QueryEventLoop.h"
+#include "include/GradeDistributionCache.h"
 #include "include/SessionManager.h"
 #include "lib/webview.h"
 
@@ -20,10 +34,19 @@
 #include <algorithm>
 #include <cctype>
 #include <filesystem>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include <set>
+#include <array>
+#include <memory>
+#include <mutex>
 
 using namespace std;
 
-Database db;
+ConnectionPool pool;
+BindingExecutor bindingExecutor;
 
 static string urlEncodePath(const string& path) {
     string out;
@@ -53,12 +76,10 @@ static string toFileUrl(std::filesystem::path path) {
 
 static bool getCurrentSemester(Database& db, string& semesterId, int& semesterNumber) {
     try {
-        auto result = db.executeQuery(
-            "SELECT id, semester_number FROM semesters WHERE is_current = TRUE LIMIT 1"
-        );
-        if (result->next()) {
-            semesterId = result->getString("id");
-            semesterNumber = result->getInt("semester_number");
+        ReferenceCache::CurrentSemester current = ReferenceCache::instance().currentSemester(db);
+        if (current.found) {
+            semesterId = current.id;
+            semesterNumber = current.semesterNumber;
             return true;
         }
     } catch (const exception& e) {
@@ -67,6 +88,271 @@ static bool getCurrentSemester(Database& db, string& semesterId, int& semesterNu
     return false;
 }
 
+// ========================================
+// CHANGE NOTIFICATIONS
+// ========================================
+// Publishes a registration as cpp_getAllRegistrations lists it
+static void publishRegistration(Database& db, const string& op, const string& registrationId) {
+    try {
+        auto stmt = db.prepareStatement(
+            "SELECT r.id, r.student_id, CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
+            "r.course_id, c.code AS course_code, c.name_en AS course_name, "
+            "r.semester_id, sem.name_en AS semester_name, r.status, r.created_at "
+            "FROM registrations r "
+            "JOIN students s ON r.student_id = s.id "
+            "JOIN courses c ON r.course_id = c.id "
+            "JOIN semesters sem ON r.semester_id = sem.id "
+            "WHERE r.id = ?"
+        );
+        stmt->setString(1, registrationId);
+        auto result = stmt->executeQuery();
+        if (!result->next()) {
+            return;
+        }
+        JsonWriter row(512);
+        row.beginObject()
+            .field("id", result->getStringView("id"))
+            .field("studentId", result->getStringView("student_id"))
+            .field("studentName", result->getStringView("student_name"))
+            .field("courseId", result->getStringView("course_id"))
+            .field("courseCode", result->getStringView("course_code"))
+            .field("courseName", result->getStringView("course_name"))
+            .field("semesterId", result->getStringView("semester_id"))
+            .field("semesterName", result->getStringView("semester_name"))
+            .field("status", result->getStringView("status"))
+            .field("registrationDate", result->getStringView("created_at"))
+            .endObject();
+        ChangeFeed::instance().publish("registrations", op, registrationId, row.str());
+    } catch (const exception& e) {
+        // The change is saved; the page just misses the delta
+        cerr << "[ChangeFeed] " << e.what() << endl;
+    }
+}
+
+// Stored grading columns of a grade listing, read for rows that are not dirty
+enum StoredGradeColumn { STORED_TOTAL, STORED_PERCENTAGE, STORED_GPA, STORED_EVALUATION, STORED_LETTER };
+static const string_view storedGradeColumns[] = {
+    "total_marks", "percentage", "gpa", "evaluation", "letter_grade"
+};
+
+struct ListedGrade {
+    double total;
+    double percentage;
+    double gpa;
+    string_view evaluation;
+    string_view letterGrade;
+};
+
+// Grading of listing row i (the current row of result): from the
+// kernel pass when the row is dirty, its stored columns otherwise
+static ListedGrade listedGrade(const Grade::GradedRows& graded, size_t i, const ResultSet& result,
+                               const ColumnIndex<5>& stored) {
+    if (graded.dirty[i]) {
+        uint8_t band = graded.band[i];
+        return {graded.total[i], graded.percentage[i], graded.gpa[i],
+                GradeKernel::EVALUATION[band], GradeKernel::LETTER[band]};
+    }
+    return {result.getDouble(stored[STORED_TOTAL]), result.getDouble(stored[STORED_PERCENTAGE]),
+            result.getDouble(stored[STORED_GPA]), result.getStringView(stored[STORED_EVALUATION]),
+            result.getStringView(stored[STORED_LETTER])};
+}
+
+// Publishes grades as cpp_getStudentsByCourse lists them, with the
+// course and semester so pages can tell whether they show them.
+// Rows still dirty are graded from their components.
+static void publishGrades(Database& db, const vector<string>& registrationIds) {
+    if (registrationIds.empty()) {
+        return;
+    }
+    try {
+        string query =
+            "SELECT r.id AS registration_id, r.student_id, r.course_id, r.semester_id, "
+            "CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
+            "COALESCE(g.assignment1, 0) AS assignment1, "
+            "COALESCE(g.assignment2, 0) AS assignment2, "
+            "COALESCE(g.year_work, 0) AS year_work, "
+            "COALESCE(g.final_exam, 0) AS final_exam, "
+            "COALESCE(g.total_marks, 0) AS total_marks, "
+            "COALESCE(g.percentage, 0) AS percentage, "
+            "COALESCE(g.gpa, 0) AS gpa, "
+            "COALESCE(g.evaluation, 'Fail') AS evaluation, "
+            "COALESCE(g.letter_grade, 'F') AS letter_grade, "
+            "COALESCE(g.is_dirty, FALSE) AS is_dirty, c.max_marks "
+            "FROM registrations r "
+            "JOIN students s ON r.student_id = s.id "
+            "JOIN courses c ON r.course_id = c.id "
+            "LEFT JOIN grades g ON r.id = g.registration_id "
+            "WHERE r.id IN (";
+        for (size_t i = 0; i < registrationIds.size(); i++) {
+            query += i == 0 ? "?" : ", ?";
+        }
+        query += ")";
+        auto stmt = db.prepareStatement(query);
+        for (size_t i = 0; i < registrationIds.size(); i++) {
+            stmt->setString((int)i + 1, registrationIds[i]);
+        }
+        auto result = stmt->executeQuery();
+        Grade::GradedRows graded = Grade::gradeRows(*result);
+        auto stored = result->resolveColumns(storedGradeColumns);
+        for (size_t i = 0; result->next(); i++) {
+            ListedGrade grade = listedGrade(graded, i, *result, stored);
+            JsonWriter row(512);
+            row.beginObject()
+                .field("registrationId", result->getStringView("registration_id"))
+                .field("studentId", result->getStringView("student_id"))
+                .field("studentName", result->getStringView("student_name"))
+                .field("courseId", result->getStringView("course_id"))
+                .field("semesterId", result->getStringView("semester_id"))
+                .field("assignment1", graded.assignment1[i], 2)
+                .field("assignment2", graded.assignment2[i], 2)
+                .field("yearWork", graded.yearWork[i], 2)
+                .field("finalExam", graded.finalExam[i], 2)
+                .field("total", grade.total, 2)
+                .field("percentage", grade.percentage, 2)
+                .field("gpa", grade.gpa, 2)
+                .field("evaluation", grade.evaluation)
+                .field("letterGrade", grade.letterGrade)
+                .endObject();
+            ChangeFeed::instance().publish("grades", "update", result->getString("registration_id"), row.str());
+        }
+    } catch (const exception& e) {
+        // The change is saved; the page just misses the delta
+        cerr << "[ChangeFeed] " << e.what() << endl;
+    }
+}
+
+static void publishGrade(Database& db, const string& registrationId) {
+    publishGrades(db, {registrationId});
+}
+
+// Handler of a pooled binding: (connection, request JSON) -> response JSON
+using PooledHandler = function<string(Database&, const string&)>;
+
+// Every pooled binding by name, for cpp_batch. Filled before the
+// window runs and only read afterwards.
+static unordered_map<string, PooledHandler> pooledHandlers;
+
+/*
+ * callPooled - Runs handler with a connection checked out of the pool
+ * and attributes its queries to name. The connection is back in the
+ * pool when this returns.
+ */
+static string callPooled(const char* name, const PooledHandler& handler, const string& request) {
+    QueryStats::BindingScope binding(name);
+    PooledConnection conn;
+    try {
+        conn = pool.acquire();
+        return handler(*conn, request);
+    } catch (const exception& e) {
+        cerr << "[Main] " << name << " failed: " << e.what() << endl;
+        return JsonHelper::errorResponse(e.what());
+    }
+}
+
+/*
+ * bindPooled - Binds a handler that runs on a worker thread with its
+ * own checked-out connection. The page gets its reply through
+ * resolve() when the handler finishes; at most maxConcurrent calls of
+ * the same binding run at once. Queries it runs are attributed to the
+ * binding in the query stats.
+ */
+static void bindPooled(webview::webview& w, const char* name, PooledHandler handler,
+                       size_t maxConcurrent = 2) {
+    bindingExecutor.setLimit(name, maxConcurrent);
+    const PooledHandler* bound = &(pooledHandlers[name] = std::move(handler));
+    w.bind(name, [&w, name, bound](const string& id, const string& request, void*) {
+        bindingExecutor.submit(name, [&w, name, bound, id, request]() {
+            string response = callPooled(name, *bound, request);
+            w.resolve(id, 0, response);
+        });
+    }, nullptr);
+}
+
+/*
+ * bindBatch - Binds cpp_batch, which takes [{method, args}, ...] and
+ * answers with the array of the calls' results, in order.
+ *
+ * Each call goes through the pooled binding of that name, on its own
+ * worker and connection and under that binding's concurrency limit,
+ * so independent calls run in parallel. The page gets one resolve when
+ * the last call finishes instead of one round trip per call. A call
+ * to an unknown method gets an error response in its slot.
+ */
+static void bindBatch(webview::webview& w) {
+    struct Batch {
+        string id;
+        vector<string> results;
+        size_t remaining;
+        mutex mtx;
+    };
+
+    w.bind("cpp_batch", [&w](const string& id, const string& request, void*) {
+        // cpp_batch([...]) arrives as [[...]]; cpp_batch(a, b) as [a, b]
+        vector<string_view> calls = JsonRequest::elements(request);
+        if (calls.size() == 1 && calls[0].front() == '[') {
+            calls = JsonRequest::elements(calls[0]);
+        }
+        if (calls.empty()) {
+            w.resolve(id, 0, "[]");
+            return;
+        }
+
+        auto batch = make_shared<Batch>();
+        batch->id = id;
+        batch->results.resize(calls.size());
+        batch->remaining = calls.size();
+
+        auto finish = [&w, batch](size_t index, string response) {
+            {
+                lock_guard<mutex> lock(batch->mtx);
+                batch->results[index] = std::move(response);
+                if (--batch->remaining > 0) {
+                    return;
+                }
+            }
+            size_t bytes = 2;
+            for (const string& result : batch->results) {
+                bytes += result.size() + 1;
+            }
+            JsonWriter json(bytes);
+            json.beginArray();
+            for (const string& result : batch->results) {
+                json.raw(result.empty() ? string_view("null") : string_view(result));
+            }
+            json.endArray();
+            w.resolve(batch->id, 0, json.str());
+        };
+
+        for (size_t i = 0; i < calls.size(); i++) {
+            JsonRequest call(calls[i]);
+            auto found = pooledHandlers.find(call.getString("method"));
+            if (found == pooledHandlers.end()) {
+                finish(i, JsonHelper::errorResponse("Unknown method: " + call.getString("method")));
+                continue;
+            }
+
+            // The handler sees the same argument array a direct call would
+            string args = "[]";
+            if (!call.isNull("args")) {
+                string_view value = call.get("args");
+                if (!value.empty() && (value.front() == '{' || value.front() == '[')) {
+                    args = "[" + string(value) + "]";
+                } else {
+                    JsonWriter quoted;
+                    quoted.beginArray().value(value).endArray();
+                    args = quoted.release();
+                }
+            }
+
+            const char* name = found->first.c_str();
+            const PooledHandler* handler = &found->second;
+            bindingExecutor.submit(name, [finish, i, name, handler, args]() {
+                finish(i, callPooled(name, *handler, args));
+            });
+        }
+    }, nullptr);
+}
+
 int main() {
     cout << "========================================" << endl;
     cout << "   Student Information System v2.0     " << endl;
@@ -74,7 +360,7 @@ int main() {
     cout << "========================================" << endl;
     cout << endl;
 
-    if (!db.testConnection()) {
+    if (!pool.initialize()) {
         cerr << "ERROR: Cannot connect to database!" << endl;
         cerr << "Check your MySQL password in Database.h" << endl;
         cerr << "Press Enter to exit..." << endl;
@@ -82,36 +368,56 @@ int main() {
         return 1;
     }
 
+    // Log statements slower than SIS_SLOW_QUERY_MS (default 100 ms)
+    if (const char* slowMs = getenv("SIS_SLOW_QUERY_MS")) {
+        QueryStats::instance().setSlowQueryThreshold(chrono::milliseconds(atoi(slowMs)));
+    }
+
+    // One worker per pooled connection but one, which is left for the
+    // grade recalculator: a drain never waits out the pool timeout
+    // behind busy workers, and no binding waits behind a drain
+    bindingExecutor.start(max<size_t>(1, pool.maxConnections() - 1));
+
+    // Recomputes grades whose components or distribution changed
+    GradeRecalculator::instance().start(pool);
+
     webview::webview w(true, nullptr);
     w.set_title("NCTU - Student Information System");
     w.set_size(1280, 800, WEBVIEW_HINT_NONE);
 
     cout << "[Main] WebView window created" << endl;
 
+    // Deltas from worker threads are evaluated on the UI thread
+    ChangeFeed::instance().setSink([&w](const string& script) {
+        w.dispatch([&w, script]() { w.eval(script); });
+    });
+
     // ========================================
     // AUTHENTICATION
     // ========================================
-    w.bind("cpp_login", [](const string& request) -> string {
+    // One login at a time
+    bindPooled(w, "cpp_login", [](Database& db, const string& request) -> string {
         try {
-            string username = JsonHelper::parseSimpleValue(request, "username");
-            string password = JsonHelper::parseSimpleValue(request, "password");
+            JsonRequest args(request);
+            string username = args.getString("username");
+            string password = args.getString("password");
 
             cout << "[Login] Attempting login: " << username << endl;
 
             if (SessionManager::login(db, username, password)) {
-                const UserSession& session = SessionManager::getSession();
+                auto session = SessionManager::getSession();
                 
                 vector<pair<string, string>> response;
                 response.push_back({"success", JsonHelper::makeBool(true)});
-                response.push_back({"role", JsonHelper::makeString(session.roleId)});
-                response.push_back({"roleName", JsonHelper::makeString(session.roleName)});
-                response.push_back({"id", JsonHelper::makeString(session.userId)});
-                response.push_back({"linkedId", JsonHelper::makeString(session.linkedId)});
-                response.push_back({"name", JsonHelper::makeString(session.fullName)});
+                response.push_back({"role", JsonHelper::makeString(session->roleId)});
+                response.push_back({"roleName", JsonHelper::makeString(session->roleName)});
+                response.push_back({"id", JsonHelper::makeString(session->userId)});
+                response.push_back({"linkedId", JsonHelper::makeString(session->linkedId)});
+                response.push_back({"name", JsonHelper::makeString(session->fullName)});
                 
                 string permsJson = "[";
                 bool first = true;
-                for (const auto& perm : session.permissions) {
+                for (const auto& perm : session->permissions) {
                     if (!first) permsJson += ",";
                     permsJson += "\"" + perm + "\"";
                     first = false;
@@ -119,7 +425,7 @@ int main() {
                 permsJson += "]";
                 response.push_back({"permissions", permsJson});
                 
-                SessionManager::logAction(db, "LOGIN", "users", session.userId, "Successful login");
+                SessionManager::logAction(db, "LOGIN", "users", session->userId, "Successful login");
                 return JsonHelper::makeObject(response);
             } else {
                 vector<pair<string, string>> response;
@@ -131,7 +437,7 @@ int main() {
             cerr << "[Login] Error: " << e.what() << endl;
             return JsonHelper::errorResponse(e.what());
         }
-    });
+    }, 1);
 
     w.bind("cpp_logout", [](const string& request) -> string {
         SessionManager::logout();
@@ -142,19 +448,19 @@ int main() {
         if (!SessionManager::isLoggedIn()) {
             return JsonHelper::errorResponse("Not logged in");
         }
-        const UserSession& session = SessionManager::getSession();
+        auto session = SessionManager::getSession();
         vector<pair<string, string>> response;
-        response.push_back({"userId", JsonHelper::makeString(session.userId)});
-        response.push_back({"username", JsonHelper::makeString(session.username)});
-        response.push_back({"fullName", JsonHelper::makeString(session.fullName)});
-        response.push_back({"roleId", JsonHelper::makeString(session.roleId)});
-        response.push_back({"roleName", JsonHelper::makeString(session.roleName)});
-        response.push_back({"linkedId", JsonHelper::makeString(session.linkedId)});
+        response.push_back({"userId", JsonHelper::makeString(session->userId)});
+        response.push_back({"username", JsonHelper::makeString(session->username)});
+        response.push_back({"fullName", JsonHelper::makeString(session->fullName)});
+        response.push_back({"roleId", JsonHelper::makeString(session->roleId)});
+        response.push_back({"roleName", JsonHelper::makeString(session->roleName)});
+        response.push_back({"linkedId", JsonHelper::makeString(session->linkedId)});
         
         // Add permissions array
         string permsJson = "[";
         bool first = true;
-        for (const auto& perm : session.permissions) {
+        for (const auto& perm : session->permissions) {
             if (!first) permsJson += ",";
             permsJson += "\"" + perm + "\"";
             first = false;
@@ -168,23 +474,22 @@ int main() {
     // ========================================
     // DASHBOARD
     // ========================================
-    w.bind("cpp_getDashboardStats", [](const string& request) -> string {
+    bindPooled(w, "cpp_getDashboardStats", [](Database& db, const string& request) -> string {
         try {
             vector<pair<string, string>> stats;
             
             if (SessionManager::canViewAllStudents()) {
-                auto result = db.executeQuery("SELECT COUNT(*) as count FROM students");
-                if (result->next()) stats.push_back({"students", JsonHelper::makeNumber(result->getInt("count"))});
-                
-                result = db.executeQuery("SELECT COUNT(*) as count FROM professors");
-                if (result->next()) stats.push_back({"professors", JsonHelper::makeNumber(result->getInt("count"))});
-                
-                result = db.executeQuery("SELECT COUNT(*) as count FROM courses");
-                if (result->next()) stats.push_back({"courses", JsonHelper::makeNumber(result->getInt("count"))});
-                
-                result = db.executeQuery("SELECT COUNT(*) as count FROM departments");
-                if (result->next()) stats.push_back({"departments", JsonHelper::makeNumber(result->getInt("count"))});
-            } else if (SessionManager::getSession().isProfessor()) {
+                // The four counts go to the server in a single round trip
+                static const char* tables[] = {"students", "professors", "courses", "departments"};
+                QueryPipeline pipeline(db);
+                for (const char* table : tables) {
+                    pipeline.add(string("SELECT COUNT(*) as count FROM ") + table);
+                }
+                auto results = pipeline.execute();
+                for (size_t i = 0; i < results.size(); i++) {
+                    if (results[i]->next()) stats.push_back({tables[i], JsonHelper::makeNumber(results[i]->getInt(0))});
+                }
+            } else if (SessionManager::getSession()->isProfessor()) {
                 string semesterId;
                 int semesterNumber = 0;
                 getCurrentSemester(db, semesterId, semesterNumber);
@@ -193,15 +498,16 @@ int main() {
                 stats.push_back({"assignedCourses", JsonHelper::makeNumber((int)courseIds.size())});
 
                 int totalStudents = 0;
+                QueryPipeline pipeline(db);
                 for (const auto& cid : courseIds) {
-                    auto stmt = db.prepareStatement(
+                    pipeline.add(
                         "SELECT COUNT(*) as cnt FROM registrations "
-                        "WHERE course_id = ? AND semester_id = ? AND status = 'registered'"
+                        "WHERE course_id = ? AND semester_id = ? AND status = 'registered'",
+                        {cid, semesterId}
                     );
-                    stmt->setString(1, cid);
-                    stmt->setString(2, semesterId);
-                    auto r = stmt->executeQuery();
-                    if (r->next()) totalStudents += r->getInt("cnt");
+                }
+                for (auto& r : pipeline.execute()) {
+                    if (r->next()) totalStudents += r->getInt(0);
                 }
                 stats.push_back({"totalStudents", JsonHelper::makeNumber(totalStudents)});
             }
@@ -214,8 +520,9 @@ int main() {
     // ========================================
     // STUDENTS
     // ========================================
-    w.bind("cpp_getAllStudents", [](const string& request) -> string {
+    bindPooled(w, "cpp_getAllStudents", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::canViewAllStudents()) {
                 return "[]";
             }
@@ -225,59 +532,72 @@ int main() {
                                    SessionManager::hasPermission(Permissions::PWD_VIEW_STU);
             
             // Query students with password if permitted
-            string query = 
-                "SELECT s.id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
+            string columns =
+                "s.id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
                 "u.email, u.phone, s.enrollment_date, s.academic_level_id, s.department_id";
             if (canViewPasswords) {
-                query += ", u.password_hash";
-            }
-            query += " FROM students s LEFT JOIN users u ON s.user_id = u.id ORDER BY s.id";
-            
-            auto result = db.executeQuery(query);
-            vector<string> jsonStudents;
-            
-            while (result->next()) {
-                stringstream ss;
-                ss << "{";
-                ss << "\"id\":\"" << result->getString("id") << "\",";
-                ss << "\"firstName\":\"" << result->getString("first_name") << "\",";
-                ss << "\"lastName\":\"" << result->getString("last_name") << "\",";
-                ss << "\"fullName\":\"" << result->getString("first_name") << " " << result->getString("last_name") << "\",";
-                ss << "\"dateOfBirth\":\"" << result->getString("date_of_birth") << "\",";
-                ss << "\"gender\":\"" << result->getString("gender") << "\",";
-                ss << "\"email\":\"" << result->getString("email") << "\",";
-                ss << "\"phone\":\"" << result->getString("phone") << "\",";
-                ss << "\"registrationDate\":\"" << result->getString("enrollment_date") << "\",";
-                ss << "\"academicLevelId\":\"" << result->getString("academic_level_id") << "\",";
-                ss << "\"departmentId\":\"" << result->getString("department_id") << "\"";
+                columns += ", u.password_hash";
+            }
+            ListingQuery listing(columns, "students s LEFT JOIN users u ON s.user_id = u.id",
+                                 "students", {{"s.id", "id"}});
+            listing.whereEquals("s.department_id", args.get("departmentId"));
+            listing.whereEquals("s.academic_level_id", args.get("levelId"));
+            listing.wherePrefix({"s.id", "s.first_name", "s.last_name", "u.email"}, args.get("search"));
+            listing.page(args);
+
+            auto result = listing.execute(db);
+            enum { ID, FIRST_NAME, LAST_NAME, DATE_OF_BIRTH, GENDER, EMAIL, PHONE,
+                   ENROLLMENT_DATE, LEVEL_ID, DEPARTMENT_ID, PASSWORD_HASH };
+            static const string_view studentColumns[] = {
+                "id", "first_name", "last_name", "date_of_birth", "gender", "email", "phone",
+                "enrollment_date", "academic_level_id", "department_id", "password_hash"
+            };
+            auto col = result->resolveColumns(studentColumns);
+
+            string fullName;
+            return listing.respond(db, *result, [&](JsonWriter& json) {
+                string_view firstName = result->getStringView(col[FIRST_NAME]);
+                string_view lastName = result->getStringView(col[LAST_NAME]);
+                fullName.assign(firstName).append(" ").append(lastName);
+                json.beginObject()
+                    .field("id", result->getStringView(col[ID]))
+                    .field("firstName", firstName)
+                    .field("lastName", lastName)
+                    .field("fullName", fullName)
+                    .field("dateOfBirth", result->getStringView(col[DATE_OF_BIRTH]))
+                    .field("gender", result->getStringView(col[GENDER]))
+                    .field("email", result->getStringView(col[EMAIL]))
+                    .field("phone", result->getStringView(col[PHONE]))
+                    .field("registrationDate", result->getStringView(col[ENROLLMENT_DATE]))
+                    .field("academicLevelId", result->getStringView(col[LEVEL_ID]))
+                    .field("departmentId", result->getStringView(col[DEPARTMENT_ID]));
                 if (canViewPasswords) {
-                    ss << ",\"password\":\"" << result->getString("password_hash") << "\"";
+                    json.field("password", result->getStringView(col[PASSWORD_HASH]));
                 }
-                ss << "}";
-                jsonStudents.push_back(ss.str());
-            }
-            return JsonHelper::makeArray(jsonStudents);
+                json.endObject();
+            }, 256 + (size_t)result->getRowCount() * 320);
         } catch (const exception& e) {
             cerr << "[Students] Error: " << e.what() << endl;
             return "[]";
         }
     });
 
-    w.bind("cpp_addStudent", [](const string& request) -> string {
+    bindPooled(w, "cpp_addStudent", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::STU_CREATE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
             
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string firstName = JsonHelper::parseSimpleValue(request, "firstName");
-            string lastName = JsonHelper::parseSimpleValue(request, "lastName");
-            string dateOfBirth = JsonHelper::parseSimpleValue(request, "dateOfBirth");
-            string gender = JsonHelper::parseSimpleValue(request, "gender");
-            string email = JsonHelper::parseSimpleValue(request, "email");
-            string phone = JsonHelper::parseSimpleValue(request, "phone");
-            string academicLevelId = JsonHelper::parseSimpleValue(request, "academicLevelId");
-            string departmentId = JsonHelper::parseSimpleValue(request, "departmentId");
+            string id = args.getString("id");
+            string firstName = args.getString("firstName");
+            string lastName = args.getString("lastName");
+            string dateOfBirth = args.getString("dateOfBirth");
+            string gender = args.getString("gender");
+            string email = args.getString("email");
+            string phone = args.getString("phone");
+            string academicLevelId = args.getString("academicLevelId");
+            string departmentId = args.getString("departmentId");
 
             if (Student::exists(db, id)) {
                 return JsonHelper::errorResponse("Student ID already exists!");
@@ -306,27 +626,23 @@ int main() {
                         coursesStmt->setInt(3, semesterNumber);
                         auto coursesRes = coursesStmt->executeQuery();
 
+                        // One multi-row INSERT for the registrations, then one for
+                        // their grade rows using the generated registration IDs
+                        BatchInserter registrations(db, "registrations",
+                            {"student_id", "course_id", "semester_id", "status", "registered_by"});
                         while (coursesRes->next()) {
-                            string courseId = coursesRes->getString("id");
-                            auto regStmt = db.prepareStatement(
-                                "INSERT INTO registrations (student_id, course_id, semester_id, status, registered_by) "
-                                "VALUES (?, ?, ?, 'registered', ?)"
-                            );
-                            regStmt->setString(1, id);
-                            regStmt->setString(2, courseId);
-                            regStmt->setString(3, semesterId);
-                            regStmt->setString(4, SessionManager::getSession().userId);
-                            regStmt->executeUpdate();
-
-                            string regId = to_string(db.getLastInsertId());
-                            auto gradeStmt = db.prepareStatement(
-                                "INSERT INTO grades (registration_id) VALUES (?)"
-                            );
-                            gradeStmt->setString(1, regId);
-                            gradeStmt->executeUpdate();
+                            registrations.addRow({id, coursesRes->getStringView(0), semesterId, "registered",
+                                                  SessionManager::getSession()->userId});
+                        }
+                        const BatchResult& regs = registrations.finish();
 
-                            registeredCount++;
+                        BatchInserter grades(db, "grades", {"registration_id"});
+                        for (size_t i = 0; i < regs.rows; i++) {
+                            grades.addRow({regs.idAt(i)});
                         }
+                        grades.finish();
+
+                        registeredCount = (int)regs.rows;
                         db.executeUpdate("COMMIT");
                     } catch (const exception& e) {
                         try { db.executeUpdate("ROLLBACK"); } catch (...) {}
@@ -344,21 +660,22 @@ int main() {
         }
     });
 
-    w.bind("cpp_updateStudent", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateStudent", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::STU_EDIT)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
             
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string firstName = JsonHelper::parseSimpleValue(request, "firstName");
-            string lastName = JsonHelper::parseSimpleValue(request, "lastName");
-            string dateOfBirth = JsonHelper::parseSimpleValue(request, "dateOfBirth");
-            string gender = JsonHelper::parseSimpleValue(request, "gender");
-            string email = JsonHelper::parseSimpleValue(request, "email");
-            string phone = JsonHelper::parseSimpleValue(request, "phone");
-            string academicLevelId = JsonHelper::parseSimpleValue(request, "academicLevelId");
-            string departmentId = JsonHelper::parseSimpleValue(request, "departmentId");
+            string id = args.getString("id");
+            string firstName = args.getString("firstName");
+            string lastName = args.getString("lastName");
+            string dateOfBirth = args.getString("dateOfBirth");
+            string gender = args.getString("gender");
+            string email = args.getString("email");
+            string phone = args.getString("phone");
+            string academicLevelId = args.getString("academicLevelId");
+            string departmentId = args.getString("departmentId");
 
             transform(gender.begin(), gender.end(), gender.begin(),
                       [](unsigned char c) { return static_cast<char>(tolower(c)); });
@@ -376,7 +693,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_deleteStudent", [](const string& request) -> string {
+    bindPooled(w, "cpp_deleteStudent", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::hasPermission(Permissions::STU_DELETE)) {
                 return JsonHelper::errorResponse("Permission denied");
@@ -398,7 +715,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_generateStudentId", [](const string& request) -> string {
+    bindPooled(w, "cpp_generateStudentId", [](Database& db, const string& request) -> string {
         try {
             string newId = Student::generateNextId(db);
             vector<pair<string, string>> result;
@@ -412,7 +729,7 @@ int main() {
     // ========================================
     // PROFESSORS
     // ========================================
-    w.bind("cpp_getAllProfessors", [](const string& request) -> string {
+    bindPooled(w, "cpp_getAllProfessors", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::PROF_VIEW)) {
                 return "[]";
@@ -430,45 +747,57 @@ int main() {
             query += " FROM professors p LEFT JOIN users u ON p.user_id = u.id ORDER BY p.id";
             
             auto result = db.executeQuery(query);
-            vector<string> jsonProfs;
-            
+            enum { ID, FIRST_NAME, LAST_NAME, EMAIL, PHONE, DEPARTMENT_ID, HIRE_DATE,
+                   SPECIALIZATION, PASSWORD_HASH };
+            static const string_view professorColumns[] = {
+                "id", "first_name", "last_name", "email", "phone", "department_id", "hire_date",
+                "specialization", "password_hash"
+            };
+            auto col = result->resolveColumns(professorColumns);
+
+            JsonWriter json(256 + (size_t)result->getRowCount() * 288);
+            json.beginArray();
+            string fullName;
             while (result->next()) {
-                stringstream ss;
-                ss << "{";
-                ss << "\"id\":\"" << result->getString("id") << "\",";
-                ss << "\"firstName\":\"" << result->getString("first_name") << "\",";
-                ss << "\"lastName\":\"" << result->getString("last_name") << "\",";
-                ss << "\"fullName\":\"" << result->getString("first_name") << " " << result->getString("last_name") << "\",";
-                ss << "\"email\":\"" << result->getString("email") << "\",";
-                ss << "\"phone\":\"" << result->getString("phone") << "\",";
-                ss << "\"departmentId\":\"" << result->getString("department_id") << "\",";
-                ss << "\"hireDate\":\"" << result->getString("hire_date") << "\",";
-                ss << "\"specialization\":\"" << result->getString("specialization") << "\"";
+                string_view firstName = result->getStringView(col[FIRST_NAME]);
+                string_view lastName = result->getStringView(col[LAST_NAME]);
+                fullName.assign(firstName).append(" ").append(lastName);
+                json.beginObject()
+                    .field("id", result->getStringView(col[ID]))
+                    .field("firstName", firstName)
+                    .field("lastName", lastName)
+                    .field("fullName", fullName)
+                    .field("email", result->getStringView(col[EMAIL]))
+                    .field("phone", result->getStringView(col[PHONE]))
+                    .field("departmentId", result->getStringView(col[DEPARTMENT_ID]))
+                    .field("hireDate", result->getStringView(col[HIRE_DATE]))
+                    .field("specialization", result->getStringView(col[SPECIALIZATION]));
                 if (canViewPasswords) {
-                    ss << ",\"password\":\"" << result->getString("password_hash") << "\"";
+                    json.field("password", result->getStringView(col[PASSWORD_HASH]));
                 }
-                ss << "}";
-                jsonProfs.push_back(ss.str());
+                json.endObject();
             }
-            return JsonHelper::makeArray(jsonProfs);
+            json.endArray();
+            return json.release();
         } catch (const exception& e) {
             cerr << "[Professors] Error: " << e.what() << endl;
             return "[]";
         }
     });
 
-    w.bind("cpp_addProfessor", [](const string& request) -> string {
+    bindPooled(w, "cpp_addProfessor", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::PROF_CREATE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string firstName = JsonHelper::parseSimpleValue(request, "firstName");
-            string lastName = JsonHelper::parseSimpleValue(request, "lastName");
-            string email = JsonHelper::parseSimpleValue(request, "email");
-            string phone = JsonHelper::parseSimpleValue(request, "phone");
-            string departmentId = JsonHelper::parseSimpleValue(request, "departmentId");
-            string specialization = JsonHelper::parseSimpleValue(request, "specialization");
+            string id = args.getString("id");
+            string firstName = args.getString("firstName");
+            string lastName = args.getString("lastName");
+            string email = args.getString("email");
+            string phone = args.getString("phone");
+            string departmentId = args.getString("departmentId");
+            string specialization = args.getString("specialization");
 
             if (Professor::exists(db, id)) {
                 return JsonHelper::errorResponse("Professor ID already exists!");
@@ -485,18 +814,19 @@ int main() {
         }
     });
 
-    w.bind("cpp_updateProfessor", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateProfessor", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::PROF_EDIT)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string firstName = JsonHelper::parseSimpleValue(request, "firstName");
-            string lastName = JsonHelper::parseSimpleValue(request, "lastName");
-            string email = JsonHelper::parseSimpleValue(request, "email");
-            string phone = JsonHelper::parseSimpleValue(request, "phone");
-            string departmentId = JsonHelper::parseSimpleValue(request, "departmentId");
-            string specialization = JsonHelper::parseSimpleValue(request, "specialization");
+            string id = args.getString("id");
+            string firstName = args.getString("firstName");
+            string lastName = args.getString("lastName");
+            string email = args.getString("email");
+            string phone = args.getString("phone");
+            string departmentId = args.getString("departmentId");
+            string specialization = args.getString("specialization");
 
             if (!Professor::exists(db, id)) {
                 return JsonHelper::errorResponse("Professor not found");
@@ -513,7 +843,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_deleteProfessor", [](const string& request) -> string {
+    bindPooled(w, "cpp_deleteProfessor", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::PROF_DELETE)) {
                 return JsonHelper::errorResponse("Permission denied");
@@ -542,35 +872,68 @@ int main() {
     // ========================================
     // COURSES
     // ========================================
-    w.bind("cpp_getAllCourses", [](const string& request) -> string {
+    bindPooled(w, "cpp_getAllCourses", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_VIEW)) {
                 return "[]";
             }
-            const UserSession& session = SessionManager::getSession();
-            vector<string> jsonCourses;
+            auto session = SessionManager::getSession();
+            GridWriter json(GridWriter::isColumnar(args),
+                            {"departmentId", "departmentName", "academicLevelId", "academicLevelName",
+                             "courseTypeId", "courseTypeName"});
 
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
-            if (session.isProfessor() && !session.linkedId.empty()) {
+            string semesterId = args.getString("semesterId");
+            if (session->isProfessor() && !session->linkedId.empty()) {
                 if (semesterId.empty()) {
                     int semesterNumber = 0;
                     getCurrentSemester(db, semesterId, semesterNumber);
                 }
             }
 
+            // Course columns plus the joined department, level and type names
+            using namespace EntityFields;
+            static constexpr auto courseFields = EntityFields::table(
+                column<string>("id", "id"),
+                column<string>("code", "code"),
+                column<string>("name_en", "nameEn"),
+                column<string>("name_ar", "nameAr"),
+                column<string>("description", "description"),
+                column<string>("department_id", "departmentId"),
+                column<string>("department_name", "departmentName", "d.name_en"),
+                column<string>("academic_level_id", "academicLevelId"),
+                column<string>("level_name", "academicLevelName", "al.name_en"),
+                column<int>("semester_number", "semesterNumber"),
+                column<string>("course_type_id", "courseTypeId"),
+                column<string>("course_type_name", "courseTypeName", "ct.name"),
+                column<int>("credit_hours", "creditHours"),
+                column<int>("lecture_hours", "lectureHours"),
+                column<int>("tutorial_hours", "tutorialHours"),
+                column<int>("lab_hours", "labHours"),
+                column<int>("practical_hours", "practicalHours"),
+                column<int>("max_marks", "maxMarks"),
+                column<int>("year_work_marks", "yearWorkMarks"),
+                column<int>("assignment1_marks", "assignment1Marks"),
+                column<int>("assignment2_marks", "assignment2Marks"),
+                column<int>("final_exam_marks", "finalExamMarks")
+            );
+            static const string courseSelect = selectList(courseFields, "c.");
+
             string baseQuery =
-                "SELECT c.id, c.code, c.name_en, c.name_ar, c.description, "
-                "c.department_id, d.name_en AS department_name, "
-                "c.academic_level_id, al.name_en AS level_name, "
-                "c.semester_number, c.course_type_id, ct.name AS course_type_name, "
-                "c.credit_hours, c.lecture_hours, c.tutorial_hours, c.lab_hours, c.practical_hours, "
-                "c.max_marks, c.year_work_marks, c.assignment1_marks, c.assignment2_marks, c.final_exam_marks "
+                "SELECT " + courseSelect + " "
                 "FROM courses c "
                 "JOIN departments d ON c.department_id = d.id "
                 "JOIN academic_levels al ON c.academic_level_id = al.id "
                 "JOIN course_types ct ON c.course_type_id = ct.id ";
 
-            if (session.isProfessor() && !session.linkedId.empty()) {
+            auto appendCourses = [&json](ResultSet& result) {
+                auto columns = resolve(result, courseFields);
+                while (result.next()) {
+                    writeRow(json, result, columns, courseFields);
+                }
+            };
+
+            if (session->isProfessor() && !session->linkedId.empty()) {
                 baseQuery += "JOIN course_assignments ca ON c.id = ca.course_id "
                              "WHERE ca.professor_id = ? ";
                 if (!semesterId.empty()) {
@@ -579,84 +942,30 @@ int main() {
                 baseQuery += "ORDER BY c.code";
 
                 auto stmt = db.prepareStatement(baseQuery);
-                stmt->setString(1, session.linkedId);
+                stmt->setString(1, session->linkedId);
                 if (!semesterId.empty()) {
                     stmt->setString(2, semesterId);
                 }
                 auto result = stmt->executeQuery();
-
-                while (result->next()) {
-                    stringstream ss;
-                    ss << "{";
-                    ss << "\"id\":\"" << result->getString("id") << "\",";
-                    ss << "\"code\":\"" << result->getString("code") << "\",";
-                    ss << "\"nameEn\":\"" << result->getString("name_en") << "\",";
-                    ss << "\"nameAr\":\"" << result->getString("name_ar") << "\",";
-                    ss << "\"description\":\"" << result->getString("description") << "\",";
-                    ss << "\"departmentId\":\"" << result->getString("department_id") << "\",";
-                    ss << "\"departmentName\":\"" << result->getString("department_name") << "\",";
-                    ss << "\"academicLevelId\":\"" << result->getString("academic_level_id") << "\",";
-                    ss << "\"academicLevelName\":\"" << result->getString("level_name") << "\",";
-                    ss << "\"semesterNumber\":" << result->getInt("semester_number") << ",";
-                    ss << "\"courseTypeId\":\"" << result->getString("course_type_id") << "\",";
-                    ss << "\"courseTypeName\":\"" << result->getString("course_type_name") << "\",";
-                    ss << "\"creditHours\":" << result->getInt("credit_hours") << ",";
-                    ss << "\"lectureHours\":" << result->getInt("lecture_hours") << ",";
-                    ss << "\"tutorialHours\":" << result->getInt("tutorial_hours") << ",";
-                    ss << "\"labHours\":" << result->getInt("lab_hours") << ",";
-                    ss << "\"practicalHours\":" << result->getInt("practical_hours") << ",";
-                    ss << "\"maxMarks\":" << result->getInt("max_marks") << ",";
-                    ss << "\"yearWorkMarks\":" << result->getInt("year_work_marks") << ",";
-                    ss << "\"assignment1Marks\":" << result->getInt("assignment1_marks") << ",";
-                    ss << "\"assignment2Marks\":" << result->getInt("assignment2_marks") << ",";
-                    ss << "\"finalExamMarks\":" << result->getInt("final_exam_marks");
-                    ss << "}";
-                    jsonCourses.push_back(ss.str());
-                }
+                appendCourses(*result);
             } else {
                 baseQuery += "ORDER BY c.code";
                 auto result = db.executeQuery(baseQuery);
-                while (result->next()) {
-                    stringstream ss;
-                    ss << "{";
-                    ss << "\"id\":\"" << result->getString("id") << "\",";
-                    ss << "\"code\":\"" << result->getString("code") << "\",";
-                    ss << "\"nameEn\":\"" << result->getString("name_en") << "\",";
-                    ss << "\"nameAr\":\"" << result->getString("name_ar") << "\",";
-                    ss << "\"description\":\"" << result->getString("description") << "\",";
-                    ss << "\"departmentId\":\"" << result->getString("department_id") << "\",";
-                    ss << "\"departmentName\":\"" << result->getString("department_name") << "\",";
-                    ss << "\"academicLevelId\":\"" << result->getString("academic_level_id") << "\",";
-                    ss << "\"academicLevelName\":\"" << result->getString("level_name") << "\",";
-                    ss << "\"semesterNumber\":" << result->getInt("semester_number") << ",";
-                    ss << "\"courseTypeId\":\"" << result->getString("course_type_id") << "\",";
-                    ss << "\"courseTypeName\":\"" << result->getString("course_type_name") << "\",";
-                    ss << "\"creditHours\":" << result->getInt("credit_hours") << ",";
-                    ss << "\"lectureHours\":" << result->getInt("lecture_hours") << ",";
-                    ss << "\"tutorialHours\":" << result->getInt("tutorial_hours") << ",";
-                    ss << "\"labHours\":" << result->getInt("lab_hours") << ",";
-                    ss << "\"practicalHours\":" << result->getInt("practical_hours") << ",";
-                    ss << "\"maxMarks\":" << result->getInt("max_marks") << ",";
-                    ss << "\"yearWorkMarks\":" << result->getInt("year_work_marks") << ",";
-                    ss << "\"assignment1Marks\":" << result->getInt("assignment1_marks") << ",";
-                    ss << "\"assignment2Marks\":" << result->getInt("assignment2_marks") << ",";
-                    ss << "\"finalExamMarks\":" << result->getInt("final_exam_marks");
-                    ss << "}";
-                    jsonCourses.push_back(ss.str());
-                }
+                appendCourses(*result);
             }
-            return JsonHelper::makeArray(jsonCourses);
+            return json.release();
         } catch (...) {
             return "[]";
         }
     });
 
-    w.bind("cpp_getCourseAssignments", [](const string& request) -> string {
+    bindPooled(w, "cpp_getCourseAssignments", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_VIEW)) {
                 return "[]";
             }
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
+            string semesterId = args.getString("semesterId");
 
             string query =
                 "SELECT ca.id, ca.course_id, c.code AS course_code, c.name_en AS course_name, "
@@ -671,55 +980,55 @@ int main() {
             }
             query += "ORDER BY sem.academic_year DESC, c.code";
 
-            vector<string> assignments;
+            unique_ptr<ResultSet> result;
             if (!semesterId.empty()) {
                 auto stmt = db.prepareStatement(query);
                 stmt->setString(1, semesterId);
-                auto result = stmt->executeQuery();
-                while (result->next()) {
-                    vector<pair<string, string>> item;
-                    item.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                    item.push_back({"courseId", JsonHelper::makeString(result->getString("course_id"))});
-                    item.push_back({"courseCode", JsonHelper::makeString(result->getString("course_code"))});
-                    item.push_back({"courseName", JsonHelper::makeString(result->getString("course_name"))});
-                    item.push_back({"professorId", JsonHelper::makeString(result->getString("professor_id"))});
-                    item.push_back({"professorName", JsonHelper::makeString(result->getString("professor_name"))});
-                    item.push_back({"semesterId", JsonHelper::makeString(result->getString("semester_id"))});
-                    item.push_back({"semesterName", JsonHelper::makeString(result->getString("semester_name"))});
-                    item.push_back({"isPrimary", JsonHelper::makeBool(result->getBoolean("is_primary"))});
-                    assignments.push_back(JsonHelper::makeObject(item));
-                }
+                result = stmt->executeQuery();
             } else {
-                auto result = db.executeQuery(query);
-                while (result->next()) {
-                    vector<pair<string, string>> item;
-                    item.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                    item.push_back({"courseId", JsonHelper::makeString(result->getString("course_id"))});
-                    item.push_back({"courseCode", JsonHelper::makeString(result->getString("course_code"))});
-                    item.push_back({"courseName", JsonHelper::makeString(result->getString("course_name"))});
-                    item.push_back({"professorId", JsonHelper::makeString(result->getString("professor_id"))});
-                    item.push_back({"professorName", JsonHelper::makeString(result->getString("professor_name"))});
-                    item.push_back({"semesterId", JsonHelper::makeString(result->getString("semester_id"))});
-                    item.push_back({"semesterName", JsonHelper::makeString(result->getString("semester_name"))});
-                    item.push_back({"isPrimary", JsonHelper::makeBool(result->getBoolean("is_primary"))});
-                    assignments.push_back(JsonHelper::makeObject(item));
-                }
+                result = db.executeQuery(query);
             }
-            return JsonHelper::makeArray(assignments);
+
+            enum { ID, COURSE_ID, COURSE_CODE, COURSE_NAME, PROFESSOR_ID, PROFESSOR_NAME,
+                   SEMESTER_ID, SEMESTER_NAME, IS_PRIMARY };
+            static const string_view assignmentColumns[] = {
+                "id", "course_id", "course_code", "course_name", "professor_id", "professor_name",
+                "semester_id", "semester_name", "is_primary"
+            };
+            auto col = result->resolveColumns(assignmentColumns);
+
+            JsonWriter json(256 + (size_t)result->getRowCount() * 256);
+            json.beginArray();
+            while (result->next()) {
+                json.beginObject()
+                    .field("id", result->getStringView(col[ID]))
+                    .field("courseId", result->getStringView(col[COURSE_ID]))
+                    .field("courseCode", result->getStringView(col[COURSE_CODE]))
+                    .field("courseName", result->getStringView(col[COURSE_NAME]))
+                    .field("professorId", result->getStringView(col[PROFESSOR_ID]))
+                    .field("professorName", result->getStringView(col[PROFESSOR_NAME]))
+                    .field("semesterId", result->getStringView(col[SEMESTER_ID]))
+                    .field("semesterName", result->getStringView(col[SEMESTER_NAME]))
+                    .field("isPrimary", result->getBoolean(col[IS_PRIMARY]))
+                    .endObject();
+            }
+            json.endArray();
+            return json.release();
         } catch (...) {
             return "[]";
         }
     });
 
-    w.bind("cpp_assignCourse", [](const string& request) -> string {
+    bindPooled(w, "cpp_assignCourse", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_ASSIGN)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string courseId = JsonHelper::parseSimpleValue(request, "courseId");
-            string professorId = JsonHelper::parseSimpleValue(request, "professorId");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
-            string isPrimaryStr = JsonHelper::parseSimpleValue(request, "isPrimary");
+            string courseId = args.getString("courseId");
+            string professorId = args.getString("professorId");
+            string semesterId = args.getString("semesterId");
+            string isPrimaryStr = args.getString("isPrimary");
             bool isPrimary = isPrimaryStr == "true" || isPrimaryStr == "1";
 
             auto existsStmt = db.prepareStatement(
@@ -742,7 +1051,7 @@ int main() {
             stmt->setString(2, professorId);
             stmt->setString(3, semesterId);
             stmt->setInt(4, isPrimary ? 1 : 0);
-            stmt->setString(5, SessionManager::getSession().userId);
+            stmt->setString(5, SessionManager::getSession()->userId);
             stmt->executeUpdate();
 
             SessionManager::logAction(db, "ASSIGN", "course_assignments",
@@ -754,7 +1063,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_removeCourseAssignment", [](const string& request) -> string {
+    bindPooled(w, "cpp_removeCourseAssignment", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_ASSIGN)) {
                 return JsonHelper::errorResponse("Permission denied");
@@ -781,51 +1090,67 @@ int main() {
     // ========================================
     // REGISTRATIONS
     // ========================================
-    w.bind("cpp_getAllRegistrations", [](const string& request) -> string {
+    // Large listing: a second copy would only compete with the first
+    bindPooled(w, "cpp_getAllRegistrations", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::REG_VIEW)) {
                 return "[]";
             }
-            auto result = db.executeQuery(
-                "SELECT r.*, CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
-                "c.code AS course_code, c.name_en AS course_name, "
-                "sem.name_en AS semester_name "
-                "FROM registrations r "
+            ListingQuery listing(
+                "r.id, r.student_id, CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
+                "r.course_id, c.code AS course_code, c.name_en AS course_name, "
+                "r.semester_id, sem.name_en AS semester_name, r.status, r.created_at",
+                "registrations r "
                 "JOIN students s ON r.student_id = s.id "
                 "JOIN courses c ON r.course_id = c.id "
-                "JOIN semesters sem ON r.semester_id = sem.id "
-                "ORDER BY r.created_at DESC"
-            );
-
-            vector<string> registrations;
-            while (result->next()) {
-                vector<pair<string, string>> reg;
-                reg.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                reg.push_back({"studentId", JsonHelper::makeString(result->getString("student_id"))});
-                reg.push_back({"studentName", JsonHelper::makeString(result->getString("student_name"))});
-                reg.push_back({"courseId", JsonHelper::makeString(result->getString("course_id"))});
-                reg.push_back({"courseCode", JsonHelper::makeString(result->getString("course_code"))});
-                reg.push_back({"courseName", JsonHelper::makeString(result->getString("course_name"))});
-                reg.push_back({"semesterId", JsonHelper::makeString(result->getString("semester_id"))});
-                reg.push_back({"semesterName", JsonHelper::makeString(result->getString("semester_name"))});
-                reg.push_back({"status", JsonHelper::makeString(result->getString("status"))});
-                reg.push_back({"registrationDate", JsonHelper::makeString(result->getString("created_at"))});
-                registrations.push_back(JsonHelper::makeObject(reg));
-            }
-            return JsonHelper::makeArray(registrations);
+                "JOIN semesters sem ON r.semester_id = sem.id",
+                "registrations", {{"r.created_at", "created_at", true}, {"r.id", "id", true}});
+            listing.whereEquals("r.student_id", args.get("studentId"));
+            listing.whereEquals("r.course_id", args.get("courseId"));
+            listing.whereEquals("r.semester_id", args.get("semesterId"));
+            listing.whereEquals("r.status", args.get("status"));
+            listing.wherePrefix({"r.student_id", "s.first_name", "s.last_name", "c.code"}, args.get("search"));
+            listing.page(args);
+
+            // The full, unfiltered list is streamed and written row by row
+            auto result = listing.execute(db, true);
+            enum { ID, STUDENT_ID, STUDENT_NAME, COURSE_ID, COURSE_CODE, COURSE_NAME,
+                   SEMESTER_ID, SEMESTER_NAME, STATUS, CREATED_AT };
+            static const string_view registrationColumns[] = {
+                "id", "student_id", "student_name", "course_id", "course_code", "course_name",
+                "semester_id", "semester_name", "status", "created_at"
+            };
+            auto col = result->resolveColumns(registrationColumns);
+
+            return listing.respond(db, *result, [&](JsonWriter& json) {
+                json.beginObject()
+                    .field("id", result->getStringView(col[ID]))
+                    .field("studentId", result->getStringView(col[STUDENT_ID]))
+                    .field("studentName", result->getStringView(col[STUDENT_NAME]))
+                    .field("courseId", result->getStringView(col[COURSE_ID]))
+                    .field("courseCode", result->getStringView(col[COURSE_CODE]))
+                    .field("courseName", result->getStringView(col[COURSE_NAME]))
+                    .field("semesterId", result->getStringView(col[SEMESTER_ID]))
+                    .field("semesterName", result->getStringView(col[SEMESTER_NAME]))
+                    .field("status", result->getStringView(col[STATUS]))
+                    .field("registrationDate", result->getStringView(col[CREATED_AT]))
+                    .endObject();
+            }, 16 * 1024);
         } catch (...) {
             return "[]";
         }
-    });
+    }, 1);
 
-    w.bind("cpp_addRegistration", [](const string& request) -> string {
+    bindPooled(w, "cpp_addRegistration", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::REG_CREATE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string studentId = JsonHelper::parseSimpleValue(request, "studentId");
-            string courseId = JsonHelper::parseSimpleValue(request, "courseId");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
+            string studentId = args.getString("studentId");
+            string courseId = args.getString("courseId");
+            string semesterId = args.getString("semesterId");
 
             auto checkStmt = db.prepareStatement(
                 "SELECT COUNT(*) as count FROM registrations "
@@ -847,7 +1172,7 @@ int main() {
             stmt->setString(1, studentId);
             stmt->setString(2, courseId);
             stmt->setString(3, semesterId);
-            stmt->setString(4, SessionManager::getSession().userId);
+            stmt->setString(4, SessionManager::getSession()->userId);
             stmt->executeUpdate();
 
             string regId = to_string(db.getLastInsertId());
@@ -859,6 +1184,7 @@ int main() {
 
             SessionManager::logAction(db, "CREATE", "registrations", regId,
                                       "Registered " + studentId + " to " + courseId);
+            publishRegistration(db, "insert", regId);
             return JsonHelper::successResponse("Registration successful!");
         } catch (const exception& e) {
             return JsonHelper::errorResponse(e.what());
@@ -868,10 +1194,12 @@ int main() {
     // ========================================
     // GRADES
     // ========================================
-    w.bind("cpp_getStudentsByCourse", [](const string& request) -> string {
+    // Grades not recalculated yet are graded from their components
+    bindPooled(w, "cpp_getStudentsByCourse", [](Database& db, const string& request) -> string {
         try {
-            string courseId = JsonHelper::parseSimpleValue(request, "courseId");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
+            JsonRequest args(request);
+            string courseId = args.getString("courseId");
+            string semesterId = args.getString("semesterId");
             if (semesterId.empty()) {
                 int semesterNumber = 0;
                 getCurrentSemester(db, semesterId, semesterNumber);
@@ -881,8 +1209,8 @@ int main() {
                 return "[]";
             }
 
-            const UserSession& session = SessionManager::getSession();
-            if (session.isProfessor()) {
+            auto session = SessionManager::getSession();
+            if (session->isProfessor()) {
                 if (!SessionManager::canViewAssignedCourses() && !SessionManager::canEnterGrades()) {
                     return "[]";
                 }
@@ -893,20 +1221,14 @@ int main() {
                 return "[]";
             }
 
-            auto recalcStmt = db.prepareStatement(
-                "SELECT r.id FROM registrations r "
-                "WHERE r.course_id = ? AND r.semester_id = ? AND r.status = 'registered'"
-            );
-            recalcStmt->setString(1, courseId);
-            recalcStmt->setString(2, semesterId);
-            auto recalcRes = recalcStmt->executeQuery();
-            while (recalcRes->next()) {
-                Grade::calculateGrade(db, recalcRes->getString("id"));
-            }
-
+            // The roster fills the distribution cache, so validating the
+            // grades entered on it needs no query
+            uint64_t cacheGeneration = GradeDistributionCache::instance().currentGeneration();
             auto stmt = db.prepareStatement(
                 "SELECT r.id AS registration_id, r.student_id, "
                 "CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
+                "c.max_marks, c.assignment1_marks, c.assignment2_marks, c.year_work_marks, "
+                "c.final_exam_marks, COALESCE(g.is_dirty, FALSE) AS is_dirty, "
                 "COALESCE(g.assignment1, 0) AS assignment1, "
                 "COALESCE(g.assignment2, 0) AS assignment2, "
                 "COALESCE(g.year_work, 0) AS year_work, "
@@ -918,6 +1240,7 @@ int main() {
                 "COALESCE(g.letter_grade, 'F') AS letter_grade "
                 "FROM registrations r "
                 "JOIN students s ON r.student_id = s.id "
+                "JOIN courses c ON r.course_id = c.id "
                 "LEFT JOIN grades g ON r.id = g.registration_id "
                 "WHERE r.course_id = ? AND r.semester_id = ? AND r.status = 'registered' "
                 "ORDER BY s.first_name"
@@ -926,39 +1249,63 @@ int main() {
             stmt->setString(2, semesterId);
 
             auto result = stmt->executeQuery();
-            vector<string> students;
-            
-            while (result->next()) {
-                vector<pair<string, string>> student;
-                student.push_back({"registrationId", JsonHelper::makeString(result->getString("registration_id"))});
-                student.push_back({"studentId", JsonHelper::makeString(result->getString("student_id"))});
-                student.push_back({"studentName", JsonHelper::makeString(result->getString("student_name"))});
-                student.push_back({"assignment1", JsonHelper::makeNumber(result->getDouble("assignment1"))});
-                student.push_back({"assignment2", JsonHelper::makeNumber(result->getDouble("assignment2"))});
-                student.push_back({"yearWork", JsonHelper::makeNumber(result->getDouble("year_work"))});
-                student.push_back({"finalExam", JsonHelper::makeNumber(result->getDouble("final_exam"))});
-                student.push_back({"total", JsonHelper::makeNumber(result->getDouble("total_marks"))});
-                student.push_back({"percentage", JsonHelper::makeNumber(result->getDouble("percentage"))});
-                student.push_back({"gpa", JsonHelper::makeNumber(result->getDouble("gpa"))});
-                student.push_back({"evaluation", JsonHelper::makeString(result->getString("evaluation"))});
-                student.push_back({"letterGrade", JsonHelper::makeString(result->getString("letter_grade"))});
-                students.push_back(JsonHelper::makeObject(student));
-            }
-            return JsonHelper::makeArray(students);
+            GridWriter json(GridWriter::isColumnar(args), {"evaluation", "letterGrade"});
+            Grade::GradeDistribution dist{};
+            vector<string> registrationIds;
+
+            // Rows not recalculated yet are graded from their components in one kernel pass
+            Grade::GradedRows graded = Grade::gradeRows(*result);
+            auto stored = result->resolveColumns(storedGradeColumns);
+            enum { REGISTRATION_ID, STUDENT_ID, STUDENT_NAME };
+            static const string_view rosterColumns[] = {"registration_id", "student_id", "student_name"};
+            auto col = result->resolveColumns(rosterColumns);
+
+            for (size_t i = 0; result->next(); i++) {
+                if (registrationIds.empty()) {
+                    dist = Grade::readDistribution(*result);
+                }
+                string_view registrationId = result->getStringView(col[REGISTRATION_ID]);
+                registrationIds.emplace_back(registrationId);
+                ListedGrade grade = listedGrade(graded, i, *result, stored);
+
+                json.beginObject()
+                    .field("registrationId", registrationId)
+                    .field("studentId", result->getStringView(col[STUDENT_ID]))
+                    .field("studentName", result->getStringView(col[STUDENT_NAME]))
+                    .field("assignment1", graded.assignment1[i], 2)
+                    .field("assignment2", graded.assignment2[i], 2)
+                    .field("yearWork", graded.yearWork[i], 2)
+                    .field("finalExam", graded.finalExam[i], 2)
+                    .field("total", grade.total, 2)
+                    .field("percentage", grade.percentage, 2)
+                    .field("gpa", grade.gpa, 2)
+                    .field("evaluation", grade.evaluation)
+                    .field("letterGrade", grade.letterGrade)
+                    .endObject();
+            }
+            if (graded.anyDirty) {
+                GradeRecalculator::instance().notify();
+            }
+            if (!registrationIds.empty()) {
+                GradeDistributionCache::instance().store(courseId, semesterId, dist, registrationIds,
+                                                         cacheGeneration);
+            }
+            return json.release();
         } catch (...) {
             return "[]";
         }
-    });
+    }, 1);
 
-    w.bind("cpp_enterGrade", [](const string& request) -> string {
+    bindPooled(w, "cpp_enterGrade", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::canEnterGrades()) {
                 return JsonHelper::errorResponse("Permission denied: Only professors can enter grades");
             }
 
-            string registrationId = JsonHelper::parseSimpleValue(request, "registrationId");
-            string gradeType = JsonHelper::parseSimpleValue(request, "gradeType");
-            double value = stod(JsonHelper::parseSimpleValue(request, "value"));
+            string registrationId = args.getString("registrationId");
+            string gradeType = args.getString("gradeType");
+            double value = args.getDouble("value");
 
             if (gradeType != "assignment1" && gradeType != "assignment2" &&
                 gradeType != "year_work" && gradeType != "final_exam") {
@@ -971,31 +1318,36 @@ int main() {
             }
 
             // Professor must be assigned to the course for this registration
-            if (SessionManager::getSession().isProfessor()) {
-                auto infoStmt = db.prepareStatement(
-                    "SELECT course_id, semester_id FROM registrations WHERE id = ?"
-                );
-                infoStmt->setString(1, registrationId);
-                auto infoRes = infoStmt->executeQuery();
-                if (!infoRes->next()) {
-                    return JsonHelper::errorResponse("Registration not found");
+            if (SessionManager::getSession()->isProfessor()) {
+                GradeDistributionCache::Placement placement;
+                if (!GradeDistributionCache::instance().findPlacement(registrationId, placement)) {
+                    auto infoStmt = db.prepareStatement(
+                        "SELECT course_id, semester_id FROM registrations WHERE id = ?"
+                    );
+                    infoStmt->setString(1, registrationId);
+                    auto infoRes = infoStmt->executeQuery();
+                    if (!infoRes->next()) {
+                        return JsonHelper::errorResponse("Registration not found");
+                    }
+                    placement.courseId = infoRes->getString("course_id");
+                    placement.semesterId = infoRes->getString("semester_id");
                 }
-                if (!SessionManager::canAccessCourse(db,
-                                                    infoRes->getString("course_id"),
-                                                    infoRes->getString("semester_id"))) {
+                if (!SessionManager::canAccessCourse(db, placement.courseId, placement.semesterId)) {
                     return JsonHelper::errorResponse("Permission denied for this course");
                 }
             }
 
-            string query = "UPDATE grades SET " + gradeType + " = ?, last_modified_by = ? WHERE registration_id = ?";
+            string query = "UPDATE grades SET " + gradeType + " = ?, last_modified_by = ?, "
+                           "is_dirty = TRUE, row_version = row_version + 1 WHERE registration_id = ?";
             auto stmt = db.prepareStatement(query);
             stmt->setDouble(1, value);
-            stmt->setString(2, SessionManager::getSession().userId);
+            stmt->setString(2, SessionManager::getSession()->userId);
             stmt->setString(3, registrationId);
             stmt->executeUpdate();
+            GradeRecalculator::instance().notify();
 
-            Grade::calculateGrade(db, registrationId);
             SessionManager::logAction(db, "UPDATE_GRADE", "grades", registrationId, gradeType + " = " + to_string(value));
+            publishGrade(db, registrationId);
 
             return JsonHelper::successResponse("Grade updated!");
         } catch (const exception& e) {
@@ -1003,21 +1355,228 @@ int main() {
         }
     });
 
+    // A whole grade sheet in one call:
+    //   {"grades":[{"registrationId":"12","assignment1":8,"final_exam":41.5}, ...]}
+    // Components a row leaves out keep their marks. Every cell is checked
+    // against its course's distribution and the professor's assignments
+    // before anything is written, and one invalid cell rejects the sheet.
+    // The marks and one audit entry commit together; the changed rows are
+    // left dirty for the recalculator.
+    bindPooled(w, "cpp_enterGrades", [](Database& db, const string& request) -> string {
+        static const char* const COMPONENTS[] = {"assignment1", "assignment2", "year_work", "final_exam"};
+        constexpr int COMPONENT_COUNT = 4;
+
+        struct SheetRow {
+            string registrationId;
+            bool given[COMPONENT_COUNT] = {};
+            double marks[COMPONENT_COUNT] = {};
+            string courseId;
+            string semesterId;
+            Grade::GradeDistribution dist{};
+            bool found = false;
+        };
+
+        try {
+            JsonRequest args(request);
+            if (!SessionManager::canEnterGrades()) {
+                return JsonHelper::errorResponse("Permission denied: Only professors can enter grades");
+            }
+
+            // A registration listed twice merges its components, later ones winning
+            vector<SheetRow> sheet;
+            unordered_map<string, size_t> rowOf;
+            for (string_view element : JsonRequest::elements(args.get("grades"))) {
+                JsonRequest cell(element);
+                string registrationId = cell.getString("registrationId");
+                if (registrationId.empty()) {
+                    return JsonHelper::errorResponse("Every row needs a registrationId");
+                }
+                auto [at, added] = rowOf.emplace(registrationId, sheet.size());
+                if (added) {
+                    sheet.emplace_back();
+                    sheet.back().registrationId = registrationId;
+                }
+                SheetRow& row = sheet[at->second];
+                for (int c = 0; c < COMPONENT_COUNT; c++) {
+                    if (cell.has(COMPONENTS[c]) && !cell.isNull(COMPONENTS[c])) {
+                        row.given[c] = true;
+                        row.marks[c] = cell.getDouble(COMPONENTS[c]);
+                    }
+                }
+            }
+            if (sheet.empty()) {
+                return JsonHelper::errorResponse("No grades to save");
+            }
+
+            vector<string> changed;
+            size_t changedMarks = 0;
+            set<pair<string, string>> courses;
+
+            db.executeUpdate("START TRANSACTION");
+            try {
+                auto reject = [&db](const string& response) {
+                    db.executeUpdate("ROLLBACK");
+                    return response;
+                };
+
+                // Course, distribution and current marks of every row in one query.
+                // The rows stay locked until COMMIT, so neither the marks nor the
+                // distribution can change between the checks and the write.
+                string query =
+                    "SELECT r.id, r.course_id, r.semester_id, c.max_marks, "
+                    "c.assignment1_marks, c.assignment2_marks, c.year_work_marks, c.final_exam_marks, "
+                    "COALESCE(g.assignment1, 0) AS assignment1, COALESCE(g.assignment2, 0) AS assignment2, "
+                    "COALESCE(g.year_work, 0) AS year_work, COALESCE(g.final_exam, 0) AS final_exam "
+                    "FROM registrations r "
+                    "JOIN courses c ON r.course_id = c.id "
+                    "LEFT JOIN grades g ON g.registration_id = r.id "
+                    "WHERE r.id IN (";
+                for (size_t i = 0; i < sheet.size(); i++) {
+                    query += i == 0 ? "?" : ", ?";
+                }
+                query += ") FOR UPDATE";
+                auto stmt = db.prepareStatement(query);
+                for (size_t i = 0; i < sheet.size(); i++) {
+                    stmt->setString((int)i + 1, sheet[i].registrationId);
+                }
+                auto current = stmt->executeQuery();
+                vector<array<double, COMPONENT_COUNT>> stored(sheet.size());
+                while (current->next()) {
+                    auto found = rowOf.find(current->getString("id"));
+                    if (found == rowOf.end()) {
+                        continue;
+                    }
+                    SheetRow& row = sheet[found->second];
+                    row.found = true;
+                    row.courseId = current->getString("course_id");
+                    row.semesterId = current->getString("semester_id");
+                    row.dist = Grade::readDistribution(*current);
+                    for (int c = 0; c < COMPONENT_COUNT; c++) {
+                        stored[found->second][c] = current->getDouble(COMPONENTS[c]);
+                    }
+                    courses.insert({row.courseId, row.semesterId});
+                }
+
+                // Professors must be assigned to every course on the sheet
+                if (SessionManager::getSession()->isProfessor()) {
+                    for (const auto& [courseId, semesterId] : courses) {
+                        if (!SessionManager::canAccessCourse(db, courseId, semesterId)) {
+                            return reject(JsonHelper::errorResponse("Permission denied for course " + courseId));
+                        }
+                    }
+                }
+
+                JsonWriter errors;
+                errors.beginArray();
+                size_t errorCount = 0;
+                auto addError = [&](const string& registrationId, const char* component, const string& message) {
+                    errors.beginObject()
+                        .field("registrationId", registrationId)
+                        .field("component", component)
+                        .field("message", message)
+                        .endObject();
+                    errorCount++;
+                };
+                for (const SheetRow& row : sheet) {
+                    if (!row.found) {
+                        addError(row.registrationId, "", "Registration not found");
+                        continue;
+                    }
+                    for (int c = 0; c < COMPONENT_COUNT; c++) {
+                        if (!row.given[c]) continue;
+                        string message = Grade::validateGradeComponent(row.dist, COMPONENTS[c], row.marks[c]);
+                        if (!message.empty()) {
+                            addError(row.registrationId, COMPONENTS[c], message);
+                        }
+                    }
+                }
+                if (errorCount > 0) {
+                    errors.endArray();
+                    JsonWriter response;
+                    response.beginObject()
+                        .field("success", false)
+                        .field("message", to_string(errorCount) + " grade(s) are invalid; nothing was saved")
+                        .key("errors").raw(errors.str())
+                        .endObject();
+                    return reject(response.release());
+                }
+
+                // Only rows whose marks change are written
+                BatchInserter upsert(db, "grades",
+                    {"registration_id", "assignment1", "assignment2", "year_work", "final_exam",
+                     "last_modified_by", "is_dirty"});
+                upsert.onDuplicateKeyUpdate(
+                    "assignment1 = VALUES(assignment1), assignment2 = VALUES(assignment2), "
+                    "year_work = VALUES(year_work), final_exam = VALUES(final_exam), "
+                    "last_modified_by = VALUES(last_modified_by), "
+                    "is_dirty = TRUE, row_version = row_version + 1"
+                );
+                const string& userId = SessionManager::getSession()->userId;
+                for (size_t i = 0; i < sheet.size(); i++) {
+                    SheetRow& row = sheet[i];
+                    size_t rowChanges = 0;
+                    for (int c = 0; c < COMPONENT_COUNT; c++) {
+                        if (!row.given[c]) {
+                            row.marks[c] = stored[i][c];
+                        } else if (row.marks[c] != stored[i][c]) {
+                            rowChanges++;
+                        }
+                    }
+                    if (rowChanges == 0) continue;
+                    upsert.addRow({row.registrationId, row.marks[0], row.marks[1], row.marks[2], row.marks[3],
+                                   userId, 1});
+                    changed.push_back(row.registrationId);
+                    changedMarks += rowChanges;
+                }
+                upsert.finish();
+
+                string details = to_string(changedMarks) + " marks for " + to_string(changed.size()) +
+                                 " of " + to_string(sheet.size()) + " registrations";
+                string recordId = courses.size() == 1 ? courses.begin()->first : "";
+                if (courses.size() == 1) {
+                    details += " (semester " + courses.begin()->second + ")";
+                }
+                SessionManager::logAction(db, "UPDATE_GRADES", "grades", recordId, details);
+                db.executeUpdate("COMMIT");
+            } catch (...) {
+                try { db.executeUpdate("ROLLBACK"); } catch (...) {}
+                throw;
+            }
+
+            if (!changed.empty()) {
+                GradeRecalculator::instance().notify();
+            }
+            publishGrades(db, changed);
+
+            JsonWriter response;
+            response.beginObject()
+                .field("success", true)
+                .field("message", "Saved " + to_string(changed.size()) + " grade(s)")
+                .field("updated", changed.size())
+                .field("unchanged", sheet.size() - changed.size())
+                .endObject();
+            return response.release();
+        } catch (const exception& e) {
+            return JsonHelper::errorResponse(e.what());
+        }
+    });
+
     // ========================================
     // ATTENDANCE
     // ========================================
-    w.bind("cpp_getAttendanceByDate", [](const string& request) -> string {
+    bindPooled(w, "cpp_getAttendanceByDate", [](Database& db, const string& request) -> string {
         try {
-            string courseId = JsonHelper::parseSimpleValue(request, "courseId");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
-            string date = JsonHelper::parseSimpleValue(request, "date");
-            string sessionType = JsonHelper::parseSimpleValue(request, "sessionType");
+            JsonRequest args(request);
+            string courseId = args.getString("courseId");
+            string semesterId = args.getString("semesterId");
+            string date = args.getString("date");
+            string sessionType = args.getString("sessionType");
 
             if (!SessionManager::isLoggedIn()) {
                 return "[]";
             }
-            const UserSession& session = SessionManager::getSession();
-            if (session.isProfessor()) {
+            auto session = SessionManager::getSession();
+            if (session->isProfessor()) {
                 if (!SessionManager::canRecordAttendance()) {
                     return "[]";
                 }
@@ -1058,40 +1617,43 @@ int main() {
             stmt->setString(3, semesterId);
 
             auto result = stmt->executeQuery();
-            vector<string> students;
+            JsonWriter json;
+            json.beginArray();
 
             while (result->next()) {
-                vector<pair<string, string>> student;
-                student.push_back({"registrationId", JsonHelper::makeString(result->getString("registration_id"))});
-                student.push_back({"studentId", JsonHelper::makeString(result->getString("student_id"))});
-                student.push_back({"studentName", JsonHelper::makeString(result->getString("student_name"))});
-                student.push_back({"attendanceId", JsonHelper::makeString(result->getString("attendance_id"))});
-                student.push_back({"status", JsonHelper::makeString(result->getString("status"))});
-                student.push_back({"remarks", JsonHelper::makeString(result->getString("remarks"))});
-                students.push_back(JsonHelper::makeObject(student));
-            }
-            return JsonHelper::makeArray(students);
+                json.beginObject()
+                    .field("registrationId", result->getStringView("registration_id"))
+                    .field("studentId", result->getStringView("student_id"))
+                    .field("studentName", result->getStringView("student_name"))
+                    .field("attendanceId", result->getStringView("attendance_id"))
+                    .field("status", result->getStringView("status"))
+                    .field("remarks", result->getStringView("remarks"))
+                    .endObject();
+            }
+            json.endArray();
+            return json.release();
         } catch (...) {
             return "[]";
         }
     });
 
-    w.bind("cpp_saveAttendance", [](const string& request) -> string {
+    bindPooled(w, "cpp_saveAttendance", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::canRecordAttendance()) {
                 return JsonHelper::errorResponse("Permission denied");
             }
 
-            string courseId = JsonHelper::parseSimpleValue(request, "courseId");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
-            string studentId = JsonHelper::parseSimpleValue(request, "studentId");
-            string date = JsonHelper::parseSimpleValue(request, "date");
-            string sessionType = JsonHelper::parseSimpleValue(request, "sessionType");
-            string status = JsonHelper::parseSimpleValue(request, "status");
-            string remarks = JsonHelper::parseSimpleValue(request, "remarks");
+            string courseId = args.getString("courseId");
+            string semesterId = args.getString("semesterId");
+            string studentId = args.getString("studentId");
+            string date = args.getString("date");
+            string sessionType = args.getString("sessionType");
+            string status = args.getString("status");
+            string remarks = args.getString("remarks");
 
             // Professor must be assigned to the course for this semester
-            if (SessionManager::getSession().isProfessor()) {
+            if (SessionManager::getSession()->isProfessor()) {
                 if (!SessionManager::canAccessCourse(db, courseId, semesterId)) {
                     return JsonHelper::errorResponse("Permission denied for this course");
                 }
@@ -1116,8 +1678,8 @@ int main() {
                     "VALUES (?, ?, ?, ?, ?)"
                 );
                 createStmt->setString(1, courseId);
-                if (SessionManager::getSession().isProfessor()) {
-                    createStmt->setString(2, SessionManager::getSession().linkedId);
+                if (SessionManager::getSession()->isProfessor()) {
+                    createStmt->setString(2, SessionManager::getSession()->linkedId);
                 } else {
                     createStmt->setNull(2);
                 }
@@ -1135,14 +1697,18 @@ int main() {
             checkStmt->setString(2, studentId);
             auto checkResult = checkStmt->executeQuery();
 
+            string attendanceId;
+            const char* op;
             if (checkResult->next()) {
+                attendanceId = checkResult->getString("id");
+                op = "update";
                 auto updateStmt = db.prepareStatement(
                     "UPDATE attendance SET status = ?, remarks = ?, recorded_by = ? WHERE id = ?"
                 );
                 updateStmt->setString(1, status);
                 updateStmt->setString(2, remarks);
-                updateStmt->setString(3, SessionManager::getSession().userId);
-                updateStmt->setString(4, checkResult->getString("id"));
+                updateStmt->setString(3, SessionManager::getSession()->userId);
+                updateStmt->setString(4, attendanceId);
                 updateStmt->executeUpdate();
             } else {
                 auto insertStmt = db.prepareStatement(
@@ -1153,9 +1719,25 @@ int main() {
                 insertStmt->setString(2, studentId);
                 insertStmt->setString(3, status);
                 insertStmt->setString(4, remarks);
-                insertStmt->setString(5, SessionManager::getSession().userId);
+                insertStmt->setString(5, SessionManager::getSession()->userId);
                 insertStmt->executeUpdate();
-            }
+                attendanceId = to_string(db.getLastInsertId());
+                op = "insert";
+            }
+
+            // The row as cpp_getAttendanceByDate lists it, plus the session it belongs to
+            JsonWriter row(256);
+            row.beginObject()
+                .field("studentId", studentId)
+                .field("attendanceId", attendanceId)
+                .field("status", status)
+                .field("remarks", remarks)
+                .field("courseId", courseId)
+                .field("semesterId", semesterId)
+                .field("date", date)
+                .field("sessionType", sessionType)
+                .endObject();
+            ChangeFeed::instance().publish("attendance", op, attendanceId, row.str());
             return JsonHelper::successResponse("Attendance saved!");
         } catch (const exception& e) {
             return JsonHelper::errorResponse(e.what());
@@ -1165,85 +1747,71 @@ int main() {
     // ========================================
     // FEES MANAGEMENT
     // ========================================
-    w.bind("cpp_getStudentFees", [](const string& request) -> string {
+    bindPooled(w, "cpp_getStudentFees", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::FEE_VIEW)) {
                 return "[]";
             }
             
-            string studentId = JsonHelper::parseSimpleValue(request, "studentId");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
-            
-            string query = 
-                "SELECT sf.*, "
+            ListingQuery listing(
+                "sf.*, "
                 "CONCAT(s.first_name, ' ', s.last_name) AS student_name, "
                 "s.id AS student_id, "
-                "sem.name_en AS semester_name "
-                "FROM student_fees sf "
+                "sem.name_en AS semester_name",
+                "student_fees sf "
                 "JOIN students s ON sf.student_id = s.id "
-                "JOIN semesters sem ON sf.semester_id = sem.id "
-                "WHERE 1=1 ";
-            
-            vector<string> params;
-            if (!studentId.empty()) {
-                query += "AND sf.student_id = ? ";
-                params.push_back(studentId);
-            }
-            if (!semesterId.empty()) {
-                query += "AND sf.semester_id = ? ";
-                params.push_back(semesterId);
-            }
-            query += "ORDER BY sf.academic_year DESC, sf.created_at DESC";
-            
-            auto stmt = db.prepareStatement(query);
-            for (size_t i = 0; i < params.size(); i++) {
-                stmt->setString(static_cast<int>(i + 1), params[i]);
-            }
-            auto result = stmt->executeQuery();
-            
-            vector<string> fees;
-            while (result->next()) {
-                stringstream ss;
-                ss << "{";
-                ss << "\"id\"," << result->getInt("id") << ",";
-                ss << "\"studentId\":\"" << result->getString("student_id") << "\",";
-                ss << "\"studentName\":\"" << result->getString("student_name") << "\",";
-                ss << "\"academicYear\":\"" << result->getString("academic_year") << "\",";
-                ss << "\"semesterId\":\"" << result->getString("semester_id") << "\",";
-                ss << "\"semesterName\":\"" << result->getString("semester_name") << "\",";
-                ss << "\"baseFee\":" << result->getDouble("base_fee") << ",";
-                ss << "\"additionalFees\":" << result->getDouble("additional_fees") << ",";
-                ss << "\"discount\":" << result->getDouble("discount") << ",";
-                ss << "\"totalFees\":" << result->getDouble("total_fees") << ",";
-                ss << "\"paidAmount\":" << result->getDouble("paid_amount") << ",";
-                ss << "\"remainingAmount\":" << result->getDouble("remaining_amount") << ",";
-                ss << "\"status\":\"" << result->getString("status") << "\",";
-                ss << "\"dueDate\":\"" << (result->isNull("due_date") ? "" : result->getString("due_date")) << "\",";
-                ss << "\"notes\":\"" << (result->isNull("notes") ? "" : result->getString("notes")) << "\"";
-                ss << "}";
-                fees.push_back(ss.str());
-            }
-            return JsonHelper::makeArray(fees);
+                "JOIN semesters sem ON sf.semester_id = sem.id",
+                "student_fees",
+                {{"sf.academic_year", "academic_year", true}, {"sf.created_at", "created_at", true},
+                 {"sf.id", "id", true}});
+            listing.whereEquals("sf.student_id", args.get("studentId"));
+            listing.whereEquals("sf.semester_id", args.get("semesterId"));
+            listing.whereEquals("sf.status", args.get("status"));
+            listing.wherePrefix({"s.id", "s.first_name", "s.last_name"}, args.get("search"));
+            listing.page(args);
+
+            auto result = listing.execute(db);
+            return listing.respond(db, *result, [&](JsonWriter& json) {
+                json.beginObject()
+                    .field("id", result->getInt("id"))
+                    .field("studentId", result->getStringView("student_id"))
+                    .field("studentName", result->getStringView("student_name"))
+                    .field("academicYear", result->getStringView("academic_year"))
+                    .field("semesterId", result->getStringView("semester_id"))
+                    .field("semesterName", result->getStringView("semester_name"))
+                    .field("baseFee", result->getDouble("base_fee"))
+                    .field("additionalFees", result->getDouble("additional_fees"))
+                    .field("discount", result->getDouble("discount"))
+                    .field("totalFees", result->getDouble("total_fees"))
+                    .field("paidAmount", result->getDouble("paid_amount"))
+                    .field("remainingAmount", result->getDouble("remaining_amount"))
+                    .field("status", result->getStringView("status"))
+                    .field("dueDate", result->getStringView("due_date"))
+                    .field("notes", result->getStringView("notes"))
+                    .endObject();
+            });
         } catch (const exception& e) {
             cerr << "[Fees] Error: " << e.what() << endl;
             return "[]";
         }
     });
 
-    w.bind("cpp_createStudentFee", [](const string& request) -> string {
+    bindPooled(w, "cpp_createStudentFee", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::FEE_CREATE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
             
-            string studentId = JsonHelper::parseSimpleValue(request, "studentId");
-            string academicYear = JsonHelper::parseSimpleValue(request, "academicYear");
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
-            string baseFee = JsonHelper::parseSimpleValue(request, "baseFee");
-            string additionalFees = JsonHelper::parseSimpleValue(request, "additionalFees");
-            string discount = JsonHelper::parseSimpleValue(request, "discount");
-            string dueDate = JsonHelper::parseSimpleValue(request, "dueDate");
-            string notes = JsonHelper::parseSimpleValue(request, "notes");
+            string studentId = args.getString("studentId");
+            string academicYear = args.getString("academicYear");
+            string semesterId = args.getString("semesterId");
+            string baseFee = args.getString("baseFee");
+            string additionalFees = args.getString("additionalFees");
+            string discount = args.getString("discount");
+            string dueDate = args.getString("dueDate");
+            string notes = args.getString("notes");
             
             // Validate required fields
             if (studentId.empty() || semesterId.empty() || academicYear.empty()) {
@@ -1308,18 +1876,19 @@ int main() {
         }
     });
 
-    w.bind("cpp_updateStudentFee", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateStudentFee", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::FEE_EDIT)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
             
-            string feeId = JsonHelper::parseSimpleValue(request, "id");
-            string baseFee = JsonHelper::parseSimpleValue(request, "baseFee");
-            string additionalFees = JsonHelper::parseSimpleValue(request, "additionalFees");
-            string discount = JsonHelper::parseSimpleValue(request, "discount");
-            string dueDate = JsonHelper::parseSimpleValue(request, "dueDate");
-            string notes = JsonHelper::parseSimpleValue(request, "notes");
+            string feeId = args.getString("id");
+            string baseFee = args.getString("baseFee");
+            string additionalFees = args.getString("additionalFees");
+            string discount = args.getString("discount");
+            string dueDate = args.getString("dueDate");
+            string notes = args.getString("notes");
             
             // Validate required fields
             if (feeId.empty()) {
@@ -1382,13 +1951,14 @@ int main() {
         }
     });
 
-    w.bind("cpp_getPaymentHistory", [](const string& request) -> string {
+    bindPooled(w, "cpp_getPaymentHistory", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::PAY_VIEW)) {
                 return "[]";
             }
             
-            string studentFeeId = JsonHelper::parseSimpleValue(request, "studentFeeId");
+            string studentFeeId = args.getString("studentFeeId");
             
             string query = 
                 "SELECT fp.*, u.full_name AS recorded_by_name "
@@ -1401,40 +1971,41 @@ int main() {
             stmt->setString(1, studentFeeId);
             auto result = stmt->executeQuery();
             
-            vector<string> payments;
+            JsonWriter json;
+            json.beginArray();
             while (result->next()) {
-                stringstream ss;
-                ss << "{";
-                ss << "\"id\":" << result->getInt("id") << ",";
-                ss << "\"studentFeeId\":" << result->getInt("student_fee_id") << ",";
-                ss << "\"paymentDate\":\"" << result->getString("payment_date") << "\",";
-                ss << "\"amount\":" << result->getDouble("amount") << ",";
-                ss << "\"paymentMethod\":\"" << result->getString("payment_method") << "\",";
-                ss << "\"receiptNumber\":\"" << (result->isNull("receipt_number") ? "" : result->getString("receipt_number")) << "\",";
-                ss << "\"recordedBy\":" << result->getInt("recorded_by") << ",";
-                ss << "\"recordedByName\":\"" << result->getString("recorded_by_name") << "\",";
-                ss << "\"notes\":\"" << (result->isNull("notes") ? "" : result->getString("notes")) << "\"";
-                ss << "}";
-                payments.push_back(ss.str());
-            }
-            return JsonHelper::makeArray(payments);
+                json.beginObject()
+                    .field("id", result->getInt("id"))
+                    .field("studentFeeId", result->getInt("student_fee_id"))
+                    .field("paymentDate", result->getStringView("payment_date"))
+                    .field("amount", result->getDouble("amount"))
+                    .field("paymentMethod", result->getStringView("payment_method"))
+                    .field("receiptNumber", result->getStringView("receipt_number"))
+                    .field("recordedBy", result->getInt("recorded_by"))
+                    .field("recordedByName", result->getStringView("recorded_by_name"))
+                    .field("notes", result->getStringView("notes"))
+                    .endObject();
+            }
+            json.endArray();
+            return json.release();
         } catch (const exception& e) {
             return "[]";
         }
     });
 
-    w.bind("cpp_recordPayment", [](const string& request) -> string {
+    bindPooled(w, "cpp_recordPayment", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::PAY_CREATE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
             
-            string studentFeeId = JsonHelper::parseSimpleValue(request, "studentFeeId");
-            string paymentDate = JsonHelper::parseSimpleValue(request, "paymentDate");
-            string amount = JsonHelper::parseSimpleValue(request, "amount");
-            string paymentMethod = JsonHelper::parseSimpleValue(request, "paymentMethod");
-            string receiptNumber = JsonHelper::parseSimpleValue(request, "receiptNumber");
-            string notes = JsonHelper::parseSimpleValue(request, "notes");
+            string studentFeeId = args.getString("studentFeeId");
+            string paymentDate = args.getString("paymentDate");
+            string amount = args.getString("amount");
+            string paymentMethod = args.getString("paymentMethod");
+            string receiptNumber = args.getString("receiptNumber");
+            string notes = args.getString("notes");
             
             // Validate required fields
             if (studentFeeId.empty() || paymentDate.empty() || amount.empty() || paymentMethod.empty()) {
@@ -1495,7 +2066,7 @@ int main() {
                 stmt->setDouble(3, amountValue);
                 stmt->setString(4, paymentMethod);
                 if (receiptNumber.empty()) stmt->setNull(5); else stmt->setString(5, receiptNumber);
-                stmt->setString(6, SessionManager::getSession().userId);
+                stmt->setString(6, SessionManager::getSession()->userId);
                 if (notes.empty()) stmt->setNull(7); else stmt->setString(7, notes);
                 
                 stmt->executeUpdate();
@@ -1536,13 +2107,14 @@ int main() {
         }
     });
 
-    w.bind("cpp_getFeesSummary", [](const string& request) -> string {
+    bindPooled(w, "cpp_getFeesSummary", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::hasPermission(Permissions::FEE_VIEW)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
             
-            string semesterId = JsonHelper::parseSimpleValue(request, "semesterId");
+            string semesterId = args.getString("semesterId");
             
             string baseQuery = "SELECT COUNT(*) as total_students, "
                              "COALESCE(SUM(total_fees), 0) as total_fees, "
@@ -1553,40 +2125,27 @@ int main() {
                              "SUM(CASE WHEN status = 'unpaid' THEN 1 ELSE 0 END) as unpaid_count "
                              "FROM student_fees ";
             
+            unique_ptr<ResultSet> result;
             if (!semesterId.empty()) {
                 baseQuery += "WHERE semester_id = ?";
                 auto stmt = db.prepareStatement(baseQuery);
                 stmt->setString(1, semesterId);
-                auto result = stmt->executeQuery();
-                
-                if (result->next()) {
-                    stringstream ss;
-                    ss << "{";
-                    ss << "\"totalStudents\":" << result->getInt("total_students") << ",";
-                    ss << "\"totalFees\":" << result->getDouble("total_fees") << ",";
-                    ss << "\"totalPaid\":" << result->getDouble("total_paid") << ",";
-                    ss << "\"totalRemaining\":" << result->getDouble("total_remaining") << ",";
-                    ss << "\"paidCount\":" << result->getInt("paid_count") << ",";
-                    ss << "\"partialCount\":" << result->getInt("partial_count") << ",";
-                    ss << "\"unpaidCount\":" << result->getInt("unpaid_count");
-                    ss << "}";
-                    return ss.str();
-                }
+                result = stmt->executeQuery();
             } else {
-                auto result = db.executeQuery(baseQuery);
-                if (result->next()) {
-                    stringstream ss;
-                    ss << "{";
-                    ss << "\"totalStudents\":" << result->getInt("total_students") << ",";
-                    ss << "\"totalFees\":" << result->getDouble("total_fees") << ",";
-                    ss << "\"totalPaid\":" << result->getDouble("total_paid") << ",";
-                    ss << "\"totalRemaining\":" << result->getDouble("total_remaining") << ",";
-                    ss << "\"paidCount\":" << result->getInt("paid_count") << ",";
-                    ss << "\"partialCount\":" << result->getInt("partial_count") << ",";
-                    ss << "\"unpaidCount\":" << result->getInt("unpaid_count");
-                    ss << "}";
-                    return ss.str();
-                }
+                result = db.executeQuery(baseQuery);
+            }
+            if (result->next()) {
+                JsonWriter json;
+                json.beginObject()
+                    .field("totalStudents", result->getInt("total_students"))
+                    .field("totalFees", result->getDouble("total_fees"))
+                    .field("totalPaid", result->getDouble("total_paid"))
+                    .field("totalRemaining", result->getDouble("total_remaining"))
+                    .field("paidCount", result->getInt("paid_count"))
+                    .field("partialCount", result->getInt("partial_count"))
+                    .field("unpaidCount", result->getInt("unpaid_count"))
+                    .endObject();
+                return json.release();
             }
             return "{}";
         } catch (const exception& e) {
@@ -1597,156 +2156,187 @@ int main() {
     // ========================================
     // DROPDOWN DATA
     // ========================================
-    w.bind("cpp_getAcademicLevels", [](const string& request) -> string {
+    // Served from ReferenceCache: built once, then reused until a write
+    // to the table invalidates it
+    bindPooled(w, "cpp_getAcademicLevels", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery(
-                "SELECT id, name_en, year_number FROM academic_levels ORDER BY year_number"
-            );
-            vector<string> levels;
-            while (result->next()) {
-                vector<pair<string, string>> level;
-                level.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                level.push_back({"name", JsonHelper::makeString(result->getString("name_en"))});
-                level.push_back({"year", JsonHelper::makeNumber(result->getInt("year_number"))});
-                levels.push_back(JsonHelper::makeObject(level));
-            }
-            return JsonHelper::makeArray(levels);
+            return *ReferenceCache::instance().get(ReferenceCache::ACADEMIC_LEVELS, db, [](Database& db) {
+                auto result = db.executeQuery(
+                    "SELECT id, name_en, year_number FROM academic_levels ORDER BY year_number"
+                );
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name_en"))
+                        .field("year", result->getInt("year_number"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getDepartments", [](const string& request) -> string {
+    bindPooled(w, "cpp_getDepartments", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery(
-                "SELECT d.id, d.name_en, d.college_id, d.code, c.name_en as college_name "
-                "FROM departments d JOIN colleges c ON d.college_id = c.id ORDER BY d.name_en"
-            );
-            vector<string> depts;
-            while (result->next()) {
-                vector<pair<string, string>> dept;
-                dept.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                dept.push_back({"name", JsonHelper::makeString(result->getString("name_en"))});
-                dept.push_back({"collegeId", JsonHelper::makeString(result->getString("college_id"))});
-                dept.push_back({"collegeName", JsonHelper::makeString(result->getString("college_name"))});
-                dept.push_back({"code", JsonHelper::makeString(result->getString("code"))});
-                depts.push_back(JsonHelper::makeObject(dept));
-            }
-            return JsonHelper::makeArray(depts);
+            return *ReferenceCache::instance().get(ReferenceCache::DEPARTMENTS, db, [](Database& db) {
+                auto result = db.executeQuery(
+                    "SELECT d.id, d.name_en, d.college_id, d.code, c.name_en as college_name "
+                    "FROM departments d JOIN colleges c ON d.college_id = c.id ORDER BY d.name_en"
+                );
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name_en"))
+                        .field("collegeId", result->getStringView("college_id"))
+                        .field("collegeName", result->getStringView("college_name"))
+                        .field("code", result->getStringView("code"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getColleges", [](const string& request) -> string {
+    bindPooled(w, "cpp_getColleges", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery("SELECT id, name_en FROM colleges ORDER BY name_en");
-            vector<string> colleges;
-            while (result->next()) {
-                vector<pair<string, string>> col;
-                col.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                col.push_back({"name", JsonHelper::makeString(result->getString("name_en"))});
-                colleges.push_back(JsonHelper::makeObject(col));
-            }
-            return JsonHelper::makeArray(colleges);
+            return *ReferenceCache::instance().get(ReferenceCache::COLLEGES, db, [](Database& db) {
+                auto result = db.executeQuery("SELECT id, name_en FROM colleges ORDER BY name_en");
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name_en"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getLectureHalls", [](const string& request) -> string {
+    bindPooled(w, "cpp_getLectureHalls", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery(
-                "SELECT id, name, building, floor, max_capacity, seating_desc, "
-                "ac_units, fan_units, lighting_units, description "
-                "FROM lecture_halls ORDER BY name"
-            );
-            vector<string> halls;
-            while (result->next()) {
-                vector<pair<string, string>> hall;
-                hall.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                hall.push_back({"name", JsonHelper::makeString(result->getString("name"))});
-                hall.push_back({"building", JsonHelper::makeString(result->getString("building"))});
-                hall.push_back({"floor", JsonHelper::makeNumber(result->getInt("floor"))});
-                hall.push_back({"maxCapacity", JsonHelper::makeNumber(result->getInt("max_capacity"))});
-                hall.push_back({"seatingDesc", JsonHelper::makeString(result->getString("seating_desc"))});
-                hall.push_back({"acUnits", JsonHelper::makeNumber(result->getInt("ac_units"))});
-                hall.push_back({"fanUnits", JsonHelper::makeNumber(result->getInt("fan_units"))});
-                hall.push_back({"lightingUnits", JsonHelper::makeNumber(result->getInt("lighting_units"))});
-                hall.push_back({"description", JsonHelper::makeString(result->getString("description"))});
-                halls.push_back(JsonHelper::makeObject(hall));
-            }
-            return JsonHelper::makeArray(halls);
+            return *ReferenceCache::instance().get(ReferenceCache::LECTURE_HALLS, db, [](Database& db) {
+                auto result = db.executeQuery(
+                    "SELECT id, name, building, floor, max_capacity, seating_desc, "
+                    "ac_units, fan_units, lighting_units, description "
+                    "FROM lecture_halls ORDER BY name"
+                );
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name"))
+                        .field("building", result->getStringView("building"))
+                        .field("floor", result->getInt("floor"))
+                        .field("maxCapacity", result->getInt("max_capacity"))
+                        .field("seatingDesc", result->getStringView("seating_desc"))
+                        .field("acUnits", result->getInt("ac_units"))
+                        .field("fanUnits", result->getInt("fan_units"))
+                        .field("lightingUnits", result->getInt("lighting_units"))
+                        .field("description", result->getStringView("description"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getLaboratories", [](const string& request) -> string {
+    bindPooled(w, "cpp_getLaboratories", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery(
-                "SELECT id, name, building, floor, max_capacity, lab_type, "
-                "computers_count, seats_count, ac_units, fan_units, lighting_units, description "
-                "FROM laboratories ORDER BY name"
-            );
-            vector<string> labs;
-            while (result->next()) {
-                vector<pair<string, string>> lab;
-                lab.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                lab.push_back({"name", JsonHelper::makeString(result->getString("name"))});
-                lab.push_back({"building", JsonHelper::makeString(result->getString("building"))});
-                lab.push_back({"floor", JsonHelper::makeNumber(result->getInt("floor"))});
-                lab.push_back({"maxCapacity", JsonHelper::makeNumber(result->getInt("max_capacity"))});
-                lab.push_back({"labType", JsonHelper::makeString(result->getString("lab_type"))});
-                lab.push_back({"computersCount", JsonHelper::makeNumber(result->getInt("computers_count"))});
-                lab.push_back({"seatsCount", JsonHelper::makeNumber(result->getInt("seats_count"))});
-                lab.push_back({"acUnits", JsonHelper::makeNumber(result->getInt("ac_units"))});
-                lab.push_back({"fanUnits", JsonHelper::makeNumber(result->getInt("fan_units"))});
-                lab.push_back({"lightingUnits", JsonHelper::makeNumber(result->getInt("lighting_units"))});
-                lab.push_back({"description", JsonHelper::makeString(result->getString("description"))});
-                labs.push_back(JsonHelper::makeObject(lab));
-            }
-            return JsonHelper::makeArray(labs);
+            return *ReferenceCache::instance().get(ReferenceCache::LABORATORIES, db, [](Database& db) {
+                auto result = db.executeQuery(
+                    "SELECT id, name, building, floor, max_capacity, lab_type, "
+                    "computers_count, seats_count, ac_units, fan_units, lighting_units, description "
+                    "FROM laboratories ORDER BY name"
+                );
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name"))
+                        .field("building", result->getStringView("building"))
+                        .field("floor", result->getInt("floor"))
+                        .field("maxCapacity", result->getInt("max_capacity"))
+                        .field("labType", result->getStringView("lab_type"))
+                        .field("computersCount", result->getInt("computers_count"))
+                        .field("seatsCount", result->getInt("seats_count"))
+                        .field("acUnits", result->getInt("ac_units"))
+                        .field("fanUnits", result->getInt("fan_units"))
+                        .field("lightingUnits", result->getInt("lighting_units"))
+                        .field("description", result->getStringView("description"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getSemesters", [](const string& request) -> string {
+    bindPooled(w, "cpp_getSemesters", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery(
-                "SELECT id, name_en, academic_year, semester_number, is_current "
-                "FROM semesters ORDER BY academic_year DESC, semester_number"
-            );
-            vector<string> semesters;
-            while (result->next()) {
-                vector<pair<string, string>> sem;
-                sem.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                sem.push_back({"name", JsonHelper::makeString(result->getString("name_en"))});
-                sem.push_back({"academicYear", JsonHelper::makeString(result->getString("academic_year"))});
-                sem.push_back({"semesterNumber", JsonHelper::makeNumber(result->getInt("semester_number"))});
-                sem.push_back({"isCurrent", JsonHelper::makeBool(result->getBoolean("is_current"))});
-                semesters.push_back(JsonHelper::makeObject(sem));
-            }
-            return JsonHelper::makeArray(semesters);
+            return *ReferenceCache::instance().get(ReferenceCache::SEMESTERS, db, [](Database& db) {
+                auto result = db.executeQuery(
+                    "SELECT id, name_en, academic_year, semester_number, is_current "
+                    "FROM semesters ORDER BY academic_year DESC, semester_number"
+                );
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name_en"))
+                        .field("academicYear", result->getStringView("academic_year"))
+                        .field("semesterNumber", result->getInt("semester_number"))
+                        .field("isCurrent", result->getBoolean("is_current"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getCourseTypes", [](const string& request) -> string {
+    bindPooled(w, "cpp_getCourseTypes", [](Database& db, const string& request) -> string {
         try {
-            auto result = db.executeQuery(
-                "SELECT id, name, max_marks, year_work_max, lab_max, practical_max, written_exam_max "
-                "FROM course_types ORDER BY name"
-            );
-            vector<string> types;
-            while (result->next()) {
-                vector<pair<string, string>> ct;
-                ct.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                ct.push_back({"name", JsonHelper::makeString(result->getString("name"))});
-                ct.push_back({"maxMarks", JsonHelper::makeNumber(result->getInt("max_marks"))});
-                ct.push_back({"yearWorkMax", JsonHelper::makeNumber(result->getInt("year_work_max"))});
-                ct.push_back({"labMax", JsonHelper::makeNumber(result->getInt("lab_max"))});
-                ct.push_back({"practicalMax", JsonHelper::makeNumber(result->getInt("practical_max"))});
-                ct.push_back({"writtenMax", JsonHelper::makeNumber(result->getInt("written_exam_max"))});
-                types.push_back(JsonHelper::makeObject(ct));
-            }
-            return JsonHelper::makeArray(types);
+            return *ReferenceCache::instance().get(ReferenceCache::COURSE_TYPES, db, [](Database& db) {
+                auto result = db.executeQuery(
+                    "SELECT id, name, max_marks, year_work_max, lab_max, practical_max, written_exam_max "
+                    "FROM course_types ORDER BY name"
+                );
+                JsonWriter json;
+                json.beginArray();
+                while (result->next()) {
+                    json.beginObject()
+                        .field("id", result->getStringView("id"))
+                        .field("name", result->getStringView("name"))
+                        .field("maxMarks", result->getInt("max_marks"))
+                        .field("yearWorkMax", result->getInt("year_work_max"))
+                        .field("labMax", result->getInt("lab_max"))
+                        .field("practicalMax", result->getInt("practical_max"))
+                        .field("writtenMax", result->getInt("written_exam_max"))
+                        .endObject();
+                }
+                json.endArray();
+                return json.release();
+            });
         } catch (...) { return "[]"; }
     });
 
-    w.bind("cpp_getStudentGrades", [](const string& request) -> string {
+    bindPooled(w, "cpp_getStudentGrades", [](Database& db, const string& request) -> string {
         try {
-            string studentId = JsonHelper::parseSimpleValue(request, "studentId");
+            JsonRequest args(request);
+            string studentId = args.getString("studentId");
             studentId.erase(remove(studentId.begin(), studentId.end(), '['), studentId.end());
             studentId.erase(remove(studentId.begin(), studentId.end(), ']'), studentId.end());
             studentId.erase(remove(studentId.begin(), studentId.end(), '"'), studentId.end());
@@ -1754,30 +2344,21 @@ int main() {
             if (!SessionManager::isLoggedIn()) {
                 return "[]";
             }
-            const UserSession& session = SessionManager::getSession();
-            if (session.isStudent() && !SessionManager::isOwnStudentId(studentId)) {
+            auto session = SessionManager::getSession();
+            if (session->isStudent() && !SessionManager::isOwnStudentId(studentId)) {
                 return "[]";
             }
-            if (session.isProfessor()) {
+            if (session->isProfessor()) {
                 return "[]";
             }
-            if (!session.isStudent() && !SessionManager::canViewAllGrades()) {
+            if (!session->isStudent() && !SessionManager::canViewAllGrades()) {
                 return "[]";
             }
 
-            auto recalcStmt = db.prepareStatement(
-                "SELECT id FROM registrations WHERE student_id = ?"
-            );
-            recalcStmt->setString(1, studentId);
-            auto recalcRes = recalcStmt->executeQuery();
-            while (recalcRes->next()) {
-                Grade::calculateGrade(db, recalcRes->getString("id"));
-            }
-
             auto stmt = db.prepareStatement(
                 "SELECT r.id AS registration_id, c.code AS course_code, c.name_en AS course_name, "
                 "ct.name AS course_type, c.max_marks, c.credit_hours, "
-                "sem.name_en AS semester_name, "
+                "sem.name_en AS semester_name, COALESCE(g.is_dirty, FALSE) AS is_dirty, "
                 "COALESCE(g.assignment1, 0) AS assignment1, COALESCE(g.assignment2, 0) AS assignment2, "
                 "COALESCE(g.year_work, 0) AS year_work, COALESCE(g.final_exam, 0) AS final_exam, "
                 "COALESCE(g.total_marks, 0) AS total_marks, COALESCE(g.percentage, 0) AS percentage, "
@@ -1794,42 +2375,53 @@ int main() {
             stmt->setString(1, studentId);
             auto result = stmt->executeQuery();
 
-            vector<string> students;
+            JsonWriter json;
+            json.beginArray();
+
+            // Rows not recalculated yet are graded from their components in one kernel pass
+            Grade::GradedRows graded = Grade::gradeRows(*result);
+            auto stored = result->resolveColumns(storedGradeColumns);
+            enum { REGISTRATION_ID, STUDENT_ID, STUDENT_NAME };
+            static const string_view gradeColumns[] = {"registration_id", "student_id", "student_name"};
+            auto col = result->resolveColumns(gradeColumns);
             
-            while (result->next()) {
-                double assignment1 = result->getDouble("assignment1");
-                double assignment2 = result->getDouble("assignment2");
-                double yearWork = result->getDouble("year_work");
-                double finalExam = result->getDouble("final_exam");
+            for (size_t i = 0; result->next(); i++) {
+                ListedGrade grade = listedGrade(graded, i, *result, stored);
                 
                 // Check if any grades have been entered
-                bool gradesEntered = (assignment1 + assignment2 + yearWork + finalExam) > 0;
+                bool gradesEntered = (graded.assignment1[i] + graded.assignment2[i] +
+                                      graded.yearWork[i] + graded.finalExam[i]) > 0;
                 
-                vector<pair<string, string>> student;
-                student.push_back({"registrationId", JsonHelper::makeString(result->getString("registration_id"))});
-                student.push_back({"studentId", JsonHelper::makeString(result->getString("student_id"))});
-                student.push_back({"studentName", JsonHelper::makeString(result->getString("student_name"))});
-                student.push_back({"assignment1", JsonHelper::makeNumber(assignment1)});
-                student.push_back({"assignment2", JsonHelper::makeNumber(assignment2)});
-                student.push_back({"yearWork", JsonHelper::makeNumber(yearWork)});
-                student.push_back({"finalExam", JsonHelper::makeNumber(finalExam)});
-                student.push_back({"total", JsonHelper::makeNumber(result->getDouble("total_marks"))});
-                student.push_back({"percentage", JsonHelper::makeNumber(result->getDouble("percentage"))});
-                student.push_back({"gpa", JsonHelper::makeNumber(result->getDouble("gpa"))});
-                student.push_back({"evaluation", JsonHelper::makeString(result->getString("evaluation"))});
-                student.push_back({"letterGrade", JsonHelper::makeString(result->getString("letter_grade"))});
-                student.push_back({"gradesEntered", gradesEntered ? "true" : "false"});
-                students.push_back(JsonHelper::makeObject(student));
-            }
-            return JsonHelper::makeArray(students);
+                json.beginObject()
+                    .field("registrationId", result->getStringView(col[REGISTRATION_ID]))
+                    .field("studentId", result->getStringView(col[STUDENT_ID]))
+                    .field("studentName", result->getStringView(col[STUDENT_NAME]))
+                    .field("assignment1", graded.assignment1[i], 2)
+                    .field("assignment2", graded.assignment2[i], 2)
+                    .field("yearWork", graded.yearWork[i], 2)
+                    .field("finalExam", graded.finalExam[i], 2)
+                    .field("total", grade.total, 2)
+                    .field("percentage", grade.percentage, 2)
+                    .field("gpa", grade.gpa, 2)
+                    .field("evaluation", grade.evaluation)
+                    .field("letterGrade", grade.letterGrade)
+                    .field("gradesEntered", gradesEntered)
+                    .endObject();
+            }
+            json.endArray();
+            if (graded.anyDirty) {
+                GradeRecalculator::instance().notify();
+            }
+            return json.release();
         } catch (const exception& e) {
             return "[]";
         }
     });
 
-    w.bind("cpp_getStudentCGPA", [](const string& request) -> string {
+    bindPooled(w, "cpp_getStudentCGPA", [](Database& db, const string& request) -> string {
         try {
-            string studentId = JsonHelper::parseSimpleValue(request, "studentId");
+            JsonRequest args(request);
+            string studentId = args.getString("studentId");
             studentId.erase(remove(studentId.begin(), studentId.end(), '['), studentId.end());
             studentId.erase(remove(studentId.begin(), studentId.end(), ']'), studentId.end());
             studentId.erase(remove(studentId.begin(), studentId.end(), '"'), studentId.end());
@@ -1837,26 +2429,17 @@ int main() {
             if (!SessionManager::isLoggedIn()) {
                 return "{\"cgpa\": 0.00}";
             }
-            const UserSession& session = SessionManager::getSession();
-            if (session.isStudent() && !SessionManager::isOwnStudentId(studentId)) {
+            auto session = SessionManager::getSession();
+            if (session->isStudent() && !SessionManager::isOwnStudentId(studentId)) {
                 return "{\"cgpa\": 0.00}";
             }
-            if (session.isProfessor()) {
+            if (session->isProfessor()) {
                 return "{\"cgpa\": 0.00}";
             }
-            if (!session.isStudent() && !SessionManager::canViewAllGrades()) {
+            if (!session->isStudent() && !SessionManager::canViewAllGrades()) {
                 return "{\"cgpa\": 0.00}";
             }
 
-            auto recalcStmt = db.prepareStatement(
-                "SELECT id FROM registrations WHERE student_id = ?"
-            );
-            recalcStmt->setString(1, studentId);
-            auto recalcRes = recalcStmt->executeQuery();
-            while (recalcRes->next()) {
-                Grade::calculateGrade(db, recalcRes->getString("id"));
-            }
-
             double cgpa = Grade::calculateStudentCGPA(db, studentId);
             vector<pair<string, string>> result;
             result.push_back({"cgpa", JsonHelper::makeNumber(cgpa)});
@@ -1869,7 +2452,7 @@ int main() {
     // ========================================
     // Student Profile API
     // ========================================
-    w.bind("cpp_getStudentProfile", [](const string& request) -> string {
+    bindPooled(w, "cpp_getStudentProfile", [](Database& db, const string& request) -> string {
         try {
             string studentId = request;
             studentId.erase(remove(studentId.begin(), studentId.end(), '['), studentId.end());
@@ -1879,13 +2462,16 @@ int main() {
             if (!SessionManager::isLoggedIn()) {
                 return "{}";
             }
-            const UserSession& session = SessionManager::getSession();
+            auto session = SessionManager::getSession();
             // Students can only view their own profile
-            if (session.isStudent() && !SessionManager::isOwnStudentId(studentId)) {
+            if (session->isStudent() && !SessionManager::isOwnStudentId(studentId)) {
                 return "{}";
             }
 
-            auto stmt = db.prepareStatement(
+            // The profile and the course counts are independent: send both
+            // over the leased connection in a single round trip
+            QueryPipeline pipeline(db);
+            pipeline.add(
                 "SELECT s.id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
                 "s.email, s.phone, s.enrollment_date, s.status, "
                 "al.id AS level_id, al.name_en AS level_name, al.year_number, "
@@ -1895,25 +2481,25 @@ int main() {
                 "LEFT JOIN academic_levels al ON s.academic_level_id = al.id "
                 "LEFT JOIN departments d ON s.department_id = d.id "
                 "LEFT JOIN colleges c ON d.college_id = c.id "
-                "WHERE s.id = ?"
+                "WHERE s.id = ?",
+                {studentId}
             );
-            stmt->setString(1, studentId);
-            auto result = stmt->executeQuery();
-
-            if (!result->next()) {
-                return "{}";
-            }
-
-            // Get count of registered courses
-            auto courseStmt = db.prepareStatement(
+            pipeline.add(
                 "SELECT COUNT(*) as total_courses, "
                 "SUM(CASE WHEN sem.is_current = TRUE THEN 1 ELSE 0 END) as current_courses "
                 "FROM registrations r "
                 "LEFT JOIN semesters sem ON r.semester_id = sem.id "
-                "WHERE r.student_id = ?"
+                "WHERE r.student_id = ?",
+                {studentId}
             );
-            courseStmt->setString(1, studentId);
-            auto courseResult = courseStmt->executeQuery();
+            auto results = pipeline.execute();
+            auto& result = results[0];
+            auto& courseResult = results[1];
+
+            if (!result->next()) {
+                return "{}";
+            }
+
             int totalCourses = 0;
             int currentCourses = 0;
             if (courseResult->next()) {
@@ -1950,7 +2536,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_deleteRegistration", [](const string& request) -> string {
+    bindPooled(w, "cpp_deleteRegistration", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::REG_DELETE)) {
                 return JsonHelper::errorResponse("Permission denied");
@@ -1963,6 +2549,7 @@ int main() {
             auto stmt = db.prepareStatement("DELETE FROM registrations WHERE id = ?");
             stmt->setString(1, id);
             int rows = stmt->executeUpdate();
+            GradeDistributionCache::instance().forgetRegistration(id);
 
             if (rows > 0) {
                 SessionManager::logAction(db, "DELETE", "registrations", id, "Deleted registration");
@@ -1974,13 +2561,14 @@ int main() {
         }
     });
 
-    w.bind("cpp_updateRegistrationStatus", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateRegistrationStatus", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::REG_EDIT)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string status = JsonHelper::parseSimpleValue(request, "status");
+            string id = args.getString("id");
+            string status = args.getString("status");
 
             auto stmt = db.prepareStatement("UPDATE registrations SET status = ? WHERE id = ?");
             stmt->setString(1, status);
@@ -1994,40 +2582,32 @@ int main() {
         }
     });
 
-    w.bind("cpp_addCourse", [](const string& request) -> string {
+    bindPooled(w, "cpp_addCourse", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_CREATE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string code = JsonHelper::parseSimpleValue(request, "code");
-            string nameEn = JsonHelper::parseSimpleValue(request, "nameEn");
-            string nameAr = JsonHelper::parseSimpleValue(request, "nameAr");
-            string description = JsonHelper::parseSimpleValue(request, "description");
-            string departmentId = JsonHelper::parseSimpleValue(request, "departmentId");
-            string academicLevelId = JsonHelper::parseSimpleValue(request, "academicLevelId");
-            string courseTypeId = JsonHelper::parseSimpleValue(request, "courseTypeId");
-            int semesterNumber = stoi(JsonHelper::parseSimpleValue(request, "semesterNumber"));
-            int creditHours = stoi(JsonHelper::parseSimpleValue(request, "creditHours"));
-            string lectureHoursStr = JsonHelper::parseSimpleValue(request, "lectureHours");
-            string tutorialHoursStr = JsonHelper::parseSimpleValue(request, "tutorialHours");
-            string labHoursStr = JsonHelper::parseSimpleValue(request, "labHours");
-            string practicalHoursStr = JsonHelper::parseSimpleValue(request, "practicalHours");
-            string maxMarksStr = JsonHelper::parseSimpleValue(request, "maxMarks");
-            string yearWorkStr = JsonHelper::parseSimpleValue(request, "yearWorkMarks");
-            string assignment1Str = JsonHelper::parseSimpleValue(request, "assignment1Marks");
-            string assignment2Str = JsonHelper::parseSimpleValue(request, "assignment2Marks");
-            string finalExamStr = JsonHelper::parseSimpleValue(request, "finalExamMarks");
-
-            int lectureHours = lectureHoursStr.empty() ? 0 : stoi(lectureHoursStr);
-            int tutorialHours = tutorialHoursStr.empty() ? 0 : stoi(tutorialHoursStr);
-            int labHours = labHoursStr.empty() ? 0 : stoi(labHoursStr);
-            int practicalHours = practicalHoursStr.empty() ? 0 : stoi(practicalHoursStr);
-            int maxMarks = maxMarksStr.empty() ? 0 : stoi(maxMarksStr);
-            int yearWorkMarks = yearWorkStr.empty() ? 0 : stoi(yearWorkStr);
-            int assignment1Marks = assignment1Str.empty() ? 0 : stoi(assignment1Str);
-            int assignment2Marks = assignment2Str.empty() ? 0 : stoi(assignment2Str);
-            int finalExamMarks = finalExamStr.empty() ? 0 : stoi(finalExamStr);
+            string id = args.getString("id");
+            string code = args.getString("code");
+            string nameEn = args.getString("nameEn");
+            string nameAr = args.getString("nameAr");
+            string description = args.getString("description");
+            string departmentId = args.getString("departmentId");
+            string academicLevelId = args.getString("academicLevelId");
+            string courseTypeId = args.getString("courseTypeId");
+            int semesterNumber = args.getInt("semesterNumber");
+            int creditHours = args.getInt("creditHours");
+
+            int lectureHours = args.getInt("lectureHours", 0);
+            int tutorialHours = args.getInt("tutorialHours", 0);
+            int labHours = args.getInt("labHours", 0);
+            int practicalHours = args.getInt("practicalHours", 0);
+            int maxMarks = args.getInt("maxMarks", 0);
+            int yearWorkMarks = args.getInt("yearWorkMarks", 0);
+            int assignment1Marks = args.getInt("assignment1Marks", 0);
+            int assignment2Marks = args.getInt("assignment2Marks", 0);
+            int finalExamMarks = args.getInt("finalExamMarks", 0);
 
             int derivedMax = yearWorkMarks + assignment1Marks + assignment2Marks + finalExamMarks;
             if (maxMarks <= 0 && derivedMax > 0) {
@@ -2096,41 +2676,33 @@ int main() {
         }
     });
 
-    w.bind("cpp_updateCourse", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateCourse", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_EDIT)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
 
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string code = JsonHelper::parseSimpleValue(request, "code");
-            string nameEn = JsonHelper::parseSimpleValue(request, "nameEn");
-            string nameAr = JsonHelper::parseSimpleValue(request, "nameAr");
-            string description = JsonHelper::parseSimpleValue(request, "description");
-            string departmentId = JsonHelper::parseSimpleValue(request, "departmentId");
-            string academicLevelId = JsonHelper::parseSimpleValue(request, "academicLevelId");
-            string courseTypeId = JsonHelper::parseSimpleValue(request, "courseTypeId");
-            int semesterNumber = stoi(JsonHelper::parseSimpleValue(request, "semesterNumber"));
-            int creditHours = stoi(JsonHelper::parseSimpleValue(request, "creditHours"));
-            string lectureHoursStr = JsonHelper::parseSimpleValue(request, "lectureHours");
-            string tutorialHoursStr = JsonHelper::parseSimpleValue(request, "tutorialHours");
-            string labHoursStr = JsonHelper::parseSimpleValue(request, "labHours");
-            string practicalHoursStr = JsonHelper::parseSimpleValue(request, "practicalHours");
-            string maxMarksStr = JsonHelper::parseSimpleValue(request, "maxMarks");
-            string yearWorkStr = JsonHelper::parseSimpleValue(request, "yearWorkMarks");
-            string assignment1Str = JsonHelper::parseSimpleValue(request, "assignment1Marks");
-            string assignment2Str = JsonHelper::parseSimpleValue(request, "assignment2Marks");
-            string finalExamStr = JsonHelper::parseSimpleValue(request, "finalExamMarks");
-
-            int lectureHours = lectureHoursStr.empty() ? 0 : stoi(lectureHoursStr);
-            int tutorialHours = tutorialHoursStr.empty() ? 0 : stoi(tutorialHoursStr);
-            int labHours = labHoursStr.empty() ? 0 : stoi(labHoursStr);
-            int practicalHours = practicalHoursStr.empty() ? 0 : stoi(practicalHoursStr);
-            int maxMarks = maxMarksStr.empty() ? 0 : stoi(maxMarksStr);
-            int yearWorkMarks = yearWorkStr.empty() ? 0 : stoi(yearWorkStr);
-            int assignment1Marks = assignment1Str.empty() ? 0 : stoi(assignment1Str);
-            int assignment2Marks = assignment2Str.empty() ? 0 : stoi(assignment2Str);
-            int finalExamMarks = finalExamStr.empty() ? 0 : stoi(finalExamStr);
+            string id = args.getString("id");
+            string code = args.getString("code");
+            string nameEn = args.getString("nameEn");
+            string nameAr = args.getString("nameAr");
+            string description = args.getString("description");
+            string departmentId = args.getString("departmentId");
+            string academicLevelId = args.getString("academicLevelId");
+            string courseTypeId = args.getString("courseTypeId");
+            int semesterNumber = args.getInt("semesterNumber");
+            int creditHours = args.getInt("creditHours");
+
+            int lectureHours = args.getInt("lectureHours", 0);
+            int tutorialHours = args.getInt("tutorialHours", 0);
+            int labHours = args.getInt("labHours", 0);
+            int practicalHours = args.getInt("practicalHours", 0);
+            int maxMarks = args.getInt("maxMarks", 0);
+            int yearWorkMarks = args.getInt("yearWorkMarks", 0);
+            int assignment1Marks = args.getInt("assignment1Marks", 0);
+            int assignment2Marks = args.getInt("assignment2Marks", 0);
+            int finalExamMarks = args.getInt("finalExamMarks", 0);
 
             int derivedMax = yearWorkMarks + assignment1Marks + assignment2Marks + finalExamMarks;
             if (maxMarks <= 0 && derivedMax > 0) {
@@ -2191,11 +2763,11 @@ int main() {
             stmt->setString(19, id);
             stmt->executeUpdate();
 
-            auto regStmt = db.prepareStatement("SELECT id FROM registrations WHERE course_id = ?");
-            regStmt->setString(1, id);
-            auto regRes = regStmt->executeQuery();
-            while (regRes->next()) {
-                Grade::calculateGrade(db, regRes->getString("id"));
+            // The mark distribution may have changed: the course's grades are
+            // marked for the recalculator, readers grade them from components meanwhile
+            GradeDistributionCache::instance().invalidateCourse(id);
+            if (Grade::markCourseDirty(db, id) > 0) {
+                GradeRecalculator::instance().notify();
             }
 
             SessionManager::logAction(db, "UPDATE", "courses", id, "Updated course " + code);
@@ -2205,7 +2777,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_deleteCourse", [](const string& request) -> string {
+    bindPooled(w, "cpp_deleteCourse", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::CRS_DELETE)) {
                 return JsonHelper::errorResponse("Permission denied");
@@ -2218,6 +2790,7 @@ int main() {
             auto stmt = db.prepareStatement("DELETE FROM courses WHERE id = ?");
             stmt->setString(1, id);
             int rows = stmt->executeUpdate();
+            GradeDistributionCache::instance().invalidateCourse(id);
 
             if (rows > 0) {
                 SessionManager::logAction(db, "DELETE", "courses", id, "Deleted course");
@@ -2232,7 +2805,7 @@ int main() {
     // ========================================
     // ROLES & PERMISSIONS (Super Admin)
     // ========================================
-    w.bind("cpp_getRoles", [](const string& request) -> string {
+    bindPooled(w, "cpp_getRoles", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::USER_MANAGE)) {
                 return "[]";
@@ -2245,23 +2818,25 @@ int main() {
                 "GROUP BY r.id, r.name_en, r.description "
                 "ORDER BY r.name_en"
             );
-            vector<string> roles;
+            JsonWriter json;
+            json.beginArray();
             while (result->next()) {
-                vector<pair<string, string>> role;
-                role.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                role.push_back({"nameEn", JsonHelper::makeString(result->getString("name_en"))});
-                role.push_back({"nameAr", JsonHelper::makeString("")});
-                role.push_back({"description", JsonHelper::makeString(result->getString("description"))});
-                role.push_back({"userCount", JsonHelper::makeNumber(result->getInt("user_count"))});
-                roles.push_back(JsonHelper::makeObject(role));
-            }
-            return JsonHelper::makeArray(roles);
+                json.beginObject()
+                    .field("id", result->getStringView("id"))
+                    .field("nameEn", result->getStringView("name_en"))
+                    .field("nameAr", "")
+                    .field("description", result->getStringView("description"))
+                    .field("userCount", result->getInt("user_count"))
+                    .endObject();
+            }
+            json.endArray();
+            return json.release();
         } catch (...) {
             return "[]";
         }
     });
 
-    w.bind("cpp_getPermissions", [](const string& request) -> string {
+    bindPooled(w, "cpp_getPermissions", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::USER_MANAGE)) {
                 return "[]";
@@ -2269,49 +2844,55 @@ int main() {
             auto result = db.executeQuery(
                 "SELECT id, name, description FROM permissions ORDER BY name"
             );
-            vector<string> perms;
+            JsonWriter json;
+            json.beginArray();
             while (result->next()) {
-                vector<pair<string, string>> perm;
-                perm.push_back({"id", JsonHelper::makeString(result->getString("id"))});
-                perm.push_back({"name", JsonHelper::makeString(result->getString("name"))});
-                perm.push_back({"description", JsonHelper::makeString(result->getString("description"))});
-                perms.push_back(JsonHelper::makeObject(perm));
-            }
-            return JsonHelper::makeArray(perms);
+                json.beginObject()
+                    .field("id", result->getStringView("id"))
+                    .field("name", result->getStringView("name"))
+                    .field("description", result->getStringView("description"))
+                    .endObject();
+            }
+            json.endArray();
+            return json.release();
         } catch (...) {
             return "[]";
         }
     });
 
-    w.bind("cpp_getRolePermissions", [](const string& request) -> string {
+    bindPooled(w, "cpp_getRolePermissions", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::USER_MANAGE)) {
                 return "[]";
             }
-            string roleId = JsonHelper::parseSimpleValue(request, "roleId");
+            string roleId = args.getString("roleId");
             auto stmt = db.prepareStatement(
                 "SELECT permission_id FROM role_permissions WHERE role_id = ?"
             );
             stmt->setString(1, roleId);
             auto result = stmt->executeQuery();
 
-            vector<string> perms;
+            JsonWriter json;
+            json.beginArray();
             while (result->next()) {
-                perms.push_back(JsonHelper::makeString(result->getString("permission_id")));
+                json.value(result->getStringView("permission_id"));
             }
-            return JsonHelper::makeArray(perms);
+            json.endArray();
+            return json.release();
         } catch (...) {
             return "[]";
         }
     });
 
-    w.bind("cpp_updateRolePermissions", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateRolePermissions", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::USER_MANAGE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string roleId = JsonHelper::parseSimpleValue(request, "roleId");
-            string permissionsCsv = JsonHelper::parseSimpleValue(request, "permissions");
+            string roleId = args.getString("roleId");
+            string permissionsCsv = args.getString("permissions");
 
             vector<string> permissionIds;
             string token;
@@ -2347,14 +2928,11 @@ int main() {
             clearStmt->setString(1, roleId);
             clearStmt->executeUpdate();
 
+            BatchInserter inserts(db, "role_permissions", {"role_id", "permission_id"});
             for (const auto& permId : permissionIds) {
-                auto insertStmt = db.prepareStatement(
-                    "INSERT INTO role_permissions (role_id, permission_id) VALUES (?, ?)"
-                );
-                insertStmt->setString(1, roleId);
-                insertStmt->setString(2, permId);
-                insertStmt->executeUpdate();
+                inserts.addRow({roleId, permId});
             }
+            inserts.finish();
             db.executeUpdate("COMMIT");
 
             SessionManager::logAction(db, "UPDATE", "role_permissions", roleId,
@@ -2366,14 +2944,15 @@ int main() {
         }
     });
 
-    w.bind("cpp_createRole", [](const string& request) -> string {
+    bindPooled(w, "cpp_createRole", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::ROLE_MANAGE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string name = JsonHelper::parseSimpleValue(request, "nameEn");
-            string description = JsonHelper::parseSimpleValue(request, "description");
+            string id = args.getString("id");
+            string name = args.getString("nameEn");
+            string description = args.getString("description");
 
             if (id.empty() || name.empty()) {
                 return JsonHelper::errorResponse("Role ID and name are required");
@@ -2402,14 +2981,15 @@ int main() {
         }
     });
 
-    w.bind("cpp_updateRole", [](const string& request) -> string {
+    bindPooled(w, "cpp_updateRole", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::ROLE_MANAGE)) {
                 return JsonHelper::errorResponse("Permission denied");
             }
-            string id = JsonHelper::parseSimpleValue(request, "id");
-            string name = JsonHelper::parseSimpleValue(request, "nameEn");
-            string description = JsonHelper::parseSimpleValue(request, "description");
+            string id = args.getString("id");
+            string name = args.getString("nameEn");
+            string description = args.getString("description");
 
             if (id.empty() || name.empty()) {
                 return JsonHelper::errorResponse("Role ID and name are required");
@@ -2444,7 +3024,7 @@ int main() {
         }
     });
 
-    w.bind("cpp_deleteRole", [](const string& request) -> string {
+    bindPooled(w, "cpp_deleteRole", [](Database& db, const string& request) -> string {
         try {
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::ROLE_MANAGE)) {
                 return JsonHelper::errorResponse("Permission denied");
@@ -2482,51 +3062,99 @@ int main() {
         }
     });
 
-    w.bind("cpp_getRoleUsers", [](const string& request) -> string {
+    bindPooled(w, "cpp_getRoleUsers", [](Database& db, const string& request) -> string {
         try {
+            JsonRequest args(request);
             if (!SessionManager::isLoggedIn() || !SessionManager::hasPermission(Permissions::USER_MANAGE)) {
                 return "[]";
             }
             
-            string roleId = JsonHelper::parseSimpleValue(request, "roleId");
-            string query = 
-                "SELECT u.id, u.username, u.full_name, u.email, u.phone, "
-                "u.is_active, u.last_login, u.created_at "
-                "FROM users u ";
-            
-            if (!roleId.empty()) {
-                query += "WHERE u.role_id = ? ";
-            }
-            query += "ORDER BY u.full_name";
-            
-            auto stmt = db.prepareStatement(query);
-            if (!roleId.empty()) {
-                stmt->setString(1, roleId);
-            }
-            auto result = stmt->executeQuery();
-            
-            vector<string> users;
-            while (result->next()) {
-                stringstream ss;
-                ss << "{";
-                ss << "\"id\":" << result->getInt("id") << ",";
-                ss << "\"username\":\"" << result->getString("username") << "\",";
-                ss << "\"fullName\":\"" << result->getString("full_name") << "\",";
-                ss << "\"email\":\"" << (result->isNull("email") ? "" : result->getString("email")) << "\",";
-                ss << "\"phone\":\"" << (result->isNull("phone") ? "" : result->getString("phone")) << "\",";
-                ss << "\"isActive\":" << (result->getBoolean("is_active") ? "true" : "false") << ",";
-                ss << "\"lastLogin\":\"" << (result->isNull("last_login") ? "" : result->getString("last_login")) << "\",";
-                ss << "\"createdAt\":\"" << result->getString("created_at") << "\"";
-                ss << "}";
-                users.push_back(ss.str());
-            }
-            return JsonHelper::makeArray(users);
+            ListingQuery listing(
+                "u.id, u.username, u.full_name, u.email, u.phone, "
+                "u.is_active, u.last_login, u.created_at",
+                "users u", "users", {{"u.full_name", "full_name"}, {"u.id", "id"}});
+            listing.whereEquals("u.role_id", args.get("roleId"));
+            string_view status = args.get("status");
+            if (status == "active") {
+                listing.where("u.is_active = TRUE");
+            } else if (status == "inactive") {
+                listing.where("u.is_active = FALSE");
+            }
+            listing.wherePrefix({"u.full_name", "u.username", "u.email"}, args.get("search"));
+            listing.page(args);
+
+            auto result = listing.execute(db);
+            return listing.respond(db, *result, [&](JsonWriter& json) {
+                json.beginObject()
+                    .field("id", result->getInt("id"))
+                    .field("username", result->getStringView("username"))
+                    .field("fullName", result->getStringView("full_name"))
+                    .field("email", result->getStringView("email"))
+                    .field("phone", result->getStringView("phone"))
+                    .field("isActive", result->getBoolean("is_active"))
+                    .field("lastLogin", result->getStringView("last_login"))
+                    .field("createdAt", result->getStringView("created_at"))
+                    .endObject();
+            });
         } catch (const exception& e) {
             cerr << "[RoleUsers] Error: " << e.what() << endl;
             return "[]";
         }
     });
 
+    // ========================================
+    // BATCHED CALLS
+    // ========================================
+    bindBatch(w);
+
+    // ========================================
+    // DIAGNOSTICS
+    // ========================================
+    w.bind("cpp_getQueryStats", [](const string& request) -> string {
+        JsonRequest args(request);
+        if (!SessionManager::getSession()->isSuperAdmin()) {
+            return JsonHelper::errorResponse("Permission denied");
+        }
+        if (args.getBool("reset")) {
+            QueryStats::instance().reset();
+        }
+        return QueryStats::instance().toJson();
+    });
+
+    // Rebuilds the GPA totals and lists rows that drifted; "repair" replaces them
+    bindPooled(w, "cpp_verifyGpaTotals", [](Database& db, const string& request) -> string {
+        try {
+            JsonRequest args(request);
+            if (!SessionManager::isLoggedIn() || !SessionManager::getSession()->isSuperAdmin()) {
+                return JsonHelper::errorResponse("Permission denied");
+            }
+            bool repair = args.getBool("repair");
+            auto mismatches = Grade::verifyGpaTotals(db, repair);
+
+            JsonWriter json;
+            json.beginObject()
+                .field("success", true)
+                .field("repaired", repair && !mismatches.empty())
+                .key("mismatches").beginArray();
+            for (const auto& row : mismatches) {
+                json.beginObject()
+                    .field("studentId", row.studentId)
+                    .field("semesterId", row.semesterId)
+                    .field("storedPoints", row.storedPoints, 2)
+                    .field("expectedPoints", row.expectedPoints, 2)
+                    .field("storedCredits", row.storedCredits)
+                    .field("expectedCredits", row.expectedCredits)
+                    .field("storedDirty", row.storedDirty)
+                    .field("expectedDirty", row.expectedDirty)
+                    .endObject();
+            }
+            json.endArray().endObject();
+            return json.release();
+        } catch (const exception& e) {
+            return JsonHelper::errorResponse(e.what());
+        }
+    });
+
     // ========================================
     // LOAD APPLICATION
     // ========================================
@@ -2539,6 +3167,12 @@ int main() {
 
     w.run();
 
+    // Workers resolve through the webview, so stop them while it still exists
+    bindingExecutor.stop();
+    QueryEventLoop::instance().stop();
+    ChangeFeed::instance().setSink(nullptr);
+    GradeRecalculator::instance().stop();
+
     cout << "[Main] Application closed." << endl;
     return 0;
 }
@@ -0,0 +1,15 @@
+-- ================================================================================
+-- Change tracking for grades
+-- row_version counts component writes; is_dirty marks rows whose total,
+-- percentage, GPA, evaluation and letter grade have not been recomputed yet
+-- Run this to update an existing database
+-- ================================================================================
+
+USE nctu_sis;
+
+ALTER TABLE grades
+    ADD COLUMN row_version INT UNSIGNED NOT NULL DEFAULT 0 AFTER letter_grade,
+    ADD COLUMN is_dirty BOOLEAN NOT NULL DEFAULT FALSE AFTER row_version,
+    ADD INDEX idx_dirty (is_dirty);
+
+SELECT 'Grade change tracking added successfully!' AS status;
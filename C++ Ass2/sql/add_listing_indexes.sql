@@ -0,0 +1,17 @@
+-- ================================================================================
+-- Indexes for the paged listings (students, registrations, fees, users)
+-- Each matches the ORDER BY of its listing, so a page is one index range scan
+-- Run this to update an existing database
+-- ================================================================================
+
+USE nctu_sis;
+
+ALTER TABLE users ADD INDEX idx_full_name (full_name, id);
+
+ALTER TABLE registrations ADD INDEX idx_created (created_at, id);
+
+ALTER TABLE student_fees
+    DROP INDEX idx_academic_year,
+    ADD INDEX idx_academic_year (academic_year, created_at, id);
+
+SELECT 'Listing indexes added successfully!' AS status;
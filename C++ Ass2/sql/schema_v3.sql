@@ -18,6 +18,8 @@ DROP TABLE IF EXISTS permissions;
 DROP TABLE IF EXISTS audit_log;
 DROP TABLE IF EXISTS attendance;
 DROP TABLE IF EXISTS sessions;
+DROP TABLE IF EXISTS student_semester_gpa_totals;
+DROP TABLE IF EXISTS student_gpa_totals;
 DROP TABLE IF EXISTS grades;
 DROP TABLE IF EXISTS registrations;
 DROP TABLE IF EXISTS course_assignments;
@@ -151,7 +153,8 @@ CREATE TABLE users (
     last_login TIMESTAMP NULL,
     created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
     updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
-    FOREIGN KEY (role_id) REFERENCES roles(id)
+    FOREIGN KEY (role_id) REFERENCES roles(id),
+    INDEX idx_full_name (full_name, id)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 CREATE TABLE students (
@@ -217,7 +220,8 @@ CREATE TABLE registrations (
     FOREIGN KEY (course_id) REFERENCES courses(id) ON DELETE CASCADE,
     FOREIGN KEY (semester_id) REFERENCES semesters(id) ON DELETE CASCADE,
     FOREIGN KEY (registered_by) REFERENCES users(id) ON DELETE SET NULL,
-    UNIQUE KEY unique_reg (student_id, course_id, semester_id)
+    UNIQUE KEY unique_reg (student_id, course_id, semester_id),
+    INDEX idx_created (created_at, id)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 CREATE TABLE grades (
@@ -232,12 +236,42 @@ CREATE TABLE grades (
     gpa DECIMAL(3,2) DEFAULT 0,
     evaluation ENUM('Excellent', 'Very Good', 'Good', 'Pass', 'Fail') DEFAULT 'Fail',
     letter_grade VARCHAR(2) DEFAULT 'F',
+    row_version INT UNSIGNED NOT NULL DEFAULT 0,
+    is_dirty BOOLEAN NOT NULL DEFAULT FALSE,
     last_modified_by INT,
     updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+    INDEX idx_dirty (is_dirty),
     FOREIGN KEY (registration_id) REFERENCES registrations(id) ON DELETE CASCADE,
     FOREIGN KEY (last_modified_by) REFERENCES users(id) ON DELETE SET NULL
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
+-- =============================================================
+-- GPA TOTALS
+-- Running quality points (gpa x credit hours) and credit hours
+-- of each student's graded, registered or completed courses,
+-- overall and per semester. Kept current by the triggers below
+-- in the same transaction as the write, so a CGPA is one row.
+-- dirty_grades counts grades whose gpa is not recomputed yet.
+-- =============================================================
+CREATE TABLE student_gpa_totals (
+    student_id VARCHAR(20) PRIMARY KEY,
+    quality_points DECIMAL(12,2) NOT NULL DEFAULT 0,
+    credit_hours INT NOT NULL DEFAULT 0,
+    dirty_grades INT NOT NULL DEFAULT 0,
+    FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
+CREATE TABLE student_semester_gpa_totals (
+    student_id VARCHAR(20) NOT NULL,
+    semester_id VARCHAR(20) NOT NULL,
+    quality_points DECIMAL(12,2) NOT NULL DEFAULT 0,
+    credit_hours INT NOT NULL DEFAULT 0,
+    dirty_grades INT NOT NULL DEFAULT 0,
+    PRIMARY KEY (student_id, semester_id),
+    FOREIGN KEY (student_id) REFERENCES students(id) ON DELETE CASCADE,
+    FOREIGN KEY (semester_id) REFERENCES semesters(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
 -- =============================================================
 -- SESSIONS & ATTENDANCE
 -- =============================================================
@@ -726,7 +760,7 @@ CREATE TABLE student_fees (
     FOREIGN KEY (semester_id) REFERENCES semesters(id),
     UNIQUE KEY unique_student_semester (student_id, semester_id),
     INDEX idx_status (status),
-    INDEX idx_academic_year (academic_year)
+    INDEX idx_academic_year (academic_year, created_at, id)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 -- Fee Payments table
@@ -802,6 +836,214 @@ BEGIN
         END
     WHERE id = NEW.student_fee_id;
 END//
+
+-- GPA totals: every change is applied as a delta to the student's
+-- overall row and semester row. Rows removed by ON DELETE CASCADE do
+-- not fire triggers, so registration, course and semester deletes
+-- subtract their grades before the cascade runs.
+CREATE PROCEDURE adjust_gpa_totals(IN p_student_id VARCHAR(20), IN p_semester_id VARCHAR(20),
+                                   IN p_points DECIMAL(12,2), IN p_credits INT, IN p_dirty INT)
+BEGIN
+    INSERT INTO student_gpa_totals (student_id, quality_points, credit_hours, dirty_grades)
+    VALUES (p_student_id, p_points, p_credits, p_dirty)
+    ON DUPLICATE KEY UPDATE
+        quality_points = quality_points + p_points,
+        credit_hours = credit_hours + p_credits,
+        dirty_grades = dirty_grades + p_dirty;
+
+    INSERT INTO student_semester_gpa_totals
+        (student_id, semester_id, quality_points, credit_hours, dirty_grades)
+    VALUES (p_student_id, p_semester_id, p_points, p_credits, p_dirty)
+    ON DUPLICATE KEY UPDATE
+        quality_points = quality_points + p_points,
+        credit_hours = credit_hours + p_credits,
+        dirty_grades = dirty_grades + p_dirty;
+END//
+
+-- Adds gpa_delta x credit hours, credit_sign x credit hours and
+-- dirty_delta for a grade of registration_id, if it counts
+CREATE PROCEDURE apply_grade_to_gpa_totals(IN p_registration_id INT, IN p_gpa_delta DECIMAL(4,2),
+                                           IN p_credit_sign INT, IN p_dirty_delta INT)
+BEGIN
+    DECLARE v_student_id VARCHAR(20) DEFAULT NULL;
+    DECLARE v_semester_id VARCHAR(20);
+    DECLARE v_credits INT;
+    DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;
+
+    SELECT r.student_id, r.semester_id, c.credit_hours
+    INTO v_student_id, v_semester_id, v_credits
+    FROM registrations r
+    JOIN courses c ON r.course_id = c.id
+    WHERE r.id = p_registration_id AND r.status IN ('registered', 'completed');
+
+    IF v_student_id IS NOT NULL THEN
+        CALL adjust_gpa_totals(v_student_id, v_semester_id, p_gpa_delta * v_credits,
+                               p_credit_sign * v_credits, p_dirty_delta);
+    END IF;
+END//
+
+CREATE TRIGGER after_insert_grade_gpa_totals
+AFTER INSERT ON grades
+FOR EACH ROW
+BEGIN
+    CALL apply_grade_to_gpa_totals(NEW.registration_id, COALESCE(NEW.gpa, 0), 1, NEW.is_dirty);
+END//
+
+CREATE TRIGGER after_update_grade_gpa_totals
+AFTER UPDATE ON grades
+FOR EACH ROW
+BEGIN
+    IF NEW.registration_id <> OLD.registration_id THEN
+        CALL apply_grade_to_gpa_totals(OLD.registration_id, -COALESCE(OLD.gpa, 0), -1, -OLD.is_dirty);
+        CALL apply_grade_to_gpa_totals(NEW.registration_id, COALESCE(NEW.gpa, 0), 1, NEW.is_dirty);
+    ELSEIF NOT (NEW.gpa <=> OLD.gpa) OR NEW.is_dirty <> OLD.is_dirty THEN
+        CALL apply_grade_to_gpa_totals(NEW.registration_id, COALESCE(NEW.gpa, 0) - COALESCE(OLD.gpa, 0),
+                                       0, NEW.is_dirty - OLD.is_dirty);
+    END IF;
+END//
+
+CREATE TRIGGER after_delete_grade_gpa_totals
+AFTER DELETE ON grades
+FOR EACH ROW
+BEGIN
+    CALL apply_grade_to_gpa_totals(OLD.registration_id, -COALESCE(OLD.gpa, 0), -1, -OLD.is_dirty);
+END//
+
+CREATE TRIGGER after_update_registration_gpa_totals
+AFTER UPDATE ON registrations
+FOR EACH ROW
+BEGIN
+    DECLARE v_gpa DECIMAL(3,2) DEFAULT NULL;
+    DECLARE v_dirty INT;
+    DECLARE v_credits INT;
+    DECLARE v_old_counted BOOLEAN;
+    DECLARE v_new_counted BOOLEAN;
+    DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;
+
+    SET v_old_counted = OLD.status IN ('registered', 'completed');
+    SET v_new_counted = NEW.status IN ('registered', 'completed');
+
+    IF (v_old_counted OR v_new_counted)
+       AND (v_old_counted <> v_new_counted OR NEW.student_id <> OLD.student_id
+            OR NEW.semester_id <> OLD.semester_id OR NEW.course_id <> OLD.course_id) THEN
+        SELECT COALESCE(gpa, 0), is_dirty INTO v_gpa, v_dirty
+        FROM grades WHERE registration_id = NEW.id;
+
+        IF v_gpa IS NOT NULL THEN
+            IF v_old_counted THEN
+                SELECT credit_hours INTO v_credits FROM courses WHERE id = OLD.course_id;
+                CALL adjust_gpa_totals(OLD.student_id, OLD.semester_id, -v_gpa * v_credits, -v_credits, -v_dirty);
+            END IF;
+            IF v_new_counted THEN
+                SELECT credit_hours INTO v_credits FROM courses WHERE id = NEW.course_id;
+                CALL adjust_gpa_totals(NEW.student_id, NEW.semester_id, v_gpa * v_credits, v_credits, v_dirty);
+            END IF;
+        END IF;
+    END IF;
+END//
+
+CREATE TRIGGER before_delete_registration_gpa_totals
+BEFORE DELETE ON registrations
+FOR EACH ROW
+BEGIN
+    DECLARE v_gpa DECIMAL(3,2) DEFAULT NULL;
+    DECLARE v_dirty INT;
+    DECLARE v_credits INT;
+    DECLARE CONTINUE HANDLER FOR NOT FOUND BEGIN END;
+
+    IF OLD.status IN ('registered', 'completed') THEN
+        SELECT COALESCE(g.gpa, 0), g.is_dirty, c.credit_hours INTO v_gpa, v_dirty, v_credits
+        FROM grades g
+        JOIN courses c ON c.id = OLD.course_id
+        WHERE g.registration_id = OLD.id;
+
+        IF v_gpa IS NOT NULL THEN
+            CALL adjust_gpa_totals(OLD.student_id, OLD.semester_id, -v_gpa * v_credits, -v_credits, -v_dirty);
+        END IF;
+    END IF;
+END//
+
+-- Credit hours weight every graded registration of the course
+CREATE TRIGGER after_update_course_gpa_totals
+AFTER UPDATE ON courses
+FOR EACH ROW
+BEGIN
+    IF NEW.credit_hours <> OLD.credit_hours THEN
+        INSERT INTO student_gpa_totals (student_id, quality_points, credit_hours, dirty_grades)
+        SELECT r.student_id,
+               SUM(COALESCE(g.gpa, 0)) * (NEW.credit_hours - OLD.credit_hours),
+               COUNT(*) * (NEW.credit_hours - OLD.credit_hours), 0
+        FROM grades g
+        JOIN registrations r ON g.registration_id = r.id
+        WHERE r.course_id = NEW.id AND r.status IN ('registered', 'completed')
+        GROUP BY r.student_id
+        ON DUPLICATE KEY UPDATE
+            quality_points = student_gpa_totals.quality_points + VALUES(quality_points),
+            credit_hours = student_gpa_totals.credit_hours + VALUES(credit_hours);
+
+        INSERT INTO student_semester_gpa_totals
+            (student_id, semester_id, quality_points, credit_hours, dirty_grades)
+        SELECT r.student_id, r.semester_id,
+               SUM(COALESCE(g.gpa, 0)) * (NEW.credit_hours - OLD.credit_hours),
+               COUNT(*) * (NEW.credit_hours - OLD.credit_hours), 0
+        FROM grades g
+        JOIN registrations r ON g.registration_id = r.id
+        WHERE r.course_id = NEW.id AND r.status IN ('registered', 'completed')
+        GROUP BY r.student_id, r.semester_id
+        ON DUPLICATE KEY UPDATE
+            quality_points = student_semester_gpa_totals.quality_points + VALUES(quality_points),
+            credit_hours = student_semester_gpa_totals.credit_hours + VALUES(credit_hours);
+    END IF;
+END//
+
+CREATE TRIGGER before_delete_course_gpa_totals
+BEFORE DELETE ON courses
+FOR EACH ROW
+BEGIN
+    INSERT INTO student_gpa_totals (student_id, quality_points, credit_hours, dirty_grades)
+    SELECT r.student_id, -SUM(COALESCE(g.gpa, 0)) * OLD.credit_hours,
+           -COUNT(*) * OLD.credit_hours, -SUM(g.is_dirty)
+    FROM grades g
+    JOIN registrations r ON g.registration_id = r.id
+    WHERE r.course_id = OLD.id AND r.status IN ('registered', 'completed')
+    GROUP BY r.student_id
+    ON DUPLICATE KEY UPDATE
+        quality_points = student_gpa_totals.quality_points + VALUES(quality_points),
+        credit_hours = student_gpa_totals.credit_hours + VALUES(credit_hours),
+        dirty_grades = student_gpa_totals.dirty_grades + VALUES(dirty_grades);
+
+    INSERT INTO student_semester_gpa_totals
+        (student_id, semester_id, quality_points, credit_hours, dirty_grades)
+    SELECT r.student_id, r.semester_id, -SUM(COALESCE(g.gpa, 0)) * OLD.credit_hours,
+           -COUNT(*) * OLD.credit_hours, -SUM(g.is_dirty)
+    FROM grades g
+    JOIN registrations r ON g.registration_id = r.id
+    WHERE r.course_id = OLD.id AND r.status IN ('registered', 'completed')
+    GROUP BY r.student_id, r.semester_id
+    ON DUPLICATE KEY UPDATE
+        quality_points = student_semester_gpa_totals.quality_points + VALUES(quality_points),
+        credit_hours = student_semester_gpa_totals.credit_hours + VALUES(credit_hours),
+        dirty_grades = student_semester_gpa_totals.dirty_grades + VALUES(dirty_grades);
+END//
+
+-- The semester's own rows go with the cascade; only the overall rows change
+CREATE TRIGGER before_delete_semester_gpa_totals
+BEFORE DELETE ON semesters
+FOR EACH ROW
+BEGIN
+    INSERT INTO student_gpa_totals (student_id, quality_points, credit_hours, dirty_grades)
+    SELECT r.student_id, -SUM(COALESCE(g.gpa, 0) * c.credit_hours),
+           -SUM(c.credit_hours), -SUM(g.is_dirty)
+    FROM grades g
+    JOIN registrations r ON g.registration_id = r.id
+    JOIN courses c ON r.course_id = c.id
+    WHERE r.semester_id = OLD.id AND r.status IN ('registered', 'completed')
+    GROUP BY r.student_id
+    ON DUPLICATE KEY UPDATE
+        quality_points = student_gpa_totals.quality_points + VALUES(quality_points),
+        credit_hours = student_gpa_totals.credit_hours + VALUES(credit_hours),
+        dirty_grades = student_gpa_totals.dirty_grades + VALUES(dirty_grades);
+END//
 DELIMITER ;
 
 SELECT 'Schema v3 created successfully!' AS status;
@@ -5,10 +5,15 @@
  */
 
 #include "../include/Attendance.h"
-#include <sstream>
 
 using namespace std;
 
+// Every attendance column, as the queries below select them
+static const string& attendanceColumns() {
+    static const string columns = EntityFields::selectList(Attendance::fields());
+    return columns;
+}
+
 // ========================================
 // CONSTRUCTORS
 // ========================================
@@ -56,22 +61,11 @@ vector<Attendance> Attendance::getAllAttendance(Database& db) {
 
     try {
         auto result = db.executeQuery(
-            "SELECT id, session_id, student_id, status, remarks, recorded_by, recorded_at "
+            "SELECT " + attendanceColumns() + " "
             "FROM attendance ORDER BY recorded_at DESC"
         );
 
-        while (result->next()) {
-            Attendance att;
-            att.id = result->getString("id");
-            att.sessionId = result->getString("session_id");
-            att.studentId = result->getString("student_id");
-            att.status = result->getString("status");
-            att.remarks = result->getString("remarks");
-            att.recordedBy = result->getString("recorded_by");
-            att.recordedAt = result->getString("recorded_at");
-
-            attendanceList.push_back(att);
-        }
+        attendanceList = EntityFields::readAll<Attendance>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Attendance] Error getting all attendance: " << e.what() << endl;
@@ -85,22 +79,14 @@ Attendance Attendance::getById(Database& db, const string& id) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, session_id, student_id, status, remarks, recorded_by, recorded_at "
+            "SELECT " + attendanceColumns() + " "
             "FROM attendance WHERE id = ?"
         );
         stmt->setString(1, id);
 
         auto result = stmt->executeQuery();
 
-        if (result->next()) {
-            att.id = result->getString("id");
-            att.sessionId = result->getString("session_id");
-            att.studentId = result->getString("student_id");
-            att.status = result->getString("status");
-            att.remarks = result->getString("remarks");
-            att.recordedBy = result->getString("recorded_by");
-            att.recordedAt = result->getString("recorded_at");
-        }
+        att = EntityFields::readFirst<Attendance>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Attendance] Error getting attendance by ID: " << e.what() << endl;
@@ -114,25 +100,14 @@ vector<Attendance> Attendance::getBySessionId(Database& db, const string& sessio
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, session_id, student_id, status, remarks, recorded_by, recorded_at "
+            "SELECT " + attendanceColumns() + " "
             "FROM attendance WHERE session_id = ? ORDER BY student_id"
         );
         stmt->setString(1, sessionId);
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Attendance att;
-            att.id = result->getString("id");
-            att.sessionId = result->getString("session_id");
-            att.studentId = result->getString("student_id");
-            att.status = result->getString("status");
-            att.remarks = result->getString("remarks");
-            att.recordedBy = result->getString("recorded_by");
-            att.recordedAt = result->getString("recorded_at");
-
-            attendanceList.push_back(att);
-        }
+        attendanceList = EntityFields::readAll<Attendance>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Attendance] Error getting attendance by session: " << e.what() << endl;
@@ -146,25 +121,14 @@ vector<Attendance> Attendance::getByStudentId(Database& db, const string& studen
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, session_id, student_id, status, remarks, recorded_by, recorded_at "
+            "SELECT " + attendanceColumns() + " "
             "FROM attendance WHERE student_id = ? ORDER BY recorded_at DESC"
         );
         stmt->setString(1, studentId);
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Attendance att;
-            att.id = result->getString("id");
-            att.sessionId = result->getString("session_id");
-            att.studentId = result->getString("student_id");
-            att.status = result->getString("status");
-            att.remarks = result->getString("remarks");
-            att.recordedBy = result->getString("recorded_by");
-            att.recordedAt = result->getString("recorded_at");
-
-            attendanceList.push_back(att);
-        }
+        attendanceList = EntityFields::readAll<Attendance>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Attendance] Error getting attendance by student: " << e.what() << endl;
@@ -261,17 +225,7 @@ bool Attendance::remove(Database& db) {
 // ========================================
 
 string Attendance::toJson() const {
-    stringstream ss;
-    ss << "{";
-    ss << "\"id\":\"" << id << "\",";
-    ss << "\"sessionId\":\"" << sessionId << "\",";
-    ss << "\"studentId\":\"" << studentId << "\",";
-    ss << "\"status\":\"" << status << "\",";
-    ss << "\"remarks\":\"" << remarks << "\",";
-    ss << "\"recordedBy\":\"" << recordedBy << "\",";
-    ss << "\"recordedAt\":\"" << recordedAt << "\"";
-    ss << "}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 bool Attendance::isEmpty() const {
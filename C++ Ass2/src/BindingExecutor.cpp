@@ -0,0 +1,135 @@
+/*
+ * ============================================
+ * BINDINGEXECUTOR.CPP - Implementation
+ * ============================================
+ */
+
+#include "../include/BindingExecutor.h"
+#include <iostream>
+#include <exception>
+
+using namespace std;
+
+BindingExecutor::BindingExecutor(size_t defaultLimit)
+    : defaultLimit(defaultLimit > 0 ? defaultLimit : 1), running(false) {
+}
+
+BindingExecutor::~BindingExecutor() {
+    stop();
+}
+
+void BindingExecutor::start(size_t workerCount) {
+    lock_guard<mutex> lock(mtx);
+    if (running) {
+        return;
+    }
+    running = true;
+    for (size_t i = 0; i < (workerCount > 0 ? workerCount : 1); i++) {
+        workers.emplace_back(&BindingExecutor::workerLoop, this);
+    }
+}
+
+void BindingExecutor::stop() {
+    vector<thread> joining;
+    {
+        lock_guard<mutex> lock(mtx);
+        if (!running) {
+            return;
+        }
+        running = false;
+        ready.clear();
+        for (auto& entry : lanes) {
+            entry.second.waiting.clear();
+        }
+        joining.swap(workers);
+    }
+    wake.notify_all();
+    for (thread& worker : joining) {
+        worker.join();
+    }
+}
+
+BindingExecutor::Lane& BindingExecutor::laneFor(const string& binding) {
+    auto found = lanes.find(binding);
+    if (found == lanes.end()) {
+        found = lanes.emplace(binding, Lane()).first;
+        found->second.limit = defaultLimit;
+    }
+    return found->second;
+}
+
+void BindingExecutor::setLimit(const string& binding, size_t limit) {
+    lock_guard<mutex> lock(mtx);
+    Lane& lane = laneFor(binding);
+    lane.limit = limit > 0 ? limit : 1;
+    // A raised limit lets waiting calls start now
+    while (!lane.waiting.empty() && lane.running < lane.limit) {
+        lane.running++;
+        ready.push_back({&lane, std::move(lane.waiting.front())});
+        lane.waiting.pop_front();
+        wake.notify_one();
+    }
+}
+
+void BindingExecutor::submit(const string& binding, Task task) {
+    {
+        lock_guard<mutex> lock(mtx);
+        if (running) {
+            Lane& lane = laneFor(binding);
+            if (lane.running < lane.limit) {
+                lane.running++;
+                ready.push_back({&lane, std::move(task)});
+                wake.notify_one();
+            } else {
+                lane.waiting.push_back(std::move(task));
+            }
+            return;
+        }
+    }
+    task();
+}
+
+void BindingExecutor::workerLoop() {
+    unique_lock<mutex> lock(mtx);
+    while (true) {
+        wake.wait(lock, [this] { return !running || !ready.empty(); });
+        if (!running) {
+            return;
+        }
+        ReadyTask next = std::move(ready.front());
+        ready.pop_front();
+
+        lock.unlock();
+        try {
+            next.task();
+        } catch (const exception& e) {
+            cerr << "[Bindings] Handler failed: " << e.what() << endl;
+        } catch (...) {
+            cerr << "[Bindings] Handler failed" << endl;
+        }
+        next.task = nullptr;            // Destroy captures outside the lock
+        lock.lock();
+
+        Lane& lane = *next.lane;
+        lane.running--;
+        if (!lane.waiting.empty() && lane.running < lane.limit) {
+            lane.running++;
+            ready.push_back({&lane, std::move(lane.waiting.front())});
+            lane.waiting.pop_front();
+        }
+    }
+}
+
+size_t BindingExecutor::workerCount() const {
+    lock_guard<mutex> lock(mtx);
+    return workers.size();
+}
+
+size_t BindingExecutor::queuedCount() const {
+    lock_guard<mutex> lock(mtx);
+    size_t count = ready.size();
+    for (const auto& entry : lanes) {
+        count += entry.second.waiting.size();
+    }
+    return count;
+}
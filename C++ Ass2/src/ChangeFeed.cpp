@@ -0,0 +1,42 @@
+/*
+ * ============================================
+ * CHANGEFEED.CPP - Row Change Notifications
+ * ============================================
+ */
+
+#include "../include/ChangeFeed.h"
+#include "../include/JsonWriter.h"
+
+using namespace std;
+
+ChangeFeed& ChangeFeed::instance() {
+    static ChangeFeed feed;
+    return feed;
+}
+
+void ChangeFeed::setSink(Sink newSink) {
+    lock_guard<mutex> lock(mtx);
+    sink = std::move(newSink);
+}
+
+void ChangeFeed::publish(string_view table, string_view op, string_view key, string_view rowJson) {
+    JsonWriter delta(rowJson.size() + 128);
+    delta.beginObject()
+        .field("table", table)
+        .field("op", op)
+        .field("key", key);
+    if (rowJson.empty()) {
+        delta.nullField("row");
+    } else {
+        delta.key("row").raw(rowJson);
+    }
+    delta.endObject();
+
+    // Pages without app.js have no listener
+    string script = "window.handleDataChange && window.handleDataChange(" + delta.str() + ");";
+
+    lock_guard<mutex> lock(mtx);
+    if (sink) {
+        sink(script);
+    }
+}
@@ -5,10 +5,16 @@
  */
 
 #include "../include/College.h"
-#include <sstream>
+#include "../include/ReferenceCache.h"
 
 using namespace std;
 
+// Every college column, as the queries below select them
+static const string& collegeColumns() {
+    static const string columns = EntityFields::selectList(College::fields());
+    return columns;
+}
+
 // Constructors
 College::College() : id(""), name(""), description("") {}
 
@@ -30,15 +36,9 @@ vector<College> College::getAllColleges(Database& db) {
     vector<College> colleges;
     
     try {
-        auto result = db.executeQuery("SELECT id, name, description FROM colleges ORDER BY name");
+        auto result = db.executeQuery("SELECT " + collegeColumns() + " FROM colleges ORDER BY name");
         
-        while (result->next()) {
-            College college;
-            college.id = result->getString("id");
-            college.name = result->getString("name");
-            college.description = result->getString("description");
-            colleges.push_back(college);
-        }
+        colleges = EntityFields::readAll<College>(*result, fields());
     } catch (exception& e) {
         cerr << "[College] Error: " << e.what() << endl;
     }
@@ -50,15 +50,11 @@ College College::getById(Database& db, const string& id) {
     College college;
     
     try {
-        auto stmt = db.prepareStatement("SELECT id, name, description FROM colleges WHERE id = ?");
+        auto stmt = db.prepareStatement("SELECT " + collegeColumns() + " FROM colleges WHERE id = ?");
         stmt->setString(1, id);
         auto result = stmt->executeQuery();
         
-        if (result->next()) {
-            college.id = result->getString("id");
-            college.name = result->getString("name");
-            college.description = result->getString("description");
-        }
+        college = EntityFields::readFirst<College>(*result, fields());
     } catch (exception& e) {
         cerr << "[College] Error: " << e.what() << endl;
     }
@@ -90,6 +86,7 @@ bool College::save(Database& db) {
         stmt->setString(2, name);
         stmt->setString(3, description);
         stmt->executeUpdate();
+        ReferenceCache::instance().invalidate(ReferenceCache::COLLEGES);
         return true;
     } catch (exception& e) {
         cerr << "[College] Error: " << e.what() << endl;
@@ -105,7 +102,9 @@ bool College::update(Database& db) {
         stmt->setString(1, name);
         stmt->setString(2, description);
         stmt->setString(3, id);
-        return stmt->executeUpdate() > 0;
+        bool updated = stmt->executeUpdate() > 0;
+        ReferenceCache::instance().invalidate(ReferenceCache::COLLEGES);
+        return updated;
     } catch (exception& e) {
         cerr << "[College] Error: " << e.what() << endl;
         return false;
@@ -116,7 +115,9 @@ bool College::remove(Database& db) {
     try {
         auto stmt = db.prepareStatement("DELETE FROM colleges WHERE id = ?");
         stmt->setString(1, id);
-        return stmt->executeUpdate() > 0;
+        bool removed = stmt->executeUpdate() > 0;
+        ReferenceCache::instance().invalidate(ReferenceCache::COLLEGES);
+        return removed;
     } catch (exception& e) {
         cerr << "[College] Error: " << e.what() << endl;
         return false;
@@ -124,10 +125,7 @@ bool College::remove(Database& db) {
 }
 
 string College::toJson() const {
-    stringstream ss;
-    ss << "{\"id\":\"" << id << "\",\"name\":\"" << name 
-       << "\",\"description\":\"" << description << "\"}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 bool College::isEmpty() const { return id.empty(); }
@@ -0,0 +1,265 @@
+/*
+ * ============================================
+ * CONNECTIONPOOL.CPP - Implementation
+ * ============================================
+ */
+
+#include "../include/ConnectionPool.h"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+static once_flag mysqlLibraryInit;
+
+// ========================================
+// PooledConnection
+// ========================================
+
+PooledConnection::~PooledConnection() {
+    release();
+}
+
+PooledConnection::PooledConnection(PooledConnection&& other) noexcept
+    : pool(other.pool), conn(std::move(other.conn)) {
+    other.pool = nullptr;
+}
+
+PooledConnection& PooledConnection::operator=(PooledConnection&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        conn = std::move(other.conn);
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+void PooledConnection::release() {
+    if (pool && conn) {
+        pool->giveBack(std::move(conn));
+    }
+    pool = nullptr;
+}
+
+// ========================================
+// ConnectionPool
+// ========================================
+
+ConnectionPool::ConnectionPool(size_t minSize, size_t maxSize, chrono::seconds idleTimeout)
+    : ConnectionPool("localhost", "root", "admin", "nctu_sis", 3306, minSize, maxSize, idleTimeout) {
+}
+
+ConnectionPool::ConnectionPool(const string& host, const string& user,
+                               const string& password, const string& database, int port,
+                               size_t minSize, size_t maxSize, chrono::seconds idleTimeout)
+    : host(host),
+      user(user),
+      password(password),
+      database(database),
+      port(port),
+      minSize(minSize),
+      maxSize(max<size_t>(maxSize, 1)),
+      idleTimeout(idleTimeout),
+      validateAfter(5),
+      waitTimeout(5000),
+      totalCount(0),
+      running(false) {
+    if (this->minSize > this->maxSize) this->minSize = this->maxSize;
+}
+
+ConnectionPool::~ConnectionPool() {
+    shutdown();
+}
+
+/*
+ * openConnection - Opens a new connection (called without the lock held)
+ */
+unique_ptr<Database> ConnectionPool::openConnection() {
+    auto conn = make_unique<Database>(host, user, password, database, port);
+    if (!conn->connect()) {
+        return nullptr;
+    }
+    return conn;
+}
+
+/*
+ * initialize - Opens the minimum number of connections and starts the reaper
+ */
+bool ConnectionPool::initialize() {
+    // mysql_init() is not thread-safe until the library has been initialized
+    call_once(mysqlLibraryInit, []() { mysql_library_init(0, nullptr, nullptr); });
+
+    {
+        lock_guard<mutex> lock(mtx);
+        if (running) return true;
+        running = true;
+    }
+
+    size_t opened = 0;
+    for (size_t i = 0; i < max<size_t>(minSize, 1); i++) {
+        auto conn = openConnection();
+        if (!conn) break;
+        lock_guard<mutex> lock(mtx);
+        idle.push_back({std::move(conn), chrono::steady_clock::now()});
+        totalCount++;
+        opened++;
+    }
+
+    if (opened == 0) {
+        lock_guard<mutex> lock(mtx);
+        running = false;
+        return false;
+    }
+
+    cout << "[ConnectionPool] Opened " << opened << " connection(s), max " << maxSize << endl;
+    reaper = thread(&ConnectionPool::reaperLoop, this);
+    return true;
+}
+
+/*
+ * shutdown - Stops the reaper and closes idle connections
+ * Connections still checked out are closed when their lease ends.
+ */
+void ConnectionPool::shutdown() {
+    deque<IdleConnection> closing;
+    {
+        lock_guard<mutex> lock(mtx);
+        if (!running && !reaper.joinable()) return;
+        running = false;
+        closing.swap(idle);
+        totalCount -= closing.size();
+    }
+    reaperWake.notify_all();
+    available.notify_all();
+    if (reaper.joinable()) {
+        reaper.join();
+    }
+}
+
+/*
+ * acquire - Checks out a connection
+ * Reuses the most recently returned idle connection, pings it if it
+ * has been idle past validateAfter, and opens a new one while below
+ * maxSize. Throws if the pool stays exhausted for waitTimeout.
+ */
+PooledConnection ConnectionPool::acquire() {
+    unique_lock<mutex> lock(mtx);
+    auto deadline = chrono::steady_clock::now() + waitTimeout;
+
+    while (true) {
+        if (!running) {
+            throw runtime_error("Connection pool is not running");
+        }
+
+        if (!idle.empty()) {
+            IdleConnection entry = std::move(idle.back());
+            idle.pop_back();
+            lock.unlock();
+
+            bool stale = chrono::steady_clock::now() - entry.since >= validateAfter;
+            if (!stale || entry.conn->ping()) {
+                return PooledConnection(this, std::move(entry.conn));
+            }
+
+            // Server closed the connection (wait_timeout, restart...) - replace it
+            cerr << "[ConnectionPool] Dropping dead connection" << endl;
+            entry.conn.reset();
+            auto fresh = openConnection();
+            if (fresh) {
+                return PooledConnection(this, std::move(fresh));
+            }
+            lock.lock();
+            totalCount--;
+            available.notify_one();
+            throw runtime_error("Failed to open database connection");
+        }
+
+        if (totalCount < maxSize) {
+            totalCount++;
+            lock.unlock();
+            auto fresh = openConnection();
+            if (fresh) {
+                return PooledConnection(this, std::move(fresh));
+            }
+            lock.lock();
+            totalCount--;
+            available.notify_one();
+            throw runtime_error("Failed to open database connection");
+        }
+
+        if (available.wait_until(lock, deadline) == cv_status::timeout &&
+            idle.empty() && totalCount >= maxSize) {
+            throw runtime_error("Connection pool exhausted");
+        }
+    }
+}
+
+/*
+ * giveBack - Returns a connection from a lease
+ */
+void ConnectionPool::giveBack(unique_ptr<Database> conn) {
+    unique_lock<mutex> lock(mtx);
+    if (!running || !conn->isConnected()) {
+        totalCount--;
+        lock.unlock();
+        conn.reset();
+        available.notify_one();
+        return;
+    }
+    idle.push_back({std::move(conn), chrono::steady_clock::now()});
+    lock.unlock();
+    available.notify_one();
+}
+
+/*
+ * reapIdle - Closes surplus connections that have been idle too long
+ * The oldest idle connections sit at the front of the queue.
+ */
+void ConnectionPool::reapIdle() {
+    vector<unique_ptr<Database>> closing;
+    {
+        lock_guard<mutex> lock(mtx);
+        auto now = chrono::steady_clock::now();
+        while (!idle.empty() && totalCount > minSize &&
+               now - idle.front().since >= idleTimeout) {
+            closing.push_back(std::move(idle.front().conn));
+            idle.pop_front();
+            totalCount--;
+        }
+    }
+    // mysql_close() happens here, outside the lock
+    closing.clear();
+}
+
+void ConnectionPool::reaperLoop() {
+    auto interval = max<chrono::seconds>(idleTimeout / 2, chrono::seconds(1));
+    unique_lock<mutex> lock(mtx);
+    while (running) {
+        reaperWake.wait_for(lock, interval);
+        if (!running) break;
+        lock.unlock();
+        reapIdle();
+        lock.lock();
+    }
+}
+
+void ConnectionPool::setWaitTimeout(chrono::milliseconds timeout) {
+    lock_guard<mutex> lock(mtx);
+    waitTimeout = timeout;
+}
+
+void ConnectionPool::setValidateAfter(chrono::seconds interval) {
+    lock_guard<mutex> lock(mtx);
+    validateAfter = interval;
+}
+
+size_t ConnectionPool::size() const {
+    lock_guard<mutex> lock(mtx);
+    return totalCount;
+}
+
+size_t ConnectionPool::idleCount() const {
+    lock_guard<mutex> lock(mtx);
+    return idle.size();
+}
@@ -5,7 +5,7 @@
  */
 
 #include "../include/Course.h"
-#include <sstream>
+#include "../include/GradeDistributionCache.h"
 
 using namespace std;
 
@@ -86,6 +86,15 @@ void Course::setAssignment2Marks(int assignment2Marks) { this->assignment2Marks
 void Course::setYearWorkMarks(int yearWorkMarks) { this->yearWorkMarks = yearWorkMarks; }
 void Course::setFinalExamMarks(int finalExamMarks) { this->finalExamMarks = finalExamMarks; }
 
+// ========================================
+// SELECT LIST
+// ========================================
+
+static const string& courseColumns() {
+    static const string columns = EntityFields::selectList(Course::fields());
+    return columns;
+}
+
 // ========================================
 // STATIC DATABASE OPERATIONS
 // ========================================
@@ -95,37 +104,11 @@ vector<Course> Course::getAllCourses(Database& db) {
 
     try {
         auto result = db.executeQuery(
-            "SELECT id, code, name_en, name_ar, description, department_id, "
-            "academic_level_id, semester_number, course_type_id, credit_hours, "
-            "lecture_hours, tutorial_hours, lab_hours, practical_hours, max_marks, "
-            "assignment1_marks, assignment2_marks, year_work_marks, final_exam_marks "
+            "SELECT " + courseColumns() + " "
             "FROM courses ORDER BY code"
         );
 
-        while (result->next()) {
-            Course course;
-            course.id = result->getString("id");
-            course.code = result->getString("code");
-            course.nameEn = result->getString("name_en");
-            course.nameAr = result->getString("name_ar");
-            course.description = result->getString("description");
-            course.departmentId = result->getString("department_id");
-            course.academicLevelId = result->getString("academic_level_id");
-            course.semesterNumber = result->getInt("semester_number");
-            course.courseTypeId = result->getString("course_type_id");
-            course.creditHours = result->getInt("credit_hours");
-            course.lectureHours = result->getInt("lecture_hours");
-            course.tutorialHours = result->getInt("tutorial_hours");
-            course.labHours = result->getInt("lab_hours");
-            course.practicalHours = result->getInt("practical_hours");
-            course.maxMarks = result->getInt("max_marks");
-            course.assignment1Marks = result->getInt("assignment1_marks");
-            course.assignment2Marks = result->getInt("assignment2_marks");
-            course.yearWorkMarks = result->getInt("year_work_marks");
-            course.finalExamMarks = result->getInt("final_exam_marks");
-
-            courses.push_back(course);
-        }
+        courses = EntityFields::readAll<Course>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Course] Error getting all courses: " << e.what() << endl;
@@ -139,37 +122,14 @@ Course Course::getById(Database& db, const string& id) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, code, name_en, name_ar, description, department_id, "
-            "academic_level_id, semester_number, course_type_id, credit_hours, "
-            "lecture_hours, tutorial_hours, lab_hours, practical_hours, max_marks, "
-            "assignment1_marks, assignment2_marks, year_work_marks, final_exam_marks "
+            "SELECT " + courseColumns() + " "
             "FROM courses WHERE id = ?"
         );
         stmt->setString(1, id);
 
         auto result = stmt->executeQuery();
 
-        if (result->next()) {
-            course.id = result->getString("id");
-            course.code = result->getString("code");
-            course.nameEn = result->getString("name_en");
-            course.nameAr = result->getString("name_ar");
-            course.description = result->getString("description");
-            course.departmentId = result->getString("department_id");
-            course.academicLevelId = result->getString("academic_level_id");
-            course.semesterNumber = result->getInt("semester_number");
-            course.courseTypeId = result->getString("course_type_id");
-            course.creditHours = result->getInt("credit_hours");
-            course.lectureHours = result->getInt("lecture_hours");
-            course.tutorialHours = result->getInt("tutorial_hours");
-            course.labHours = result->getInt("lab_hours");
-            course.practicalHours = result->getInt("practical_hours");
-            course.maxMarks = result->getInt("max_marks");
-            course.assignment1Marks = result->getInt("assignment1_marks");
-            course.assignment2Marks = result->getInt("assignment2_marks");
-            course.yearWorkMarks = result->getInt("year_work_marks");
-            course.finalExamMarks = result->getInt("final_exam_marks");
-        }
+        course = EntityFields::readFirst<Course>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Course] Error getting course by ID: " << e.what() << endl;
@@ -183,37 +143,14 @@ Course Course::getByCode(Database& db, const string& code) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, code, name_en, name_ar, description, department_id, "
-            "academic_level_id, semester_number, course_type_id, credit_hours, "
-            "lecture_hours, tutorial_hours, lab_hours, practical_hours, max_marks, "
-            "assignment1_marks, assignment2_marks, year_work_marks, final_exam_marks "
+            "SELECT " + courseColumns() + " "
             "FROM courses WHERE code = ?"
         );
         stmt->setString(1, code);
 
         auto result = stmt->executeQuery();
 
-        if (result->next()) {
-            course.id = result->getString("id");
-            course.code = result->getString("code");
-            course.nameEn = result->getString("name_en");
-            course.nameAr = result->getString("name_ar");
-            course.description = result->getString("description");
-            course.departmentId = result->getString("department_id");
-            course.academicLevelId = result->getString("academic_level_id");
-            course.semesterNumber = result->getInt("semester_number");
-            course.courseTypeId = result->getString("course_type_id");
-            course.creditHours = result->getInt("credit_hours");
-            course.lectureHours = result->getInt("lecture_hours");
-            course.tutorialHours = result->getInt("tutorial_hours");
-            course.labHours = result->getInt("lab_hours");
-            course.practicalHours = result->getInt("practical_hours");
-            course.maxMarks = result->getInt("max_marks");
-            course.assignment1Marks = result->getInt("assignment1_marks");
-            course.assignment2Marks = result->getInt("assignment2_marks");
-            course.yearWorkMarks = result->getInt("year_work_marks");
-            course.finalExamMarks = result->getInt("final_exam_marks");
-        }
+        course = EntityFields::readFirst<Course>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Course] Error getting course by code: " << e.what() << endl;
@@ -263,40 +200,14 @@ vector<Course> Course::getByDepartment(Database& db, const string& departmentId)
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, code, name_en, name_ar, description, department_id, "
-            "academic_level_id, semester_number, course_type_id, credit_hours, "
-            "lecture_hours, tutorial_hours, lab_hours, practical_hours, max_marks, "
-            "assignment1_marks, assignment2_marks, year_work_marks, final_exam_marks "
+            "SELECT " + courseColumns() + " "
             "FROM courses WHERE department_id = ? ORDER BY code"
         );
         stmt->setString(1, departmentId);
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Course course;
-            course.id = result->getString("id");
-            course.code = result->getString("code");
-            course.nameEn = result->getString("name_en");
-            course.nameAr = result->getString("name_ar");
-            course.description = result->getString("description");
-            course.departmentId = result->getString("department_id");
-            course.academicLevelId = result->getString("academic_level_id");
-            course.semesterNumber = result->getInt("semester_number");
-            course.courseTypeId = result->getString("course_type_id");
-            course.creditHours = result->getInt("credit_hours");
-            course.lectureHours = result->getInt("lecture_hours");
-            course.tutorialHours = result->getInt("tutorial_hours");
-            course.labHours = result->getInt("lab_hours");
-            course.practicalHours = result->getInt("practical_hours");
-            course.maxMarks = result->getInt("max_marks");
-            course.assignment1Marks = result->getInt("assignment1_marks");
-            course.assignment2Marks = result->getInt("assignment2_marks");
-            course.yearWorkMarks = result->getInt("year_work_marks");
-            course.finalExamMarks = result->getInt("final_exam_marks");
-
-            courses.push_back(course);
-        }
+        courses = EntityFields::readAll<Course>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Course] Error getting courses by department: " << e.what() << endl;
@@ -310,40 +221,14 @@ vector<Course> Course::getByAcademicLevel(Database& db, const string& levelId) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, code, name_en, name_ar, description, department_id, "
-            "academic_level_id, semester_number, course_type_id, credit_hours, "
-            "lecture_hours, tutorial_hours, lab_hours, practical_hours, max_marks, "
-            "assignment1_marks, assignment2_marks, year_work_marks, final_exam_marks "
+            "SELECT " + courseColumns() + " "
             "FROM courses WHERE academic_level_id = ? ORDER BY code"
         );
         stmt->setString(1, levelId);
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Course course;
-            course.id = result->getString("id");
-            course.code = result->getString("code");
-            course.nameEn = result->getString("name_en");
-            course.nameAr = result->getString("name_ar");
-            course.description = result->getString("description");
-            course.departmentId = result->getString("department_id");
-            course.academicLevelId = result->getString("academic_level_id");
-            course.semesterNumber = result->getInt("semester_number");
-            course.courseTypeId = result->getString("course_type_id");
-            course.creditHours = result->getInt("credit_hours");
-            course.lectureHours = result->getInt("lecture_hours");
-            course.tutorialHours = result->getInt("tutorial_hours");
-            course.labHours = result->getInt("lab_hours");
-            course.practicalHours = result->getInt("practical_hours");
-            course.maxMarks = result->getInt("max_marks");
-            course.assignment1Marks = result->getInt("assignment1_marks");
-            course.assignment2Marks = result->getInt("assignment2_marks");
-            course.yearWorkMarks = result->getInt("year_work_marks");
-            course.finalExamMarks = result->getInt("final_exam_marks");
-
-            courses.push_back(course);
-        }
+        courses = EntityFields::readAll<Course>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Course] Error getting courses by academic level: " << e.what() << endl;
@@ -429,6 +314,7 @@ bool Course::update(Database& db) {
         stmt->setString(19, id);
 
         int rowsAffected = stmt->executeUpdate();
+        GradeDistributionCache::instance().invalidateCourse(id);
         return rowsAffected >= 0;
 
     } catch (exception& e) {
@@ -442,6 +328,7 @@ bool Course::remove(Database& db) {
         auto stmt = db.prepareStatement("DELETE FROM courses WHERE id = ?");
         stmt->setString(1, id);
         int rowsAffected = stmt->executeUpdate();
+        GradeDistributionCache::instance().invalidateCourse(id);
         return rowsAffected > 0;
 
     } catch (exception& e) {
@@ -455,29 +342,7 @@ bool Course::remove(Database& db) {
 // ========================================
 
 string Course::toJson() const {
-    stringstream ss;
-    ss << "{";
-    ss << "\"id\":\"" << id << "\",";
-    ss << "\"code\":\"" << code << "\",";
-    ss << "\"nameEn\":\"" << nameEn << "\",";
-    ss << "\"nameAr\":\"" << nameAr << "\",";
-    ss << "\"description\":\"" << description << "\",";
-    ss << "\"departmentId\":\"" << departmentId << "\",";
-    ss << "\"academicLevelId\":\"" << academicLevelId << "\",";
-    ss << "\"semesterNumber\":" << semesterNumber << ",";
-    ss << "\"courseTypeId\":\"" << courseTypeId << "\",";
-    ss << "\"creditHours\":" << creditHours << ",";
-    ss << "\"lectureHours\":" << lectureHours << ",";
-    ss << "\"tutorialHours\":" << tutorialHours << ",";
-    ss << "\"labHours\":" << labHours << ",";
-    ss << "\"practicalHours\":" << practicalHours << ",";
-    ss << "\"maxMarks\":" << maxMarks << ",";
-    ss << "\"assignment1Marks\":" << assignment1Marks << ",";
-    ss << "\"assignment2Marks\":" << assignment2Marks << ",";
-    ss << "\"yearWorkMarks\":" << yearWorkMarks << ",";
-    ss << "\"finalExamMarks\":" << finalExamMarks;
-    ss << "}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 bool Course::isEmpty() const {
@@ -5,8 +5,13 @@
  */
 
 #include "../include/Grade.h"
+#include "../include/GradeKernel.h"
+#include "../include/GradeDistributionCache.h"
+#include "../include/GradeRecalculator.h"
 #include <sstream>
 #include <iomanip>
+#include <map>
+#include <cmath>
 
 using namespace std;
 
@@ -58,36 +63,63 @@ void Grade::setFinalExam(double finalExam) { this->finalExam = finalExam; }
 // ========================================
 
 string Grade::getEvaluationFromPercentage(double percentage) {
-    if (percentage >= 85) return "Excellent";
-    if (percentage >= 75) return "Very Good";
-    if (percentage >= 65) return "Good";
-    if (percentage >= 60) return "Pass";
-    return "Fail";
+    return GradeKernel::EVALUATION[GradeKernel::bandOf(percentage)];
 }
 
 double Grade::getGpaFromPercentage(double percentage) {
-    if (percentage >= 85) return 4.0;
-    if (percentage >= 75) return 3.0;
-    if (percentage >= 65) return 2.0;
-    if (percentage >= 60) return 1.0;
-    return 0.0;
+    return GradeKernel::GPA[GradeKernel::bandOf(percentage)];
 }
 
 string Grade::getLetterGrade(double percentage) {
-    if (percentage >= 85) return "A";
-    if (percentage >= 75) return "B";
-    if (percentage >= 65) return "C";
-    if (percentage >= 60) return "D";
-    return "F";
+    return GradeKernel::LETTER[GradeKernel::bandOf(percentage)];
+}
+
+Grade::GradedRows Grade::gradeRows(ResultSet& result) {
+    enum { ASSIGNMENT1, ASSIGNMENT2, YEAR_WORK, FINAL_EXAM, MAX_MARKS, IS_DIRTY };
+    static const string_view columns[] = {
+        "assignment1", "assignment2", "year_work", "final_exam", "max_marks", "is_dirty"
+    };
+    auto col = result.resolveColumns(columns);
+
+    GradedRows rows;
+    while (result.next()) {
+        rows.assignment1.push_back(result.getDouble(col[ASSIGNMENT1]));
+        rows.assignment2.push_back(result.getDouble(col[ASSIGNMENT2]));
+        rows.yearWork.push_back(result.getDouble(col[YEAR_WORK]));
+        rows.finalExam.push_back(result.getDouble(col[FINAL_EXAM]));
+        rows.maxMarks.push_back(result.getDouble(col[MAX_MARKS]));
+        bool dirty = result.getBoolean(col[IS_DIRTY]);
+        rows.dirty.push_back(dirty);
+        rows.anyDirty = rows.anyDirty || dirty;
+    }
+    result.rewind();
+
+    size_t count = rows.dirty.size();
+    rows.total.resize(count);
+    rows.percentage.resize(count);
+    rows.gpa.resize(count);
+    rows.band.resize(count);
+    if (rows.anyDirty) {
+        GradeKernel::compute({rows.assignment1.data(), rows.assignment2.data(), rows.yearWork.data(),
+                              rows.finalExam.data(), rows.maxMarks.data(), count},
+                             {rows.total.data(), rows.percentage.data(), rows.gpa.data(), rows.band.data()});
+    }
+    return rows;
 }
 
 Grade::GradeDistribution Grade::getDistributionForRegistration(Database& db,
                                                                 const string& registrationId) {
     GradeDistribution dist{0.0, 0.0, 0.0, 0.0, 0.0};
+    GradeDistributionCache& cache = GradeDistributionCache::instance();
+    if (cache.find(registrationId, dist)) {
+        return dist;
+    }
 
     try {
+        uint64_t generation = cache.currentGeneration();
         auto stmt = db.prepareStatement(
-            "SELECT c.max_marks, c.assignment1_marks, c.assignment2_marks, c.year_work_marks, c.final_exam_marks "
+            "SELECT r.course_id, r.semester_id, c.max_marks, c.assignment1_marks, c.assignment2_marks, "
+            "c.year_work_marks, c.final_exam_marks "
             "FROM courses c "
             "JOIN registrations r ON r.course_id = c.id "
             "WHERE r.id = ?"
@@ -95,14 +127,9 @@ Grade::GradeDistribution Grade::getDistributionForRegistration(Database& db,
         stmt->setString(1, registrationId);
         auto result = stmt->executeQuery();
         if (result->next()) {
-            dist.assignment1Max = result->getDouble("assignment1_marks");
-            dist.assignment2Max = result->getDouble("assignment2_marks");
-            dist.yearWorkMax = result->getDouble("year_work_marks");
-            dist.finalExamMax = result->getDouble("final_exam_marks");
-            dist.totalMax = result->getDouble("max_marks");
-            if (dist.totalMax <= 0) {
-                dist.totalMax = dist.assignment1Max + dist.assignment2Max + dist.yearWorkMax + dist.finalExamMax;
-            }
+            dist = readDistribution(*result);
+            cache.store(result->getString("course_id"), result->getString("semester_id"), dist,
+                        {registrationId}, generation);
         }
     } catch (const exception& e) {
         cerr << "[Grade] Error loading distribution: " << e.what() << endl;
@@ -111,6 +138,19 @@ Grade::GradeDistribution Grade::getDistributionForRegistration(Database& db,
     return dist;
 }
 
+Grade::GradeDistribution Grade::readDistribution(ResultSet& row) {
+    GradeDistribution dist;
+    dist.assignment1Max = row.getDouble("assignment1_marks");
+    dist.assignment2Max = row.getDouble("assignment2_marks");
+    dist.yearWorkMax = row.getDouble("year_work_marks");
+    dist.finalExamMax = row.getDouble("final_exam_marks");
+    dist.totalMax = row.getDouble("max_marks");
+    if (dist.totalMax <= 0) {
+        dist.totalMax = dist.assignment1Max + dist.assignment2Max + dist.yearWorkMax + dist.finalExamMax;
+    }
+    return dist;
+}
+
 // ========================================
 // VALIDATION
 // ========================================
@@ -118,43 +158,61 @@ Grade::GradeDistribution Grade::getDistributionForRegistration(Database& db,
 string Grade::validateGradeComponent(Database& db, const string& registrationId,
                                      const string& component, double value) {
     try {
-        GradeDistribution dist = getDistributionForRegistration(db, registrationId);
-
-        double maxValue = 0;
-        string componentName;
-
-        if (component == "assignment1") {
-            maxValue = dist.assignment1Max;
-            componentName = "Assignment 1";
-        } else if (component == "assignment2") {
-            maxValue = dist.assignment2Max;
-            componentName = "Assignment 2";
-        } else if (component == "year_work") {
-            maxValue = dist.yearWorkMax;
-            componentName = "Year Work";
-        } else if (component == "final_exam") {
-            maxValue = dist.finalExamMax;
-            componentName = "Final Exam";
-        } else {
-            return "Invalid grade component";
-        }
-
-        if (value < 0) {
-            return componentName + " cannot be negative";
-        }
-        if (value > maxValue) {
-            stringstream ss;
-            ss << componentName << " cannot exceed " << fixed << setprecision(1) << maxValue;
-            return ss.str();
-        }
-
-        return "";
+        return validateGradeComponent(getDistributionForRegistration(db, registrationId), component, value);
 
     } catch (const exception& e) {
         return string("Validation error: ") + e.what();
     }
 }
 
+string Grade::validateGradeComponent(const GradeDistribution& dist, const string& component,
+                                     double value) {
+    double maxValue = 0;
+    string componentName;
+
+    if (component == "assignment1") {
+        maxValue = dist.assignment1Max;
+        componentName = "Assignment 1";
+    } else if (component == "assignment2") {
+        maxValue = dist.assignment2Max;
+        componentName = "Assignment 2";
+    } else if (component == "year_work") {
+        maxValue = dist.yearWorkMax;
+        componentName = "Year Work";
+    } else if (component == "final_exam") {
+        maxValue = dist.finalExamMax;
+        componentName = "Final Exam";
+    } else {
+        return "Invalid grade component";
+    }
+
+    if (value < 0) {
+        return componentName + " cannot be negative";
+    }
+    if (value > maxValue) {
+        stringstream ss;
+        ss << componentName << " cannot exceed " << fixed << setprecision(1) << maxValue;
+        return ss.str();
+    }
+
+    return "";
+}
+
+// ========================================
+// SELECT LISTS
+// ========================================
+
+// Every grade column, unqualified and qualified for queries joining registrations
+static const string& gradeColumns() {
+    static const string columns = EntityFields::selectList(Grade::fields());
+    return columns;
+}
+
+static const string& qualifiedGradeColumns() {
+    static const string columns = EntityFields::selectList(Grade::fields(), "g.");
+    return columns;
+}
+
 // ========================================
 // STATIC DATABASE OPERATIONS
 // ========================================
@@ -164,27 +222,11 @@ vector<Grade> Grade::getAllGrades(Database& db) {
 
     try {
         auto result = db.executeQuery(
-            "SELECT id, registration_id, assignment1, assignment2, year_work, final_exam, "
-            "total_marks, percentage, gpa, evaluation, letter_grade "
+            "SELECT " + gradeColumns() + " "
             "FROM grades ORDER BY id"
         );
 
-        while (result->next()) {
-            Grade grade;
-            grade.id = result->getString("id");
-            grade.registrationId = result->getString("registration_id");
-            grade.assignment1 = result->getDouble("assignment1");
-            grade.assignment2 = result->getDouble("assignment2");
-            grade.yearWork = result->getDouble("year_work");
-            grade.finalExam = result->getDouble("final_exam");
-            grade.total = result->getDouble("total_marks");
-            grade.percentage = result->getDouble("percentage");
-            grade.gpa = result->getDouble("gpa");
-            grade.evaluation = result->getString("evaluation");
-            grade.letterGrade = result->getString("letter_grade");
-
-            grades.push_back(grade);
-        }
+        grades = EntityFields::readAll<Grade>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Grade] Error getting all grades: " << e.what() << endl;
@@ -198,27 +240,14 @@ Grade Grade::getById(Database& db, const string& id) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, registration_id, assignment1, assignment2, year_work, final_exam, "
-            "total_marks, percentage, gpa, evaluation, letter_grade "
+            "SELECT " + gradeColumns() + " "
             "FROM grades WHERE id = ?"
         );
         stmt->setString(1, id);
 
         auto result = stmt->executeQuery();
 
-        if (result->next()) {
-            grade.id = result->getString("id");
-            grade.registrationId = result->getString("registration_id");
-            grade.assignment1 = result->getDouble("assignment1");
-            grade.assignment2 = result->getDouble("assignment2");
-            grade.yearWork = result->getDouble("year_work");
-            grade.finalExam = result->getDouble("final_exam");
-            grade.total = result->getDouble("total_marks");
-            grade.percentage = result->getDouble("percentage");
-            grade.gpa = result->getDouble("gpa");
-            grade.evaluation = result->getString("evaluation");
-            grade.letterGrade = result->getString("letter_grade");
-        }
+        grade = EntityFields::readFirst<Grade>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Grade] Error getting grade by ID: " << e.what() << endl;
@@ -232,27 +261,14 @@ Grade Grade::getByRegistrationId(Database& db, const string& registrationId) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, registration_id, assignment1, assignment2, year_work, final_exam, "
-            "total_marks, percentage, gpa, evaluation, letter_grade "
+            "SELECT " + gradeColumns() + " "
             "FROM grades WHERE registration_id = ?"
         );
         stmt->setString(1, registrationId);
 
         auto result = stmt->executeQuery();
 
-        if (result->next()) {
-            grade.id = result->getString("id");
-            grade.registrationId = result->getString("registration_id");
-            grade.assignment1 = result->getDouble("assignment1");
-            grade.assignment2 = result->getDouble("assignment2");
-            grade.yearWork = result->getDouble("year_work");
-            grade.finalExam = result->getDouble("final_exam");
-            grade.total = result->getDouble("total_marks");
-            grade.percentage = result->getDouble("percentage");
-            grade.gpa = result->getDouble("gpa");
-            grade.evaluation = result->getString("evaluation");
-            grade.letterGrade = result->getString("letter_grade");
-        }
+        grade = EntityFields::readFirst<Grade>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Grade] Error getting grade by registration: " << e.what() << endl;
@@ -266,8 +282,7 @@ vector<Grade> Grade::getByStudentId(Database& db, const string& studentId) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT g.id, g.registration_id, g.assignment1, g.assignment2, g.year_work, g.final_exam, "
-            "g.total_marks, g.percentage, g.gpa, g.evaluation, g.letter_grade "
+            "SELECT " + qualifiedGradeColumns() + " "
             "FROM grades g "
             "JOIN registrations r ON g.registration_id = r.id "
             "WHERE r.student_id = ?"
@@ -275,22 +290,7 @@ vector<Grade> Grade::getByStudentId(Database& db, const string& studentId) {
         stmt->setString(1, studentId);
 
         auto result = stmt->executeQuery();
-        while (result->next()) {
-            Grade grade;
-            grade.id = result->getString("id");
-            grade.registrationId = result->getString("registration_id");
-            grade.assignment1 = result->getDouble("assignment1");
-            grade.assignment2 = result->getDouble("assignment2");
-            grade.yearWork = result->getDouble("year_work");
-            grade.finalExam = result->getDouble("final_exam");
-            grade.total = result->getDouble("total_marks");
-            grade.percentage = result->getDouble("percentage");
-            grade.gpa = result->getDouble("gpa");
-            grade.evaluation = result->getString("evaluation");
-            grade.letterGrade = result->getString("letter_grade");
-
-            grades.push_back(grade);
-        }
+        grades = EntityFields::readAll<Grade>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Grade] Error getting grades by student: " << e.what() << endl;
@@ -305,8 +305,7 @@ vector<Grade> Grade::getByCourseId(Database& db, const string& courseId,
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT g.id, g.registration_id, g.assignment1, g.assignment2, g.year_work, g.final_exam, "
-            "g.total_marks, g.percentage, g.gpa, g.evaluation, g.letter_grade "
+            "SELECT " + qualifiedGradeColumns() + " "
             "FROM grades g "
             "JOIN registrations r ON g.registration_id = r.id "
             "WHERE r.course_id = ? AND r.semester_id = ?"
@@ -315,22 +314,7 @@ vector<Grade> Grade::getByCourseId(Database& db, const string& courseId,
         stmt->setString(2, semesterId);
 
         auto result = stmt->executeQuery();
-        while (result->next()) {
-            Grade grade;
-            grade.id = result->getString("id");
-            grade.registrationId = result->getString("registration_id");
-            grade.assignment1 = result->getDouble("assignment1");
-            grade.assignment2 = result->getDouble("assignment2");
-            grade.yearWork = result->getDouble("year_work");
-            grade.finalExam = result->getDouble("final_exam");
-            grade.total = result->getDouble("total_marks");
-            grade.percentage = result->getDouble("percentage");
-            grade.gpa = result->getDouble("gpa");
-            grade.evaluation = result->getString("evaluation");
-            grade.letterGrade = result->getString("letter_grade");
-
-            grades.push_back(grade);
-        }
+        grades = EntityFields::readAll<Grade>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Grade] Error getting grades by course: " << e.what() << endl;
@@ -339,47 +323,50 @@ vector<Grade> Grade::getByCourseId(Database& db, const string& courseId,
     return grades;
 }
 
+// UPDATE grades g JOIN registrations r JOIN courses c SET <every derived column>.
+// Each column is computed from the components and c.max_marks only, since
+// MySQL does not order the assignments of a multi-table UPDATE.
+static const string& recalculateStatement() {
+    static const string statement = [] {
+        const string total =
+            "(COALESCE(g.assignment1, 0) + COALESCE(g.assignment2, 0) + "
+            "COALESCE(g.year_work, 0) + COALESCE(g.final_exam, 0))";
+        const string percentage =
+            "(CASE WHEN c.max_marks > 0 THEN " + total + " / c.max_marks * 100 ELSE 0 END)";
+
+        // CASE WHEN percentage >= 85 THEN ... ELSE <band F> END, from the kernel's tables
+        auto byBand = [&percentage](auto column) {
+            ostringstream sql;
+            sql << "CASE";
+            for (int band = GradeKernel::BAND_A; band < GradeKernel::BAND_F; band++) {
+                sql << " WHEN " << percentage << " >= " << GradeKernel::MIN_PERCENTAGE[band]
+                    << " THEN " << column(band);
+            }
+            sql << " ELSE " << column(GradeKernel::BAND_F) << " END";
+            return sql.str();
+        };
+        auto quoted = [](const char* text) { return "'" + string(text) + "'"; };
+
+        return "UPDATE grades g "
+               "JOIN registrations r ON g.registration_id = r.id "
+               "JOIN courses c ON r.course_id = c.id "
+               "SET g.total_marks = " + total + ", "
+               "g.percentage = " + percentage + ", "
+               "g.gpa = " + byBand([](int band) { return GradeKernel::GPA[band]; }) + ", "
+               "g.evaluation = " + byBand([&](int band) { return quoted(GradeKernel::EVALUATION[band]); }) + ", "
+               "g.letter_grade = " + byBand([&](int band) { return quoted(GradeKernel::LETTER[band]); }) + ", "
+               "g.is_dirty = FALSE ";
+    }();
+    return statement;
+}
+
+// Reading and writing in one statement: a component written concurrently
+// either lands before (and is included) or after (and marks the row dirty again)
 bool Grade::calculateGrade(Database& db, const string& registrationId) {
     try {
-        auto stmt = db.prepareStatement(
-            "SELECT g.id, g.assignment1, g.assignment2, g.year_work, g.final_exam, "
-            "c.max_marks "
-            "FROM grades g "
-            "JOIN registrations r ON g.registration_id = r.id "
-            "JOIN courses c ON r.course_id = c.id "
-            "WHERE g.registration_id = ?"
-        );
+        auto stmt = db.prepareStatement(recalculateStatement() + "WHERE g.registration_id = ?");
         stmt->setString(1, registrationId);
-        auto result = stmt->executeQuery();
-
-        if (!result->next()) {
-            return false;
-        }
-
-        double assignment1 = result->getDouble("assignment1");
-        double assignment2 = result->getDouble("assignment2");
-        double yearWork = result->getDouble("year_work");
-        double finalExam = result->getDouble("final_exam");
-        double maxMarks = result->getDouble("max_marks");
-
-        double total = assignment1 + assignment2 + yearWork + finalExam;
-        double percentage = (maxMarks > 0) ? (total / maxMarks * 100.0) : 0.0;
-        string evaluation = getEvaluationFromPercentage(percentage);
-        double gpa = getGpaFromPercentage(percentage);
-        string letter = getLetterGrade(percentage);
-
-        auto updateStmt = db.prepareStatement(
-            "UPDATE grades SET total_marks = ?, percentage = ?, gpa = ?, evaluation = ?, letter_grade = ? "
-            "WHERE registration_id = ?"
-        );
-        updateStmt->setDouble(1, total);
-        updateStmt->setDouble(2, percentage);
-        updateStmt->setDouble(3, gpa);
-        updateStmt->setString(4, evaluation);
-        updateStmt->setString(5, letter);
-        updateStmt->setString(6, registrationId);
-        updateStmt->executeUpdate();
-
+        stmt->executeUpdate();
         return true;
 
     } catch (exception& e) {
@@ -388,29 +375,84 @@ bool Grade::calculateGrade(Database& db, const string& registrationId) {
     }
 }
 
-double Grade::calculateStudentCGPA(Database& db, const string& studentId) {
+int Grade::markCourseDirty(Database& db, const string& courseId) {
     try {
         auto stmt = db.prepareStatement(
-            "SELECT COALESCE(SUM(g.gpa * c.credit_hours), 0) as total_points, "
-            "COALESCE(SUM(c.credit_hours), 0) as total_credits "
-            "FROM grades g "
+            "UPDATE grades g "
             "JOIN registrations r ON g.registration_id = r.id "
-            "JOIN courses c ON r.course_id = c.id "
-            "WHERE r.student_id = ? AND r.status IN ('registered', 'completed')"
+            "SET g.is_dirty = TRUE, g.row_version = g.row_version + 1 "
+            "WHERE r.course_id = ?"
         );
-        stmt->setString(1, studentId);
+        stmt->setString(1, courseId);
+        return stmt->executeUpdate();
 
-        auto result = stmt->executeQuery();
-        if (result->next()) {
-            double totalPoints = result->getDouble("total_points");
-            int totalCredits = result->getInt("total_credits");
+    } catch (exception& e) {
+        cerr << "[Grade] Error marking course grades: " << e.what() << endl;
+        return -1;
+    }
+}
 
-            if (totalCredits > 0) {
-                return totalPoints / totalCredits;
-            }
+int Grade::recalculateDirty(Database& db) {
+    try {
+        return db.executeUpdate(recalculateStatement() + "WHERE g.is_dirty = TRUE");
+
+    } catch (exception& e) {
+        cerr << "[Grade] Error recalculating changed grades: " << e.what() << endl;
+        return -1;
+    }
+}
+
+// Credit-weighted GPA of the rows in result. Dirty rows are graded from
+// their components, since their stored gpa may be out of date.
+static double weightedGpa(ResultSet& result) {
+    Grade::GradedRows graded = Grade::gradeRows(result);
+    int gpaColumn = result.getFieldIndex("gpa");
+    int creditsColumn = result.getFieldIndex("credit_hours");
+
+    double totalPoints = 0;
+    double totalCredits = 0;
+    for (size_t i = 0; result.next(); i++) {
+        int credits = result.getInt(creditsColumn);
+        totalPoints += (graded.dirty[i] ? graded.gpa[i] : result.getDouble(gpaColumn)) * credits;
+        totalCredits += credits;
+    }
+    return totalCredits > 0 ? totalPoints / totalCredits : 0.0;
+}
+
+// GPA of a totals row (quality_points, credit_hours)
+static double gpaOfTotals(ResultSet& totals) {
+    int credits = totals.getInt("credit_hours");
+    return credits > 0 ? totals.getDouble("quality_points") / credits : 0.0;
+}
+
+static const char* const GRADED_ROWS =
+    "SELECT g.gpa, g.is_dirty, g.assignment1, g.assignment2, g.year_work, g.final_exam, "
+    "c.max_marks, c.credit_hours "
+    "FROM grades g "
+    "JOIN registrations r ON g.registration_id = r.id "
+    "JOIN courses c ON r.course_id = c.id "
+    "WHERE r.student_id = ? AND r.status IN ('registered', 'completed')";
+
+double Grade::calculateStudentCGPA(Database& db, const string& studentId) {
+    try {
+        auto totalsStmt = db.prepareStatement(
+            "SELECT quality_points, credit_hours, dirty_grades "
+            "FROM student_gpa_totals WHERE student_id = ?"
+        );
+        totalsStmt->setString(1, studentId);
+        auto totals = totalsStmt->executeQuery();
+        if (!totals->next()) {
+            return 0.0;
+        }
+        if (totals->getInt("dirty_grades") == 0) {
+            return gpaOfTotals(*totals);
         }
 
-        return 0.0;
+        auto stmt = db.prepareStatement(GRADED_ROWS);
+        stmt->setString(1, studentId);
+
+        auto result = stmt->executeQuery();
+        return weightedGpa(*result);
 
     } catch (exception& e) {
         cerr << "[Grade] Error calculating CGPA: " << e.what() << endl;
@@ -421,28 +463,26 @@ double Grade::calculateStudentCGPA(Database& db, const string& studentId) {
 double Grade::calculateStudentSemesterGPA(Database& db, const string& studentId,
                                           const string& semesterId) {
     try {
-        auto stmt = db.prepareStatement(
-            "SELECT COALESCE(SUM(g.gpa * c.credit_hours), 0) as total_points, "
-            "COALESCE(SUM(c.credit_hours), 0) as total_credits "
-            "FROM grades g "
-            "JOIN registrations r ON g.registration_id = r.id "
-            "JOIN courses c ON r.course_id = c.id "
-            "WHERE r.student_id = ? AND r.semester_id = ?"
+        auto totalsStmt = db.prepareStatement(
+            "SELECT quality_points, credit_hours, dirty_grades "
+            "FROM student_semester_gpa_totals WHERE student_id = ? AND semester_id = ?"
         );
+        totalsStmt->setString(1, studentId);
+        totalsStmt->setString(2, semesterId);
+        auto totals = totalsStmt->executeQuery();
+        if (!totals->next()) {
+            return 0.0;
+        }
+        if (totals->getInt("dirty_grades") == 0) {
+            return gpaOfTotals(*totals);
+        }
+
+        auto stmt = db.prepareStatement(string(GRADED_ROWS) + " AND r.semester_id = ?");
         stmt->setString(1, studentId);
         stmt->setString(2, semesterId);
 
         auto result = stmt->executeQuery();
-        if (result->next()) {
-            double totalPoints = result->getDouble("total_points");
-            int totalCredits = result->getInt("total_credits");
-
-            if (totalCredits > 0) {
-                return totalPoints / totalCredits;
-            }
-        }
-
-        return 0.0;
+        return weightedGpa(*result);
 
     } catch (exception& e) {
         cerr << "[Grade] Error calculating semester GPA: " << e.what() << endl;
@@ -450,6 +490,114 @@ double Grade::calculateStudentSemesterGPA(Database& db, const string& studentId,
     }
 }
 
+// Per-semester totals computed from scratch; the populate step of
+// sql/add_gpa_totals.sql runs the same query
+static const char* const REBUILT_SEMESTER_TOTALS =
+    "SELECT r.student_id, r.semester_id, SUM(COALESCE(g.gpa, 0) * c.credit_hours) AS quality_points, "
+    "SUM(c.credit_hours) AS credit_hours, SUM(g.is_dirty) AS dirty_grades "
+    "FROM grades g "
+    "JOIN registrations r ON g.registration_id = r.id "
+    "JOIN courses c ON r.course_id = c.id "
+    "WHERE r.status IN ('registered', 'completed') "
+    "GROUP BY r.student_id, r.semester_id";
+
+vector<Grade::GpaTotalsMismatch> Grade::verifyGpaTotals(Database& db, bool repair) {
+    struct Totals {
+        double points = 0;
+        int credits = 0;
+        int dirty = 0;
+    };
+    // (student, semester); semester "" is the student's overall row
+    map<pair<string, string>, Totals> expected;
+    map<pair<string, string>, Totals> stored;
+
+    auto read = [](ResultSet& row) {
+        Totals totals;
+        totals.points = row.getDouble("quality_points");
+        totals.credits = row.getInt("credit_hours");
+        totals.dirty = row.getInt("dirty_grades");
+        return totals;
+    };
+
+    // One snapshot, so writes landing meanwhile are not reported as drift
+    db.executeUpdate("START TRANSACTION WITH CONSISTENT SNAPSHOT");
+    try {
+        auto rebuilt = db.executeQuery(REBUILT_SEMESTER_TOTALS);
+        while (rebuilt->next()) {
+            string studentId = rebuilt->getString("student_id");
+            Totals semester = read(*rebuilt);
+            expected[{studentId, rebuilt->getString("semester_id")}] = semester;
+            Totals& overall = expected[{studentId, ""}];
+            overall.points += semester.points;
+            overall.credits += semester.credits;
+            overall.dirty += semester.dirty;
+        }
+
+        auto overallRows = db.executeQuery(
+            "SELECT student_id, quality_points, credit_hours, dirty_grades FROM student_gpa_totals"
+        );
+        while (overallRows->next()) {
+            stored[{overallRows->getString("student_id"), ""}] = read(*overallRows);
+        }
+        auto semesterRows = db.executeQuery(
+            "SELECT student_id, semester_id, quality_points, credit_hours, dirty_grades "
+            "FROM student_semester_gpa_totals"
+        );
+        while (semesterRows->next()) {
+            stored[{semesterRows->getString("student_id"), semesterRows->getString("semester_id")}] =
+                read(*semesterRows);
+        }
+        db.executeUpdate("COMMIT");
+    } catch (...) {
+        try { db.executeUpdate("ROLLBACK"); } catch (...) {}
+        throw;
+    }
+
+    // A missing row and a row of zeros are the same totals
+    vector<GpaTotalsMismatch> mismatches;
+    auto compare = [&mismatches](const pair<string, string>& key, const Totals& want, const Totals& have) {
+        if (fabs(want.points - have.points) < 0.005 && want.credits == have.credits &&
+            want.dirty == have.dirty) {
+            return;
+        }
+        mismatches.push_back({key.first, key.second, have.points, want.points,
+                              have.credits, want.credits, have.dirty, want.dirty});
+    };
+    for (const auto& [key, want] : expected) {
+        auto found = stored.find(key);
+        compare(key, want, found == stored.end() ? Totals() : found->second);
+    }
+    for (const auto& [key, have] : stored) {
+        if (expected.find(key) == expected.end()) {
+            compare(key, Totals(), have);
+        }
+    }
+
+    if (repair && !mismatches.empty()) {
+        try {
+            db.executeUpdate("START TRANSACTION");
+            db.executeUpdate("DELETE FROM student_semester_gpa_totals");
+            db.executeUpdate("DELETE FROM student_gpa_totals");
+            db.executeUpdate(
+                string("INSERT INTO student_semester_gpa_totals "
+                       "(student_id, semester_id, quality_points, credit_hours, dirty_grades) ") +
+                REBUILT_SEMESTER_TOTALS
+            );
+            db.executeUpdate(
+                "INSERT INTO student_gpa_totals (student_id, quality_points, credit_hours, dirty_grades) "
+                "SELECT student_id, SUM(quality_points), SUM(credit_hours), SUM(dirty_grades) "
+                "FROM student_semester_gpa_totals GROUP BY student_id"
+            );
+            db.executeUpdate("COMMIT");
+            cerr << "[Grade] Rebuilt GPA totals (" << mismatches.size() << " rows differed)" << endl;
+        } catch (...) {
+            try { db.executeUpdate("ROLLBACK"); } catch (...) {}
+            throw;
+        }
+    }
+    return mismatches;
+}
+
 // ========================================
 // INSTANCE DATABASE OPERATIONS
 // ========================================
@@ -457,8 +605,8 @@ double Grade::calculateStudentSemesterGPA(Database& db, const string& studentId,
 bool Grade::save(Database& db) {
     try {
         auto stmt = db.prepareStatement(
-            "INSERT INTO grades (registration_id, assignment1, assignment2, year_work, final_exam) "
-            "VALUES (?, ?, ?, ?, ?)"
+            "INSERT INTO grades (registration_id, assignment1, assignment2, year_work, final_exam, is_dirty) "
+            "VALUES (?, ?, ?, ?, ?, TRUE)"
         );
         stmt->setString(1, registrationId);
         stmt->setDouble(2, assignment1);
@@ -468,7 +616,7 @@ bool Grade::save(Database& db) {
         stmt->executeUpdate();
 
         id = to_string(db.getLastInsertId());
-        calculateGrade(db, registrationId);
+        GradeRecalculator::instance().notify();
         return true;
 
     } catch (exception& e) {
@@ -480,7 +628,8 @@ bool Grade::save(Database& db) {
 bool Grade::update(Database& db) {
     try {
         auto stmt = db.prepareStatement(
-            "UPDATE grades SET assignment1 = ?, assignment2 = ?, year_work = ?, final_exam = ? "
+            "UPDATE grades SET assignment1 = ?, assignment2 = ?, year_work = ?, final_exam = ?, "
+            "is_dirty = TRUE, row_version = row_version + 1 "
             "WHERE registration_id = ?"
         );
         stmt->setDouble(1, assignment1);
@@ -490,7 +639,9 @@ bool Grade::update(Database& db) {
         stmt->setString(5, registrationId);
 
         int rowsAffected = stmt->executeUpdate();
-        calculateGrade(db, registrationId);
+        if (rowsAffected > 0) {
+            GradeRecalculator::instance().notify();
+        }
         return rowsAffected > 0;
 
     } catch (exception& e) {
@@ -514,13 +665,15 @@ bool Grade::updateComponent(Database& db, const string& component, double value)
     else return false;
 
     try {
-        string query = "UPDATE grades SET " + column + " = ? WHERE registration_id = ?";
+        string query = "UPDATE grades SET " + column + " = ?, is_dirty = TRUE, "
+                       "row_version = row_version + 1 WHERE registration_id = ?";
         auto stmt = db.prepareStatement(query);
         stmt->setDouble(1, value);
         stmt->setString(2, registrationId);
         int rowsAffected = stmt->executeUpdate();
-
-        calculateGrade(db, registrationId);
+        if (rowsAffected > 0) {
+            GradeRecalculator::instance().notify();
+        }
         return rowsAffected > 0;
 
     } catch (exception& e) {
@@ -548,21 +701,7 @@ bool Grade::remove(Database& db) {
 // ========================================
 
 string Grade::toJson() const {
-    stringstream ss;
-    ss << "{";
-    ss << "\"id\":\"" << id << "\",";
-    ss << "\"registrationId\":\"" << registrationId << "\",";
-    ss << "\"assignment1\":" << assignment1 << ",";
-    ss << "\"assignment2\":" << assignment2 << ",";
-    ss << "\"yearWork\":" << yearWork << ",";
-    ss << "\"finalExam\":" << finalExam << ",";
-    ss << "\"total\":" << total << ",";
-    ss << "\"percentage\":" << percentage << ",";
-    ss << "\"gpa\":" << gpa << ",";
-    ss << "\"evaluation\":\"" << evaluation << "\",";
-    ss << "\"letterGrade\":\"" << letterGrade << "\"";
-    ss << "}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 bool Grade::isEmpty() const {
@@ -0,0 +1,66 @@
+/*
+ * ============================================
+ * GRADEDISTRIBUTIONCACHE.CPP - Cached Mark Limits
+ * ============================================
+ */
+
+#include "../include/GradeDistributionCache.h"
+
+using namespace std;
+
+GradeDistributionCache& GradeDistributionCache::instance() {
+    static GradeDistributionCache cache;
+    return cache;
+}
+
+bool GradeDistributionCache::find(const string& registrationId, Grade::GradeDistribution& dist) const {
+    lock_guard<std::mutex> lock(mutex);
+    auto placement = registrations.find(registrationId);
+    if (placement == registrations.end()) {
+        return false;
+    }
+    auto course = courses.find(placement->second.courseId);
+    if (course == courses.end()) {
+        return false;
+    }
+    dist = course->second;
+    return true;
+}
+
+bool GradeDistributionCache::findPlacement(const string& registrationId, Placement& placement) const {
+    lock_guard<std::mutex> lock(mutex);
+    auto found = registrations.find(registrationId);
+    if (found == registrations.end()) {
+        return false;
+    }
+    placement = found->second;
+    return true;
+}
+
+void GradeDistributionCache::store(const string& courseId, const string& semesterId,
+                                   const Grade::GradeDistribution& dist,
+                                   const vector<string>& registrationIds, uint64_t loadedGeneration) {
+    lock_guard<std::mutex> lock(mutex);
+    if (loadedGeneration != generation.load()) {
+        return;
+    }
+    courses[courseId] = dist;
+    if (registrations.size() + registrationIds.size() > MAX_REGISTRATIONS) {
+        registrations.clear();
+    }
+    for (const string& registrationId : registrationIds) {
+        registrations[registrationId] = Placement{courseId, semesterId};
+    }
+}
+
+void GradeDistributionCache::invalidateCourse(const string& courseId) {
+    lock_guard<std::mutex> lock(mutex);
+    generation.fetch_add(1);
+    courses.erase(courseId);
+}
+
+void GradeDistributionCache::forgetRegistration(const string& registrationId) {
+    lock_guard<std::mutex> lock(mutex);
+    generation.fetch_add(1);
+    registrations.erase(registrationId);
+}
@@ -0,0 +1,122 @@
+/*
+ * ============================================
+ * GRADEKERNEL.CPP - Batch Grade Computation
+ * ============================================
+ */
+
+#include "../include/GradeKernel.h"
+
+#if defined(__AVX2__)
+#define SIS_GRADE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIS_GRADE_SSE2 1
+#endif
+
+#if defined(SIS_GRADE_AVX2) || defined(SIS_GRADE_SSE2)
+#include <immintrin.h>
+#endif
+
+const double GradeKernel::MIN_PERCENTAGE[BAND_COUNT] = {85, 75, 65, 60, 0};
+const double GradeKernel::GPA[BAND_COUNT] = {4.0, 3.0, 2.0, 1.0, 0.0};
+const char* const GradeKernel::EVALUATION[BAND_COUNT] = {"Excellent", "Very Good", "Good", "Pass", "Fail"};
+const char* const GradeKernel::LETTER[BAND_COUNT] = {"A", "B", "C", "D", "F"};
+
+void GradeKernel::computeScalar(const Input& in, const Output& out, size_t first) {
+    for (size_t i = first; i < in.count; i++) {
+        double total = in.assignment1[i] + in.assignment2[i] + in.yearWork[i] + in.finalExam[i];
+        double percentage = percentageOf(total, in.maxMarks[i]);
+        Band band = bandOf(percentage);
+        out.total[i] = total;
+        out.percentage[i] = percentage;
+        out.gpa[i] = GPA[band];
+        out.band[i] = band;
+    }
+}
+
+void GradeKernel::compute(const Input& in, const Output& out) {
+    size_t i = 0;
+    // A lane's band is the number of thresholds it is below. Each compare
+    // gives all-ones (-1 as an integer) per lane that is below, so
+    // subtracting the four masks counts them.
+#if defined(SIS_GRADE_AVX2)
+    const __m256d hundred4 = _mm256_set1_pd(100.0);
+    const __m256d zero4 = _mm256_setzero_pd();
+    const __m256d thresholdA4 = _mm256_set1_pd(MIN_PERCENTAGE[BAND_A]);
+    const __m256d thresholdB4 = _mm256_set1_pd(MIN_PERCENTAGE[BAND_B]);
+    const __m256d thresholdC4 = _mm256_set1_pd(MIN_PERCENTAGE[BAND_C]);
+    const __m256d thresholdD4 = _mm256_set1_pd(MIN_PERCENTAGE[BAND_D]);
+    for (; i + 4 <= in.count; i += 4) {
+        __m256d total = _mm256_add_pd(
+            _mm256_add_pd(_mm256_add_pd(_mm256_loadu_pd(in.assignment1 + i), _mm256_loadu_pd(in.assignment2 + i)),
+                          _mm256_loadu_pd(in.yearWork + i)),
+            _mm256_loadu_pd(in.finalExam + i));
+        __m256d maxMarks = _mm256_loadu_pd(in.maxMarks + i);
+        // total / max * 100, or 0 where max <= 0 (the division's inf/NaN is masked off)
+        __m256d percentage = _mm256_and_pd(_mm256_cmp_pd(maxMarks, zero4, _CMP_GT_OQ),
+                                           _mm256_mul_pd(_mm256_div_pd(total, maxMarks), hundred4));
+        __m256i below = _mm256_sub_epi64(
+            _mm256_sub_epi64(
+                _mm256_sub_epi64(
+                    _mm256_sub_epi64(_mm256_setzero_si256(),
+                                     _mm256_castpd_si256(_mm256_cmp_pd(percentage, thresholdA4, _CMP_NGE_UQ))),
+                    _mm256_castpd_si256(_mm256_cmp_pd(percentage, thresholdB4, _CMP_NGE_UQ))),
+                _mm256_castpd_si256(_mm256_cmp_pd(percentage, thresholdC4, _CMP_NGE_UQ))),
+            _mm256_castpd_si256(_mm256_cmp_pd(percentage, thresholdD4, _CMP_NGE_UQ)));
+
+        _mm256_storeu_pd(out.total + i, total);
+        _mm256_storeu_pd(out.percentage + i, percentage);
+        alignas(32) int64_t bands[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bands), below);
+        for (int lane = 0; lane < 4; lane++) {
+            out.band[i + lane] = static_cast<uint8_t>(bands[lane]);
+            out.gpa[i + lane] = GPA[bands[lane]];
+        }
+    }
+#endif
+#if defined(SIS_GRADE_SSE2)
+    const __m128d hundred = _mm_set1_pd(100.0);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d thresholdA = _mm_set1_pd(MIN_PERCENTAGE[BAND_A]);
+    const __m128d thresholdB = _mm_set1_pd(MIN_PERCENTAGE[BAND_B]);
+    const __m128d thresholdC = _mm_set1_pd(MIN_PERCENTAGE[BAND_C]);
+    const __m128d thresholdD = _mm_set1_pd(MIN_PERCENTAGE[BAND_D]);
+    for (; i + 2 <= in.count; i += 2) {
+        __m128d total = _mm_add_pd(
+            _mm_add_pd(_mm_add_pd(_mm_loadu_pd(in.assignment1 + i), _mm_loadu_pd(in.assignment2 + i)),
+                       _mm_loadu_pd(in.yearWork + i)),
+            _mm_loadu_pd(in.finalExam + i));
+        __m128d maxMarks = _mm_loadu_pd(in.maxMarks + i);
+        __m128d percentage = _mm_and_pd(_mm_cmpgt_pd(maxMarks, zero),
+                                        _mm_mul_pd(_mm_div_pd(total, maxMarks), hundred));
+        // Masks are all-ones in both 32-bit halves, so 32-bit lanes 0 and 2 hold the counts
+        __m128i below = _mm_sub_epi32(
+            _mm_sub_epi32(
+                _mm_sub_epi32(_mm_sub_epi32(_mm_setzero_si128(), _mm_castpd_si128(_mm_cmpnge_pd(percentage, thresholdA))),
+                              _mm_castpd_si128(_mm_cmpnge_pd(percentage, thresholdB))),
+                _mm_castpd_si128(_mm_cmpnge_pd(percentage, thresholdC))),
+            _mm_castpd_si128(_mm_cmpnge_pd(percentage, thresholdD)));
+
+        _mm_storeu_pd(out.total + i, total);
+        _mm_storeu_pd(out.percentage + i, percentage);
+        int band0 = _mm_cvtsi128_si32(below);
+        int band1 = _mm_cvtsi128_si32(_mm_srli_si128(below, 8));
+        out.band[i] = static_cast<uint8_t>(band0);
+        out.band[i + 1] = static_cast<uint8_t>(band1);
+        out.gpa[i] = GPA[band0];
+        out.gpa[i + 1] = GPA[band1];
+    }
+#endif
+    // Scalar fallback, and the rows left over
+    computeScalar(in, out, i);
+}
+
+const char* GradeKernel::vectorPath() {
+#if defined(SIS_GRADE_AVX2)
+    return "AVX2 + SSE2";
+#elif defined(SIS_GRADE_SSE2)
+    return "SSE2";
+#else
+    return "none (scalar)";
+#endif
+}
@@ -0,0 +1,77 @@
+/*
+ * ============================================
+ * GRADERECALCULATOR.CPP - Background Grade Drain
+ * ============================================
+ */
+
+#include "../include/GradeRecalculator.h"
+#include "../include/Grade.h"
+#include <iostream>
+
+using namespace std;
+
+GradeRecalculator::GradeRecalculator() : pool(nullptr), running(false), pending(false) {
+}
+
+GradeRecalculator::~GradeRecalculator() {
+    stop();
+}
+
+GradeRecalculator& GradeRecalculator::instance() {
+    static GradeRecalculator recalculator;
+    return recalculator;
+}
+
+void GradeRecalculator::start(ConnectionPool& connectionPool) {
+    lock_guard<mutex> lock(mtx);
+    if (running) {
+        return;
+    }
+    pool = &connectionPool;
+    running = true;
+    pending = true;                 // Rows left dirty by the last run
+    worker = thread(&GradeRecalculator::run, this);
+}
+
+void GradeRecalculator::stop() {
+    {
+        lock_guard<mutex> lock(mtx);
+        running = false;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void GradeRecalculator::notify() {
+    {
+        lock_guard<mutex> lock(mtx);
+        pending = true;
+    }
+    wake.notify_one();
+}
+
+void GradeRecalculator::run() {
+    unique_lock<mutex> lock(mtx);
+    while (true) {
+        wake.wait_for(lock, INTERVAL, [this] { return !running || pending; });
+        if (!running) {
+            return;
+        }
+        pending = false;
+        lock.unlock();
+
+        try {
+            PooledConnection conn = pool->acquire();
+            int drained = Grade::recalculateDirty(*conn);
+            if (drained > 0) {
+                cout << "[GradeRecalculator] Recalculated " << drained << " grade(s)" << endl;
+            }
+        } catch (const exception& e) {
+            cerr << "[GradeRecalculator] " << e.what() << endl;
+        }
+
+        lock.lock();
+    }
+}
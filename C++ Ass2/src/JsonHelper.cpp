@@ -5,37 +5,130 @@
  */
 
 #include "../include/JsonHelper.h"
+#include "../include/JsonRequest.h"
 #include <iomanip>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 
 using namespace std;
 
+// ============================================
+// ESCAPE SCANNING
+// ============================================
+// Strings are copied in clean spans: a vector scan finds the next byte
+// that needs escaping (", \ or a control byte below 0x20), everything
+// before it is appended in one go. UTF-8 lead/continuation bytes are
+// all >= 0x80 and never match, so Arabic text is copied untouched.
+
+#if defined(__AVX2__)
+#define SIS_ESCAPE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIS_ESCAPE_SSE2 1
+#endif
+
+#if defined(SIS_ESCAPE_AVX2) || defined(SIS_ESCAPE_SSE2)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+inline bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+inline unsigned lowestBit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// First byte in [p, end) that needs escaping, or end
+const char* findEscape(const char* p, const char* end) {
+#if defined(SIS_ESCAPE_AVX2)
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    const __m256i control32 = _mm256_set1_epi8(0x1F);
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        // Unsigned chunk <= 0x1F  <=>  min(chunk, 0x1F) == chunk
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control32), chunk));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0) return p + lowestBit(mask);
+        p += 32;
+    }
+#endif
+#if defined(SIS_ESCAPE_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0) return p + lowestBit(mask);
+        p += 16;
+    }
+#endif
+    // Scalar fallback, and the tail shorter than one vector
+    while (p < end && !needsEscape(static_cast<unsigned char>(*p))) {
+        p++;
+    }
+    return p;
+}
+
+} // namespace
+
 /*
- * escapeString - Escapes special characters in JSON strings
+ * appendEscaped - Escaped string contents, without quotes
  */
-string JsonHelper::escapeString(const string& str) {
-    stringstream ss;
-    for (char c : str) {
+void JsonHelper::appendEscaped(string& out, string_view value) {
+    static const char hexDigits[] = "0123456789abcdef";
+    const char* p = value.data();
+    const char* end = p + value.size();
+    out.reserve(out.size() + value.size());
+    while (p < end) {
+        const char* special = findEscape(p, end);
+        out.append(p, special - p);
+        if (special == end) break;
+        unsigned char c = static_cast<unsigned char>(*special);
         switch (c) {
-            case '"':  ss << "\\\""; break;
-            case '\\': ss << "\\\\"; break;
-            case '\b': ss << "\\b"; break;
-            case '\f': ss << "\\f"; break;
-            case '\n': ss << "\\n"; break;
-            case '\r': ss << "\\r"; break;
-            case '\t': ss << "\\t"; break;
-            default:
-                if (c >= 0 && c < 32) {
-                    // Control characters - encode as unicode
-                    ss << "\\u" << hex << setfill('0') 
-                       << setw(4) << static_cast<int>(c);
-                } else {
-                    ss << c;
-                }
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                // Control characters - encode as unicode
+                char unicode[6] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0x0F] };
+                out.append(unicode, sizeof(unicode));
+            }
         }
+        p = special + 1;
     }
-    return ss.str();
+}
+
+/*
+ * escapeString - Escapes special characters in JSON strings
+ */
+string JsonHelper::escapeString(const string& str) {
+    string escaped;
+    appendEscaped(escaped, str);
+    return escaped;
 }
 
 /*
@@ -45,6 +138,16 @@ string JsonHelper::makeString(const string& value) {
     return "\"" + escapeString(value) + "\"";
 }
 
+/*
+ * appendString - Appends a quoted, escaped JSON string to out
+ * Runs of characters that need no escaping are copied in one append.
+ */
+void JsonHelper::appendString(string& out, string_view value) {
+    out += '"';
+    appendEscaped(out, value);
+    out += '"';
+}
+
 /*
  * makeNumber - Creates a JSON number value (int)
  */
@@ -104,68 +207,13 @@ string JsonHelper::makeObject(const vector<pair<string, string>>& pairs) {
 }
 
 /*
- * parseSimpleValue - Basic JSON value extraction
+ * parseSimpleValue - Single value lookup
  * 
- * This is a simple parser for extracting values from JSON.
- * For complex JSON parsing, use nlohmann/json library.
+ * Parses the whole request; handlers that read several
+ * fields should build one JsonRequest and reuse it.
  */
 string JsonHelper::parseSimpleValue(const string& json, const string& key) {
-    string searchKey = "\"" + key + "\"";
-    size_t keyPos = json.find(searchKey);
-    
-    if (keyPos == string::npos) {
-        return "";
-    }
-    
-    // Find the colon after the key
-    size_t colonPos = json.find(':', keyPos + searchKey.length());
-    if (colonPos == string::npos) {
-        return "";
-    }
-    
-    // Skip whitespace
-    size_t valueStart = colonPos + 1;
-    while (valueStart < json.length() && isspace(json[valueStart])) {
-        valueStart++;
-    }
-    
-    if (valueStart >= json.length()) {
-        return "";
-    }
-    
-    // Determine value type and extract
-    if (json[valueStart] == '"') {
-        // String value
-        size_t valueEnd = json.find('"', valueStart + 1);
-        if (valueEnd != string::npos) {
-            return json.substr(valueStart + 1, valueEnd - valueStart - 1);
-        }
-    } else if (json[valueStart] == '{' || json[valueStart] == '[') {
-        // Object or array - find matching bracket
-        char openBracket = json[valueStart];
-        char closeBracket = (openBracket == '{') ? '}' : ']';
-        int depth = 1;
-        size_t valueEnd = valueStart + 1;
-        
-        while (valueEnd < json.length() && depth > 0) {
-            if (json[valueEnd] == openBracket) depth++;
-            else if (json[valueEnd] == closeBracket) depth--;
-            valueEnd++;
-        }
-        
-        return json.substr(valueStart, valueEnd - valueStart);
-    } else {
-        // Number, boolean, or null
-        size_t valueEnd = json.find_first_of(",}]", valueStart);
-        if (valueEnd != string::npos) {
-            string value = json.substr(valueStart, valueEnd - valueStart);
-            // Trim whitespace
-            value.erase(value.find_last_not_of(" \t\n\r") + 1);
-            return value;
-        }
-    }
-    
-    return "";
+    return JsonRequest(json).getString(key);
 }
 
 /*
@@ -0,0 +1,432 @@
+/*
+ * ============================================
+ * JSONREQUEST.CPP - Binding Request Parser
+ * ============================================
+ */
+
+#include "../include/JsonRequest.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+string_view trim(string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t' ||
+                             text.front() == '\n' || text.front() == '\r')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' ||
+                             text.back() == '\n' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// The whole text must be the number (an optional leading + is allowed, as with stoi)
+template <typename T>
+bool parseNumber(string_view text, T& number) {
+    text = trim(text);
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+    if (text.empty()) return false;
+    auto parsed = from_chars(text.data(), text.data() + text.size(), number);
+    return parsed.ec == errc() && parsed.ptr == text.data() + text.size();
+}
+
+[[noreturn]] void badNumber(string_view key) {
+    throw invalid_argument("Invalid or missing number: " + string(key));
+}
+
+} // namespace
+
+/*
+ * Constructor - Parses the request once
+ */
+JsonRequest::JsonRequest(string_view json)
+    : arenaUsed(0), valid(false), pos(nullptr), end(nullptr) {
+    // Unescaping never grows a string; the extra n covers a stringified
+    // argument, which is unescaped once and then parsed again
+    arena.reset(new char[json.size() * 2 + 1]);
+    parseDocument(json);
+
+    size_t capacity = 8;
+    while (capacity < fields.size() * 2) capacity <<= 1;
+    slots.assign(capacity, 0);
+    for (size_t i = 0; i < fields.size(); i++) {
+        size_t slot = hashKey(fields[i].key) & (capacity - 1);
+        bool duplicate = false;
+        while (slots[slot] != 0) {
+            if (fields[slots[slot] - 1].key == fields[i].key) {
+                duplicate = true;       // First occurrence wins
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (!duplicate) slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+void JsonRequest::parseDocument(string_view json) {
+    pos = json.data();
+    end = json.data() + json.size();
+    skipWhitespace();
+    if (pos == end) return;
+
+    if (*pos == '{') {
+        valid = parseObject(true);
+        return;
+    }
+    if (*pos != '[') return;
+
+    // webview argument array: index the first argument
+    pos++;
+    skipWhitespace();
+    if (pos == end) return;
+    if (*pos == '{') {
+        valid = parseObject(true);
+    } else if (*pos == '"') {
+        string_view argument;
+        if (!parseString(argument)) return;
+        argument = trim(argument);
+        if (!argument.empty() && argument.front() == '{') {
+            pos = argument.data();
+            end = argument.data() + argument.size();
+            valid = parseObject(true);
+        } else {
+            valid = true;               // A plain positional argument, no keys
+        }
+    } else {
+        valid = true;
+    }
+}
+
+void JsonRequest::skipWhitespace() {
+    while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) {
+        pos++;
+    }
+}
+
+bool JsonRequest::parseObject(bool index) {
+    pos++;                              // '{'
+    skipWhitespace();
+    if (pos < end && *pos == '}') {
+        pos++;
+        return true;
+    }
+    while (pos < end) {
+        string_view key;
+        if (*pos != '"' || !parseString(key)) return false;
+        skipWhitespace();
+        if (pos == end || *pos != ':') return false;
+        pos++;
+        skipWhitespace();
+
+        string_view value;
+        Type type;
+        if (!parseValue(value, type, 1)) return false;
+        if (index) addField(key, value, type);
+
+        skipWhitespace();
+        if (pos == end) return false;
+        if (*pos == '}') {
+            pos++;
+            return true;
+        }
+        if (*pos != ',') return false;
+        pos++;
+        skipWhitespace();
+    }
+    return false;
+}
+
+bool JsonRequest::parseValue(string_view& value, Type& type, int depth) {
+    if (pos == end) return false;
+    const char* start = pos;
+    switch (*pos) {
+    case '"':
+        type = Type::STRING;
+        return parseString(value);
+    case '{':
+    case '[':
+        type = (*pos == '{') ? Type::OBJECT : Type::ARRAY;
+        if (!skipContainer(*pos, depth)) return false;
+        value = string_view(start, pos - start);
+        return true;
+    case 't':
+    case 'f':
+    case 'n': {
+        const char* literal = (*pos == 't') ? "true" : (*pos == 'f') ? "false" : "null";
+        size_t length = strlen(literal);
+        if (static_cast<size_t>(end - pos) < length || memcmp(pos, literal, length) != 0) {
+            return false;
+        }
+        pos += length;
+        type = (*start == 'n') ? Type::NUL : Type::BOOLEAN;
+        value = string_view(start, length);
+        return true;
+    }
+    default:
+        if (*pos != '-' && (*pos < '0' || *pos > '9')) return false;
+        while (pos < end && ((*pos >= '0' && *pos <= '9') || *pos == '-' || *pos == '+' ||
+                             *pos == '.' || *pos == 'e' || *pos == 'E')) {
+            pos++;
+        }
+        type = Type::NUMBER;
+        value = string_view(start, pos - start);
+        return true;
+    }
+}
+
+// Skips a nested object or array without indexing it
+bool JsonRequest::skipContainer(char open, int depth) {
+    char stack[MAX_DEPTH];
+    int top = 0;
+    if (depth >= MAX_DEPTH) return false;
+    stack[top++] = (open == '{') ? '}' : ']';
+    pos++;
+    while (pos < end) {
+        char c = *pos;
+        if (c == '"') {
+            pos++;
+            while (pos < end && *pos != '"') {
+                if (*pos == '\\') pos++;
+                pos++;
+            }
+            if (pos >= end) return false;
+        } else if (c == '{' || c == '[') {
+            if (depth + top >= MAX_DEPTH) return false;
+            stack[top++] = (c == '{') ? '}' : ']';
+        } else if (c == '}' || c == ']') {
+            if (stack[--top] != c) return false;
+            if (top == 0) {
+                pos++;
+                return true;
+            }
+        }
+        pos++;
+    }
+    return false;
+}
+
+bool JsonRequest::parseString(string_view& value) {
+    pos++;                              // Opening quote
+    const char* start = pos;
+    while (pos < end && *pos != '"' && *pos != '\\') {
+        if (static_cast<unsigned char>(*pos) < 0x20) return false;
+        pos++;
+    }
+    if (pos == end) return false;
+    if (*pos == '"') {
+        value = string_view(start, pos - start);
+        pos++;
+        return true;
+    }
+
+    // Escapes: copy into the arena, unescaping as we go
+    char* out = arena.get() + arenaUsed;
+    char* outStart = out;
+    memcpy(out, start, pos - start);
+    out += pos - start;
+    while (pos < end && *pos != '"') {
+        char c = *pos++;
+        if (c != '\\') {
+            if (static_cast<unsigned char>(c) < 0x20) return false;
+            *out++ = c;
+            continue;
+        }
+        if (pos == end) return false;
+        char escape = *pos++;
+        switch (escape) {
+        case '"':  *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '/':  *out++ = '/'; break;
+        case 'b':  *out++ = '\b'; break;
+        case 'f':  *out++ = '\f'; break;
+        case 'n':  *out++ = '\n'; break;
+        case 'r':  *out++ = '\r'; break;
+        case 't':  *out++ = '\t'; break;
+        case 'u': {
+            uint32_t codePoint;
+            if (!readHex4(codePoint)) return false;
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                // High surrogate: combine with a following \uDC00-\uDFFF
+                uint32_t low;
+                const char* save = pos;
+                if (end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u') {
+                    pos += 2;
+                    if (readHex4(low) && low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        pos = save;
+                        codePoint = 0xFFFD;
+                    }
+                } else {
+                    codePoint = 0xFFFD;
+                }
+            } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                codePoint = 0xFFFD;     // Lone low surrogate
+            }
+            appendUtf8(out, codePoint);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    if (pos == end) return false;
+    pos++;                              // Closing quote
+    value = string_view(outStart, out - outStart);
+    arenaUsed += out - outStart;
+    return true;
+}
+
+bool JsonRequest::readHex4(uint32_t& codePoint) {
+    if (end - pos < 4) return false;
+    codePoint = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = *pos++;
+        codePoint <<= 4;
+        if (c >= '0' && c <= '9') codePoint |= c - '0';
+        else if (c >= 'a' && c <= 'f') codePoint |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') codePoint |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+// At most as many bytes as the escape it replaces (\uXXXX = 6, a pair = 12)
+void JsonRequest::appendUtf8(char*& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        *out++ = static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (codePoint >> 6));
+        *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (codePoint >> 12));
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+void JsonRequest::addField(string_view key, string_view value, Type type) {
+    fields.push_back({key, value, type});
+}
+
+size_t JsonRequest::hashKey(string_view key) {
+    // FNV-1a; keys are short field names
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const JsonRequest::Field* JsonRequest::find(string_view key) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = hashKey(key) & mask;
+    while (slots[slot] != 0) {
+        const Field& field = fields[slots[slot] - 1];
+        if (field.key == key) return &field;
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
+
+// ============================================
+// Accessors
+// ============================================
+
+bool JsonRequest::isNull(string_view key) const {
+    const Field* field = find(key);
+    return !field || field->type == Type::NUL;
+}
+
+string_view JsonRequest::get(string_view key) const {
+    const Field* field = find(key);
+    return field ? field->value : string_view();
+}
+
+int JsonRequest::getInt(string_view key) const {
+    int number;
+    if (!parseNumber(get(key), number)) badNumber(key);
+    return number;
+}
+
+int JsonRequest::getInt(string_view key, int fallback) const {
+    if (isNull(key) || trim(get(key)).empty()) return fallback;
+    return getInt(key);
+}
+
+long long JsonRequest::getLong(string_view key) const {
+    long long number;
+    if (!parseNumber(get(key), number)) badNumber(key);
+    return number;
+}
+
+long long JsonRequest::getLong(string_view key, long long fallback) const {
+    if (isNull(key) || trim(get(key)).empty()) return fallback;
+    return getLong(key);
+}
+
+double JsonRequest::getDouble(string_view key) const {
+    double number;
+    if (!parseNumber(get(key), number)) badNumber(key);
+    return number;
+}
+
+double JsonRequest::getDouble(string_view key, double fallback) const {
+    if (isNull(key) || trim(get(key)).empty()) return fallback;
+    return getDouble(key);
+}
+
+bool JsonRequest::getBool(string_view key) const {
+    string_view value = get(key);
+    return value == "true" || value == "1";
+}
+
+vector<string_view> JsonRequest::elements(string_view json) {
+    vector<string_view> items;
+    JsonRequest scanner{string_view()};
+    scanner.pos = json.data();
+    scanner.end = json.data() + json.size();
+    scanner.skipWhitespace();
+    if (scanner.pos == scanner.end || *scanner.pos != '[') return {};
+    scanner.pos++;
+    scanner.skipWhitespace();
+    if (scanner.pos < scanner.end && *scanner.pos == ']') return items;
+
+    while (scanner.pos < scanner.end) {
+        const char* start = scanner.pos;
+        if (*scanner.pos == '"') {
+            // Kept escaped, so nothing is written to the scanner's arena
+            scanner.pos++;
+            while (scanner.pos < scanner.end && *scanner.pos != '"') {
+                if (*scanner.pos == '\\') scanner.pos++;
+                scanner.pos++;
+            }
+            if (scanner.pos >= scanner.end) return {};
+            scanner.pos++;
+        } else {
+            string_view value;
+            Type type;
+            if (!scanner.parseValue(value, type, 1)) return {};
+        }
+        items.emplace_back(start, scanner.pos - start);
+
+        scanner.skipWhitespace();
+        if (scanner.pos == scanner.end) return {};
+        if (*scanner.pos == ']') return items;
+        if (*scanner.pos != ',') return {};
+        scanner.pos++;
+        scanner.skipWhitespace();
+    }
+    return {};
+}
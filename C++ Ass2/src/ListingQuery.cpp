@@ -0,0 +1,218 @@
+/*
+ * ============================================
+ * LISTINGQUERY.CPP - Paged, Filtered Listings
+ * ============================================
+ */
+
+#include "../include/ListingQuery.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// Separates the key values inside a cursor (never part of an id, name or timestamp)
+const char CURSOR_SEPARATOR = '\x1f';
+
+// LIKE treats % and _ as wildcards; match them literally
+string likePrefix(string_view prefix) {
+    string pattern;
+    pattern.reserve(prefix.size() + 2);
+    for (char c : prefix) {
+        if (c == '%' || c == '_' || c == '\\') {
+            pattern += '\\';
+        }
+        pattern += c;
+    }
+    pattern += '%';
+    return pattern;
+}
+
+} // namespace
+
+ListingQuery::ListingQuery(string columns, string from, string baseTable, vector<SortKey> keys)
+    : columns(std::move(columns)), from(std::move(from)), baseTable(std::move(baseTable)),
+      keys(std::move(keys)), limit(0), paged(false) {
+}
+
+// ============================================
+// Filters
+// ============================================
+
+void ListingQuery::whereEquals(string_view expression, string_view value) {
+    if (value.empty()) return;
+    filters += " AND ";
+    filters.append(expression.data(), expression.size());
+    filters += " = ?";
+    filterParams.emplace_back(value);
+}
+
+void ListingQuery::wherePrefix(initializer_list<string_view> expressions, string_view prefix) {
+    if (prefix.empty() || expressions.size() == 0) return;
+    string pattern = likePrefix(prefix);
+    filters += " AND (";
+    bool first = true;
+    for (string_view expression : expressions) {
+        if (!first) filters += " OR ";
+        first = false;
+        filters.append(expression.data(), expression.size());
+        filters += " LIKE ?";
+        filterParams.push_back(pattern);
+    }
+    filters += ")";
+}
+
+void ListingQuery::where(string_view condition) {
+    filters += " AND (";
+    filters.append(condition.data(), condition.size());
+    filters += ")";
+}
+
+void ListingQuery::bindFilters(PreparedStatement& stmt, int& index) const {
+    for (const string& param : filterParams) {
+        stmt.setString(index++, param);
+    }
+}
+
+// ============================================
+// Paging
+// ============================================
+
+void ListingQuery::page(const JsonRequest& args) {
+    string_view cursor = args.get("after");
+    paged = !cursor.empty() || !args.isNull("limit");
+    if (!paged) return;
+
+    limit = args.getInt("limit", DEFAULT_LIMIT);
+    if (limit < 1) limit = 1;
+    if (limit > MAX_LIMIT) limit = MAX_LIMIT;
+
+    after.clear();
+    if (!cursor.empty()) {
+        after = decodeCursor(cursor);
+        if (after.size() != keys.size()) {
+            throw invalid_argument("Invalid page cursor");
+        }
+    }
+}
+
+string ListingQuery::encodeCursor(const vector<string_view>& values) {
+    string cursor;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) cursor += CURSOR_SEPARATOR;
+        cursor.append(values[i].data(), values[i].size());
+    }
+    return cursor;
+}
+
+vector<string> ListingQuery::decodeCursor(string_view cursor) {
+    vector<string> values;
+    size_t start = 0;
+    while (true) {
+        size_t end = cursor.find(CURSOR_SEPARATOR, start);
+        if (end == string_view::npos) {
+            values.emplace_back(cursor.substr(start));
+            return values;
+        }
+        values.emplace_back(cursor.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+string ListingQuery::sql() const {
+    string query = "SELECT " + columns + " FROM " + from + " WHERE 1=1" + filters;
+
+    if (!after.empty()) {
+        // Rows after the cursor in ORDER BY order:
+        //   k1 >= v1 AND (k1 > v1 OR (k1 = v1 AND k2 > v2) OR ...)
+        // The leading k1 term gives the optimizer an index range to start from.
+        const SortKey& lead = keys.front();
+        query += " AND " + lead.expression + (lead.descending ? " <= ?" : " >= ?") + " AND (";
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (i > 0) query += " OR ";
+            query += "(";
+            for (size_t j = 0; j < i; j++) {
+                query += keys[j].expression + " = ? AND ";
+            }
+            query += keys[i].expression + (keys[i].descending ? " < ?" : " > ?");
+            query += ")";
+        }
+        query += ")";
+    }
+
+    query += " ORDER BY ";
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (i > 0) query += ", ";
+        query += keys[i].expression;
+        if (keys[i].descending) query += " DESC";
+    }
+    if (paged) {
+        query += " LIMIT ?";
+    }
+    return query;
+}
+
+unique_ptr<ResultSet> ListingQuery::execute(Database& db, bool stream) const {
+    if (stream && !paged && filterParams.empty()) {
+        return db.executeStreamingQuery(sql());
+    }
+    auto stmt = db.prepareStatement(sql());
+    int index = 1;
+    bindFilters(*stmt, index);
+    if (!after.empty()) {
+        stmt->setString(index++, after.front());
+        for (size_t i = 0; i < keys.size(); i++) {
+            for (size_t j = 0; j <= i; j++) {
+                stmt->setString(index++, after[j]);
+            }
+        }
+    }
+    if (paged) {
+        stmt->setInt(index++, limit + 1);
+    }
+    return stmt->executeQuery();
+}
+
+// ============================================
+// Total count
+// ============================================
+
+/*
+ * writeTotal - "total" and "totalExact" for the first page
+ *
+ * Counts matching rows up to COUNT_CAP, which stays cheap however large
+ * the table is. Past the cap an unfiltered listing reports InnoDB's row
+ * estimate for the base table; a filtered one reports the cap.
+ */
+void ListingQuery::writeTotal(Database& db, JsonWriter& json) const {
+    if (!after.empty()) return;
+
+    auto stmt = db.prepareStatement(
+        "SELECT COUNT(*) AS total FROM (SELECT 1 FROM " + from + " WHERE 1=1" + filters +
+        " LIMIT " + to_string(COUNT_CAP + 1) + ") counted"
+    );
+    int index = 1;
+    bindFilters(*stmt, index);
+    auto result = stmt->executeQuery();
+    long long total = result->next() ? result->getLong(0) : 0;
+    bool exact = total <= COUNT_CAP;
+
+    if (!exact) {
+        total = COUNT_CAP;
+        if (filters.empty()) {
+            auto estimate = db.prepareStatement(
+                "SELECT TABLE_ROWS FROM information_schema.TABLES "
+                "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?"
+            );
+            estimate->setString(1, baseTable);
+            auto rows = estimate->executeQuery();
+            if (rows->next()) {
+                long long tableRows = rows->getLong(0);
+                if (tableRows > total) total = tableRows;
+            }
+        }
+    }
+
+    json.key("total").value(total);
+    json.key("totalExact").value(exact);
+}
@@ -5,10 +5,15 @@
  */
 
 #include "../include/Professor.h"
-#include <sstream>
 
 using namespace std;
 
+// Every professor column, as the queries below select them
+static const string& professorColumns() {
+    static const string columns = EntityFields::selectList(Professor::fields(), "p.");
+    return columns;
+}
+
 // ========================================
 // CONSTRUCTORS
 // ========================================
@@ -66,27 +71,13 @@ vector<Professor> Professor::getAllProfessors(Database& db) {
     
     try {
         auto result = db.executeQuery(
-            "SELECT p.id, p.user_id, p.first_name, p.last_name, u.email, u.phone, "
-            "p.department_id, p.hire_date, p.specialization "
+            "SELECT " + professorColumns() + " "
             "FROM professors p "
             "LEFT JOIN users u ON p.user_id = u.id "
             "ORDER BY p.id"
         );
         
-        while (result->next()) {
-            Professor prof;
-            prof.id = result->getString("id");
-            prof.userId = result->getString("user_id");
-            prof.firstName = result->getString("first_name");
-            prof.lastName = result->getString("last_name");
-            prof.email = result->getString("email");
-            prof.phone = result->getString("phone");
-            prof.departmentId = result->getString("department_id");
-            prof.hireDate = result->getString("hire_date");
-            prof.specialization = result->getString("specialization");
-            
-            professors.push_back(prof);
-        }
+        professors = EntityFields::readAll<Professor>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Professor] Error getting all professors: " << e.what() << endl;
@@ -100,8 +91,7 @@ Professor Professor::getById(Database& db, const string& id) {
     
     try {
         auto stmt = db.prepareStatement(
-            "SELECT p.id, p.user_id, p.first_name, p.last_name, u.email, u.phone, "
-            "p.department_id, p.hire_date, p.specialization "
+            "SELECT " + professorColumns() + " "
             "FROM professors p "
             "LEFT JOIN users u ON p.user_id = u.id "
             "WHERE p.id = ?"
@@ -110,17 +100,7 @@ Professor Professor::getById(Database& db, const string& id) {
         
         auto result = stmt->executeQuery();
         
-        if (result->next()) {
-            prof.id = result->getString("id");
-            prof.userId = result->getString("user_id");
-            prof.firstName = result->getString("first_name");
-            prof.lastName = result->getString("last_name");
-            prof.email = result->getString("email");
-            prof.phone = result->getString("phone");
-            prof.departmentId = result->getString("department_id");
-            prof.hireDate = result->getString("hire_date");
-            prof.specialization = result->getString("specialization");
-        }
+        prof = EntityFields::readFirst<Professor>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Professor] Error getting professor by ID: " << e.what() << endl;
@@ -152,8 +132,7 @@ vector<Professor> Professor::getByDepartment(Database& db, const string& departm
     
     try {
         auto stmt = db.prepareStatement(
-            "SELECT p.id, p.user_id, p.first_name, p.last_name, u.email, u.phone, "
-            "p.department_id, p.hire_date, p.specialization "
+            "SELECT " + professorColumns() + " "
             "FROM professors p "
             "LEFT JOIN users u ON p.user_id = u.id "
             "WHERE p.department_id = ? ORDER BY p.id"
@@ -162,20 +141,7 @@ vector<Professor> Professor::getByDepartment(Database& db, const string& departm
         
         auto result = stmt->executeQuery();
         
-        while (result->next()) {
-            Professor prof;
-            prof.id = result->getString("id");
-            prof.userId = result->getString("user_id");
-            prof.firstName = result->getString("first_name");
-            prof.lastName = result->getString("last_name");
-            prof.email = result->getString("email");
-            prof.phone = result->getString("phone");
-            prof.departmentId = result->getString("department_id");
-            prof.hireDate = result->getString("hire_date");
-            prof.specialization = result->getString("specialization");
-            
-            professors.push_back(prof);
-        }
+        professors = EntityFields::readAll<Professor>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Professor] Error getting professors by department: " << e.what() << endl;
@@ -189,8 +155,7 @@ Professor Professor::validateLogin(Database& db, const string& id, const string&
     
     try {
         auto stmt = db.prepareStatement(
-            "SELECT p.id, p.user_id, p.first_name, p.last_name, u.email, u.phone, "
-            "p.department_id, p.hire_date, p.specialization "
+            "SELECT " + professorColumns() + " "
             "FROM users u "
             "JOIN professors p ON p.user_id = u.id "
             "WHERE u.username = ? AND u.password_hash = ? AND u.is_active = TRUE AND u.role_id = 'ROLE_PROFESSOR'"
@@ -200,17 +165,7 @@ Professor Professor::validateLogin(Database& db, const string& id, const string&
         
         auto result = stmt->executeQuery();
         
-        if (result->next()) {
-            prof.id = result->getString("id");
-            prof.userId = result->getString("user_id");
-            prof.firstName = result->getString("first_name");
-            prof.lastName = result->getString("last_name");
-            prof.email = result->getString("email");
-            prof.phone = result->getString("phone");
-            prof.departmentId = result->getString("department_id");
-            prof.hireDate = result->getString("hire_date");
-            prof.specialization = result->getString("specialization");
-        }
+        prof = EntityFields::readFirst<Professor>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Professor] Error validating login: " << e.what() << endl;
@@ -373,19 +328,7 @@ bool Professor::remove(Database& db) {
 // ========================================
 
 string Professor::toJson() const {
-    stringstream ss;
-    ss << "{";
-    ss << "\"id\":\"" << id << "\",";
-    ss << "\"firstName\":\"" << firstName << "\",";
-    ss << "\"lastName\":\"" << lastName << "\",";
-    ss << "\"fullName\":\"" << getFullName() << "\",";
-    ss << "\"email\":\"" << email << "\",";
-    ss << "\"phone\":\"" << phone << "\",";
-    ss << "\"departmentId\":\"" << departmentId << "\",";
-    ss << "\"hireDate\":\"" << hireDate << "\",";
-    ss << "\"specialization\":\"" << specialization << "\"";
-    ss << "}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 bool Professor::isEmpty() const {
@@ -0,0 +1,346 @@
+/*
+ * ============================================
+ * QUERYEVENTLOOP.CPP - Implementation
+ * ============================================
+ */
+
+#include "../include/QueryEventLoop.h"
+#include <chrono>
+
+#if SIS_HAVE_NONBLOCKING_MYSQL
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+#endif
+
+using namespace std;
+
+#if SIS_HAVE_NONBLOCKING_MYSQL
+#ifdef _WIN32
+using PollEntry = WSAPOLLFD;
+static int pollSockets(PollEntry* entries, size_t count, int timeoutMs) {
+    return WSAPoll(entries, (ULONG)count, timeoutMs);
+}
+#else
+using PollEntry = pollfd;
+static int pollSockets(PollEntry* entries, size_t count, int timeoutMs) {
+    return poll(entries, (nfds_t)count, timeoutMs);
+}
+#endif
+
+// Longest wait in poll(). Only reached when a query is blocked on sending
+// (the loop waits for readable sockets) or without a wake channel.
+static constexpr int MAX_POLL_MS = 50;
+#endif
+
+#if !SIS_HAVE_NONBLOCKING_MYSQL
+static unique_ptr<ResultSet> runBlocking(MYSQL* conn, const string& query, const char* binding) {
+    auto started = QueryStats::Clock::now();
+    if (mysql_real_query(conn, query.c_str(), (unsigned long)query.length()) != 0) {
+        throw runtime_error(string("Query error: ") + mysql_error(conn));
+    }
+    MYSQL_RES* res = mysql_store_result(conn);
+    if (!res && mysql_field_count(conn) > 0) {
+        throw runtime_error(string("Query error: ") + mysql_error(conn));
+    }
+    auto rs = make_unique<ResultSet>(res);
+    QueryStats& stats = QueryStats::instance();
+    if (stats.isEnabled()) {
+        stats.record(query, started, rs->getRowCount(), query.size() + rs->getPayloadBytes(), binding);
+    }
+    return rs;
+}
+#endif
+
+QueryEventLoop::QueryEventLoop() : running(true) {
+#if SIS_HAVE_NONBLOCKING_MYSQL
+    openWakeChannel();
+#endif
+}
+
+QueryEventLoop::~QueryEventLoop() {
+    stop();
+#if SIS_HAVE_NONBLOCKING_MYSQL
+    closeWakeChannel();
+#endif
+}
+
+#if SIS_HAVE_NONBLOCKING_MYSQL
+// ========================================
+// Wake channel
+// ========================================
+
+void QueryEventLoop::openWakeChannel() {
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return;
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) return;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int length = sizeof(addr);
+    u_long nonBlocking = 1;
+    if (bind(s, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        getsockname(s, (sockaddr*)&addr, &length) != 0 ||
+        connect(s, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+        ioctlsocket(s, FIONBIO, &nonBlocking) != 0) {
+        closesocket(s);
+        return;
+    }
+    wakeReceive = wakeSend = s;
+#else
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    wakeReceive = fds[0];
+    wakeSend = fds[1];
+#endif
+    wakeReady = true;
+}
+
+void QueryEventLoop::closeWakeChannel() {
+    if (!wakeReady) return;
+    wakeReady = false;
+#ifdef _WIN32
+    closesocket(wakeReceive);
+    WSACleanup();
+#else
+    close(wakeReceive);
+    close(wakeSend);
+#endif
+}
+
+void QueryEventLoop::signalWake() {
+    if (!wakeReady) return;
+    char byte = 1;
+#ifdef _WIN32
+    send(wakeSend, &byte, 1, 0);
+#else
+    // A full pipe already wakes the loop
+    (void)!write(wakeSend, &byte, 1);
+#endif
+}
+
+void QueryEventLoop::drainWake() {
+    if (!wakeReady) return;
+    char buffer[64];
+#ifdef _WIN32
+    while (recv(wakeReceive, buffer, sizeof(buffer), 0) > 0) {}
+#else
+    while (read(wakeReceive, buffer, sizeof(buffer)) > 0) {}
+#endif
+}
+
+/*
+ * waitForSockets - Sleeps until a server answers on one of the
+ * in-flight connections or submit()/stop() signals the wake channel
+ */
+void QueryEventLoop::waitForSockets(const vector<unique_ptr<Operation>>& active) {
+    vector<PollEntry> entries;
+    entries.reserve(active.size() + 1);
+    if (wakeReady) {
+        PollEntry entry{};
+        entry.fd = wakeReceive;
+        entry.events = POLLIN;
+        entries.push_back(entry);
+    }
+    for (const auto& op : active) {
+        PollEntry entry{};
+        entry.fd = mysql_get_socket(op->conn);
+        entry.events = POLLIN;
+        entries.push_back(entry);
+    }
+    pollSockets(entries.data(), entries.size(), MAX_POLL_MS);
+    drainWake();
+}
+#endif
+
+QueryEventLoop& QueryEventLoop::instance() {
+    static QueryEventLoop loop;
+    return loop;
+}
+
+/*
+ * submit - Queues a query for the loop thread
+ */
+future<unique_ptr<ResultSet>> QueryEventLoop::submit(MYSQL* conn, string query, PooledConnection lease) {
+#if SIS_HAVE_NONBLOCKING_MYSQL
+    auto op = make_unique<Operation>();
+    op->conn = conn;
+    op->query = std::move(query);
+    op->lease = std::move(lease);
+    op->started = QueryStats::Clock::now();
+    op->binding = QueryStats::bindingName();
+    auto result = op->promise.get_future();
+    {
+        lock_guard<mutex> lock(mtx);
+        if (!running) {
+            throw runtime_error("Query event loop is stopped");
+        }
+        if (!worker.joinable()) {
+            worker = thread(&QueryEventLoop::run, this);
+        }
+        incoming.push_back(std::move(op));
+    }
+    wake.notify_one();
+    signalWake();
+    return result;
+#else
+    // Blocking fallback: one thread per query, the lease travels with it
+    auto owner = make_shared<PooledConnection>(std::move(lease));
+    const char* binding = QueryStats::bindingName();
+    return async(launch::async, [conn, query = std::move(query), owner, binding]() {
+        mysql_thread_init();
+        try {
+            auto rs = runBlocking(conn, query, binding);
+            mysql_thread_end();
+            return rs;
+        } catch (...) {
+            mysql_thread_end();
+            throw;
+        }
+    });
+#endif
+}
+
+/*
+ * step - Advances one query as far as it can go without blocking
+ */
+bool QueryEventLoop::step(Operation& op) {
+#if SIS_HAVE_NONBLOCKING_MYSQL
+    unique_ptr<ResultSet> rs;
+    exception_ptr error;
+    try {
+        if (!op.sent) {
+            net_async_status status = mysql_real_query_nonblocking(op.conn, op.query.c_str(),
+                                                                   (unsigned long)op.query.length());
+            if (status == NET_ASYNC_NOT_READY) return false;
+            if (status == NET_ASYNC_ERROR) {
+                throw runtime_error(string("Query error: ") + mysql_error(op.conn));
+            }
+            op.sent = true;
+        }
+
+        MYSQL_RES* res = nullptr;
+        net_async_status status = mysql_store_result_nonblocking(op.conn, &res);
+        if (status == NET_ASYNC_NOT_READY) return false;
+        if (status == NET_ASYNC_ERROR || (!res && mysql_field_count(op.conn) > 0)) {
+            throw runtime_error(string("Query error: ") + mysql_error(op.conn));
+        }
+        rs = make_unique<ResultSet>(res);
+        QueryStats& stats = QueryStats::instance();
+        if (stats.isEnabled()) {
+            stats.record(op.query, op.started, rs->getRowCount(),
+                         op.query.size() + rs->getPayloadBytes(), op.binding);
+        }
+    } catch (...) {
+        error = current_exception();
+    }
+    // The result is fully buffered, so the connection goes back before the
+    // caller wakes up and may ask the pool for another one
+    op.lease.release();
+    if (error) {
+        op.promise.set_exception(error);
+    } else {
+        op.promise.set_value(std::move(rs));
+    }
+    return true;
+#else
+    (void)op;
+    return true;
+#endif
+}
+
+/*
+ * run - Loop thread: advances every in-flight query
+ * When none of them can make progress the loop sleeps in poll() on
+ * their sockets, so it wakes as soon as a server answers.
+ */
+void QueryEventLoop::run() {
+    mysql_thread_init();
+    vector<unique_ptr<Operation>> active;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(mtx);
+            if (active.empty()) {
+                wake.wait(lock, [this]() { return !running || !incoming.empty(); });
+            }
+            if (!running) break;
+            for (auto& op : incoming) active.push_back(std::move(op));
+            incoming.clear();
+        }
+
+        size_t before = active.size();
+        for (size_t i = 0; i < active.size();) {
+            if (step(*active[i])) {
+                active[i] = std::move(active.back());
+                active.pop_back();
+            } else {
+                i++;
+            }
+        }
+
+        if (!active.empty() && active.size() == before) {
+            waitForSockets(active);
+        }
+    }
+
+    // Queries still on the wire are abandoned; their connections are closed
+    // rather than returned, since the protocol state is unknown.
+    for (auto& op : active) {
+        op->promise.set_exception(make_exception_ptr(runtime_error("Query event loop stopped")));
+        if (op->lease) op->lease->disconnect();
+    }
+    mysql_thread_end();
+}
+
+void QueryEventLoop::stop() {
+    vector<unique_ptr<Operation>> dropped;
+    {
+        lock_guard<mutex> lock(mtx);
+        running = false;
+        dropped.swap(incoming);
+    }
+    wake.notify_all();
+#if SIS_HAVE_NONBLOCKING_MYSQL
+    signalWake();
+#endif
+    if (worker.joinable()) {
+        worker.join();
+    }
+    for (auto& op : dropped) {
+        op->promise.set_exception(make_exception_ptr(runtime_error("Query event loop stopped")));
+    }
+}
+
+// ========================================
+// Async entry points
+// ========================================
+
+future<unique_ptr<ResultSet>> Database::executeQueryAsync(const string& query,
+                                                          const vector<SqlValue>& params) {
+    if (!connect()) {
+        throw runtime_error("Not connected to database");
+    }
+    string sql;
+    appendBound(sql, query, params);
+    return QueryEventLoop::instance().submit(connection, std::move(sql));
+}
+
+future<unique_ptr<ResultSet>> ConnectionPool::executeQueryAsync(const string& query,
+                                                                const vector<SqlValue>& params) {
+    PooledConnection lease = acquire();
+    string sql;
+    lease->appendBound(sql, query, params);
+    MYSQL* conn = lease->getHandle();
+    return QueryEventLoop::instance().submit(conn, std::move(sql), std::move(lease));
+}
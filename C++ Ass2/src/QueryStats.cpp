@@ -0,0 +1,381 @@
+/*
+ * ============================================
+ * QUERYSTATS.CPP - Implementation
+ * ============================================
+ */
+
+#include "../include/QueryStats.h"
+#include "../include/JsonHelper.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cctype>
+
+using namespace std;
+
+static const size_t MAX_CACHED_TEXTS = 4096;         // Raw SQL strings remembered for the fast path
+static const size_t MAX_CACHED_TEXT_LENGTH = 2048;   // Longer text (batch INSERTs) is always fingerprinted
+
+// ========================================
+// LatencyHistogram
+// ========================================
+
+/*
+ * indexOf - Bucket of a value
+ * Values below 16 get a bucket each; above that, the top
+ * SUB_BUCKET_BITS + 1 bits select the bucket.
+ */
+int LatencyHistogram::indexOf(uint64_t micros) {
+    if (micros < (uint64_t)SUB_BUCKETS) {
+        return (int)micros;
+    }
+    int magnitude = 0;
+    for (uint64_t v = micros; v > 1; v >>= 1) magnitude++;
+    if (magnitude > MAX_MAGNITUDE) {
+        return BUCKET_COUNT - 1;
+    }
+    int shift = magnitude - SUB_BUCKET_BITS;
+    return shift * SUB_BUCKETS + (int)(micros >> shift);
+}
+
+uint64_t LatencyHistogram::upperBoundOf(int index) {
+    if (index < SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(index % SUB_BUCKETS + SUB_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    counts[indexOf(micros)]++;
+    total++;
+    sum += micros;
+    maxValue = std::max(maxValue, micros);
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+    if (total == 0) return 0;
+    uint64_t target = (uint64_t)(percent / 100.0 * (double)total + 0.5);
+    target = std::min(std::max<uint64_t>(target, 1), total);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            return std::min(upperBoundOf(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+// ========================================
+// QueryStats
+// ========================================
+
+thread_local const char* QueryStats::currentBinding = "";
+
+QueryStats::BindingScope::BindingScope(const char* name) : previous(currentBinding) {
+    currentBinding = name ? name : "";
+}
+
+QueryStats::BindingScope::~BindingScope() {
+    currentBinding = previous;
+}
+
+QueryStats::QueryStats()
+    : generation(0), enabled(true), slowThreshold(chrono::milliseconds(100)), slowLogCapacity(200) {
+}
+
+QueryStats& QueryStats::instance() {
+    static QueryStats stats;
+    return stats;
+}
+
+const char* QueryStats::bindingName() {
+    return currentBinding;
+}
+
+/*
+ * fingerprint - Normalizes SQL so every execution of a statement groups together
+ *   "SELECT * FROM t WHERE id = 'S1' AND x IN (1, 2, 3)"
+ *   -> "SELECT * FROM t WHERE id = ? AND x IN (?+)"
+ * Multi-row VALUES lists fold to "(?+)...". Comments are dropped.
+ */
+string QueryStats::fingerprint(string_view sql) {
+    string out;
+    out.reserve(min<size_t>(sql.size(), 1024));
+
+    auto endsWith = [&out](string_view tail) {
+        return out.size() >= tail.size() && string_view(out).substr(out.size() - tail.size()) == tail;
+    };
+    auto isWordChar = [](unsigned char c) {
+        return isalnum(c) || c == '_' || c == '$' || c >= 0x80;
+    };
+    auto emitValue = [&]() {
+        if (endsWith("?+, ")) {
+            out.resize(out.size() - 2);
+        } else if (endsWith("?, ")) {
+            out.resize(out.size() - 2);
+            out += '+';
+        } else {
+            out += '?';
+        }
+    };
+
+    size_t i = 0;
+    size_t n = sql.size();
+    while (i < n) {
+        unsigned char c = (unsigned char)sql[i];
+
+        if (isspace(c)) {
+            while (i < n && isspace((unsigned char)sql[i])) i++;
+            if (!out.empty() && out.back() != ' ' && out.back() != '(') out += ' ';
+            continue;
+        }
+        if (c == '-' && i + 1 < n && sql[i + 1] == '-') {
+            while (i < n && sql[i] != '\n') i++;
+            continue;
+        }
+        if (c == '/' && i + 1 < n && sql[i + 1] == '*') {
+            size_t end = sql.find("*/", i + 2);
+            i = end == string_view::npos ? n : end + 2;
+            continue;
+        }
+        if (c == '\'' || c == '"') {
+            // String literal ('' and \' escapes)
+            i++;
+            while (i < n) {
+                if (sql[i] == '\\' && i + 1 < n) {
+                    i += 2;
+                } else if (sql[i] == (char)c) {
+                    if (i + 1 < n && sql[i + 1] == (char)c) {
+                        i += 2;
+                    } else {
+                        i++;
+                        break;
+                    }
+                } else {
+                    i++;
+                }
+            }
+            emitValue();
+            continue;
+        }
+        if (c == '`') {
+            size_t end = sql.find('`', i + 1);
+            end = end == string_view::npos ? n : end + 1;
+            out.append(sql.data() + i, end - i);
+            i = end;
+            continue;
+        }
+        if (isdigit(c) && (out.empty() || !isWordChar((unsigned char)out.back()))) {
+            // Number literal (including 1.5, 1e3 and 0xFF)
+            while (i < n && (isalnum((unsigned char)sql[i]) || sql[i] == '.')) i++;
+            emitValue();
+            continue;
+        }
+        if (c == '?') {
+            i++;
+            emitValue();
+            continue;
+        }
+        if (c == ',') {
+            i++;
+            if (!out.empty() && out.back() == ' ') out.pop_back();
+            out += ", ";
+            while (i < n && isspace((unsigned char)sql[i])) i++;
+            continue;
+        }
+        if (c == ')') {
+            i++;
+            if (!out.empty() && out.back() == ' ') out.pop_back();
+            out += ')';
+            for (string_view group : {string_view("(?+)"), string_view("(?)")}) {
+                string repeated = string(group) + ", " + string(group);
+                string continued = string(group) + "..., " + string(group);
+                if (endsWith(continued)) {
+                    out.resize(out.size() - group.size() - 2);
+                    break;
+                }
+                if (endsWith(repeated)) {
+                    out.resize(out.size() - group.size() - 2);
+                    out += "...";
+                    break;
+                }
+            }
+            continue;
+        }
+        if (c == ';') {
+            i++;
+            if (!out.empty() && out.back() == ' ') out.pop_back();
+            out += "; ";
+            while (i < n && isspace((unsigned char)sql[i])) i++;
+            continue;
+        }
+
+        out += (char)c;
+        i++;
+    }
+
+    while (!out.empty() && (out.back() == ' ' || out.back() == ';')) out.pop_back();
+    return out;
+}
+
+/*
+ * entryFor - Stats entry for SQL text with the given fingerprint (lock held)
+ */
+QueryStats::StatementStats& QueryStats::entryFor(string_view sql, string key) {
+    auto found = byFingerprint.find(key);
+    if (found == byFingerprint.end()) {
+        auto entry = make_unique<StatementStats>();
+        entry->fingerprint = key;
+        found = byFingerprint.emplace(std::move(key), std::move(entry)).first;
+    }
+
+    // Statements with inlined literals would never hit again; only keep a bounded number
+    if (texts.size() < MAX_CACHED_TEXTS && sql.size() <= MAX_CACHED_TEXT_LENGTH) {
+        texts.emplace_back(sql);
+        byText.emplace(texts.back(), found->second.get());
+    }
+    return *found->second;
+}
+
+/*
+ * record - Adds one execution and logs it if it was slow
+ */
+void QueryStats::record(string_view sql, Clock::time_point started, uint64_t rows, uint64_t bytes,
+                        const char* binding) {
+    if (!enabled) return;
+
+    uint64_t micros = (uint64_t)chrono::duration_cast<chrono::microseconds>(Clock::now() - started).count();
+    // Prepared statements repeat the exact same text, so the raw SQL is
+    // looked up first; unseen text is fingerprinted outside the lock.
+    StatementStats* cached = nullptr;
+    uint64_t seenGeneration;
+    {
+        lock_guard<mutex> lock(mtx);
+        auto found = byText.find(sql);
+        if (found != byText.end()) cached = found->second;
+        seenGeneration = generation;
+    }
+    string key;
+    if (!cached) key = fingerprint(sql);
+
+    string slowFingerprint;
+    {
+        lock_guard<mutex> lock(mtx);
+        if (generation != seenGeneration) {
+            // reset() ran in between and freed the cached entry
+            if (cached) key = fingerprint(sql);
+            cached = nullptr;
+        }
+        StatementStats& entry = cached ? *cached : entryFor(sql, std::move(key));
+        entry.calls++;
+        entry.rows += rows;
+        entry.bytes += bytes;
+        entry.latency.record(micros);
+
+        if (micros < (uint64_t)slowThreshold.count() || slowLogCapacity == 0) return;
+
+        slowFingerprint = entry.fingerprint;
+        slowLog.push_back({chrono::system_clock::now(), binding ? binding : "", slowFingerprint, micros, rows});
+        while (slowLog.size() > slowLogCapacity) slowLog.pop_front();
+    }
+
+    cerr << "[QueryStats] Slow query (" << micros / 1000.0 << " ms"
+         << (binding && *binding ? string(", ") + binding : string()) << "): "
+         << slowFingerprint << endl;
+}
+
+void QueryStats::setEnabled(bool on) {
+    enabled = on;
+}
+
+void QueryStats::setSlowQueryThreshold(chrono::microseconds threshold) {
+    lock_guard<mutex> lock(mtx);
+    slowThreshold = threshold;
+}
+
+void QueryStats::setSlowLogCapacity(size_t entries) {
+    lock_guard<mutex> lock(mtx);
+    slowLogCapacity = entries;
+    while (slowLog.size() > slowLogCapacity) slowLog.pop_front();
+}
+
+void QueryStats::reset() {
+    lock_guard<mutex> lock(mtx);
+    generation++;
+    byText.clear();
+    texts.clear();
+    byFingerprint.clear();
+    slowLog.clear();
+}
+
+static void appendMillis(string& out, uint64_t micros) {
+    char buffer[32];
+    int len = snprintf(buffer, sizeof(buffer), "%.3f", micros / 1000.0);
+    out.append(buffer, (size_t)len);
+}
+
+/*
+ * toJson - Dumps every statement (slowest total first) and the slow log
+ *   {"slowThresholdMs":100.000,"statements":[{"fingerprint":...,"calls":...,
+ *    "rows":...,"bytes":...,"totalMs":...,"meanMs":...,"p50Ms":...,"p90Ms":...,
+ *    "p99Ms":...,"maxMs":...}],"slowQueries":[{"at":...,"binding":...,
+ *    "fingerprint":...,"ms":...,"rows":...}]}
+ */
+string QueryStats::toJson() const {
+    lock_guard<mutex> lock(mtx);
+
+    vector<const StatementStats*> ordered;
+    ordered.reserve(byFingerprint.size());
+    for (const auto& entry : byFingerprint) ordered.push_back(entry.second.get());
+    sort(ordered.begin(), ordered.end(), [](const StatementStats* a, const StatementStats* b) {
+        return a->latency.totalMicros() > b->latency.totalMicros();
+    });
+
+    string out = "{\"slowThresholdMs\":";
+    appendMillis(out, (uint64_t)slowThreshold.count());
+    out += ",\"statements\":[";
+    for (size_t i = 0; i < ordered.size(); i++) {
+        const StatementStats& s = *ordered[i];
+        if (i > 0) out += ',';
+        out += "{\"fingerprint\":";
+        JsonHelper::appendString(out, s.fingerprint);
+        out += ",\"calls\":" + to_string(s.calls);
+        out += ",\"rows\":" + to_string(s.rows);
+        out += ",\"bytes\":" + to_string(s.bytes);
+        out += ",\"totalMs\":";
+        appendMillis(out, s.latency.totalMicros());
+        out += ",\"meanMs\":";
+        appendMillis(out, s.calls ? s.latency.totalMicros() / s.calls : 0);
+        out += ",\"p50Ms\":";
+        appendMillis(out, s.latency.percentile(50));
+        out += ",\"p90Ms\":";
+        appendMillis(out, s.latency.percentile(90));
+        out += ",\"p99Ms\":";
+        appendMillis(out, s.latency.percentile(99));
+        out += ",\"maxMs\":";
+        appendMillis(out, s.latency.max());
+        out += '}';
+    }
+    out += "],\"slowQueries\":[";
+    for (size_t i = 0; i < slowLog.size(); i++) {
+        const SlowQuery& q = slowLog[i];
+        if (i > 0) out += ',';
+        auto at = chrono::duration_cast<chrono::milliseconds>(q.at.time_since_epoch()).count();
+        out += "{\"at\":" + to_string(at);
+        out += ",\"binding\":";
+        JsonHelper::appendString(out, q.binding);
+        out += ",\"fingerprint\":";
+        JsonHelper::appendString(out, q.fingerprint);
+        out += ",\"ms\":";
+        appendMillis(out, q.micros);
+        out += ",\"rows\":" + to_string(q.rows);
+        out += '}';
+    }
+    out += "]}";
+    return out;
+}
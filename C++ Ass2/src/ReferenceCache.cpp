@@ -0,0 +1,79 @@
+/*
+ * ============================================
+ * REFERENCECACHE.CPP - Cached Reference Data
+ * ============================================
+ */
+
+#include "../include/ReferenceCache.h"
+
+using namespace std;
+
+ReferenceCache::ReferenceCache() {
+    for (auto& version : versions) {
+        version.store(1);
+    }
+}
+
+ReferenceCache& ReferenceCache::instance() {
+    static ReferenceCache cache;
+    return cache;
+}
+
+bool ReferenceCache::isFresh(uint64_t loadedVersion, Clock::time_point loadedAt, Table table) const {
+    return loadedVersion == versions[table].load() && Clock::now() - loadedAt < MAX_AGE;
+}
+
+shared_ptr<const string> ReferenceCache::get(Table table, Database& db, const Loader& load) {
+    Entry& entry = entries[table];
+    lock_guard<mutex> lock(entry.loadMutex);
+    if (entry.json && isFresh(entry.version, entry.loadedAt, table)) {
+        return entry.json;
+    }
+
+    // Read the version first: a write that lands during the load bumps
+    // it again, so this copy is already stale and the next call reloads
+    uint64_t version = versions[table].load();
+    auto json = make_shared<const string>(load(db));
+    entry.json = json;
+    entry.version = version;
+    entry.loadedAt = Clock::now();
+    return json;
+}
+
+ReferenceCache::CurrentSemester ReferenceCache::currentSemester(Database& db) {
+    lock_guard<mutex> lock(semesterMutex);
+    if (semesterLoaded && isFresh(semesterVersion, semesterLoadedAt, SEMESTERS)) {
+        return semester;
+    }
+
+    uint64_t version = versions[SEMESTERS].load();
+    CurrentSemester current;
+    auto result = db.executeQuery(
+        "SELECT id, semester_number FROM semesters WHERE is_current = TRUE LIMIT 1"
+    );
+    if (result->next()) {
+        current.id = result->getString("id");
+        current.semesterNumber = result->getInt("semester_number");
+        current.found = true;
+    }
+
+    semester = current;
+    semesterVersion = version;
+    semesterLoadedAt = Clock::now();
+    semesterLoaded = true;
+    return semester;
+}
+
+void ReferenceCache::invalidate(Table table) {
+    versions[table].fetch_add(1);
+    // Departments are listed with their college's name
+    if (table == COLLEGES) {
+        versions[DEPARTMENTS].fetch_add(1);
+    }
+}
+
+void ReferenceCache::invalidateAll() {
+    for (auto& version : versions) {
+        version.fetch_add(1);
+    }
+}
@@ -5,10 +5,16 @@
  */
 
 #include "../include/Registration.h"
-#include <sstream>
+#include "../include/GradeDistributionCache.h"
 
 using namespace std;
 
+// Every registration column, as the queries below select them
+static const string& registrationColumns() {
+    static const string columns = EntityFields::selectList(Registration::fields());
+    return columns;
+}
+
 // ========================================
 // CONSTRUCTORS
 // ========================================
@@ -54,21 +60,11 @@ vector<Registration> Registration::getAllRegistrations(Database& db) {
 
     try {
         auto result = db.executeQuery(
-            "SELECT id, student_id, course_id, semester_id, status, created_at "
+            "SELECT " + registrationColumns() + " "
             "FROM registrations ORDER BY id"
         );
 
-        while (result->next()) {
-            Registration reg;
-            reg.id = result->getString("id");
-            reg.studentId = result->getString("student_id");
-            reg.courseId = result->getString("course_id");
-            reg.semesterId = result->getString("semester_id");
-            reg.status = result->getString("status");
-            reg.createdAt = result->getString("created_at");
-
-            registrations.push_back(reg);
-        }
+        registrations = EntityFields::readAll<Registration>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Registration] Error getting all registrations: " << e.what() << endl;
@@ -82,21 +78,14 @@ Registration Registration::getById(Database& db, const string& id) {
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, student_id, course_id, semester_id, status, created_at "
+            "SELECT " + registrationColumns() + " "
             "FROM registrations WHERE id = ?"
         );
         stmt->setString(1, id);
 
         auto result = stmt->executeQuery();
 
-        if (result->next()) {
-            reg.id = result->getString("id");
-            reg.studentId = result->getString("student_id");
-            reg.courseId = result->getString("course_id");
-            reg.semesterId = result->getString("semester_id");
-            reg.status = result->getString("status");
-            reg.createdAt = result->getString("created_at");
-        }
+        reg = EntityFields::readFirst<Registration>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Registration] Error getting registration by ID: " << e.what() << endl;
@@ -110,24 +99,14 @@ vector<Registration> Registration::getByStudentId(Database& db, const string& st
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, student_id, course_id, semester_id, status, created_at "
+            "SELECT " + registrationColumns() + " "
             "FROM registrations WHERE student_id = ? ORDER BY created_at DESC"
         );
         stmt->setString(1, studentId);
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Registration reg;
-            reg.id = result->getString("id");
-            reg.studentId = result->getString("student_id");
-            reg.courseId = result->getString("course_id");
-            reg.semesterId = result->getString("semester_id");
-            reg.status = result->getString("status");
-            reg.createdAt = result->getString("created_at");
-
-            registrations.push_back(reg);
-        }
+        registrations = EntityFields::readAll<Registration>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Registration] Error getting registrations by student: " << e.what() << endl;
@@ -142,7 +121,7 @@ vector<Registration> Registration::getByCourseId(Database& db, const string& cou
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, student_id, course_id, semester_id, status, created_at "
+            "SELECT " + registrationColumns() + " "
             "FROM registrations WHERE course_id = ? AND semester_id = ? ORDER BY student_id"
         );
         stmt->setString(1, courseId);
@@ -150,17 +129,7 @@ vector<Registration> Registration::getByCourseId(Database& db, const string& cou
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Registration reg;
-            reg.id = result->getString("id");
-            reg.studentId = result->getString("student_id");
-            reg.courseId = result->getString("course_id");
-            reg.semesterId = result->getString("semester_id");
-            reg.status = result->getString("status");
-            reg.createdAt = result->getString("created_at");
-
-            registrations.push_back(reg);
-        }
+        registrations = EntityFields::readAll<Registration>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Registration] Error getting registrations by course: " << e.what() << endl;
@@ -174,24 +143,14 @@ vector<Registration> Registration::getBySemester(Database& db, const string& sem
 
     try {
         auto stmt = db.prepareStatement(
-            "SELECT id, student_id, course_id, semester_id, status, created_at "
+            "SELECT " + registrationColumns() + " "
             "FROM registrations WHERE semester_id = ? ORDER BY student_id"
         );
         stmt->setString(1, semesterId);
 
         auto result = stmt->executeQuery();
 
-        while (result->next()) {
-            Registration reg;
-            reg.id = result->getString("id");
-            reg.studentId = result->getString("student_id");
-            reg.courseId = result->getString("course_id");
-            reg.semesterId = result->getString("semester_id");
-            reg.status = result->getString("status");
-            reg.createdAt = result->getString("created_at");
-
-            registrations.push_back(reg);
-        }
+        registrations = EntityFields::readAll<Registration>(*result, fields());
 
     } catch (exception& e) {
         cerr << "[Registration] Error getting registrations by semester: " << e.what() << endl;
@@ -307,6 +266,7 @@ bool Registration::remove(Database& db) {
         stmt->setString(1, id);
 
         int rowsAffected = stmt->executeUpdate();
+        GradeDistributionCache::instance().forgetRegistration(id);
         return rowsAffected > 0;
 
     } catch (exception& e) {
@@ -330,16 +290,7 @@ bool Registration::complete(Database& db) {
 // ========================================
 
 string Registration::toJson() const {
-    stringstream ss;
-    ss << "{";
-    ss << "\"id\":\"" << id << "\",";
-    ss << "\"studentId\":\"" << studentId << "\",";
-    ss << "\"courseId\":\"" << courseId << "\",";
-    ss << "\"semesterId\":\"" << semesterId << "\",";
-    ss << "\"status\":\"" << status << "\",";
-    ss << "\"createdAt\":\"" << createdAt << "\"";
-    ss << "}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 bool Registration::isEmpty() const {
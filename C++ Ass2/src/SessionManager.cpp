@@ -11,66 +11,82 @@
 using namespace std;
 
 // Static member initialization
-UserSession SessionManager::currentSession;
+shared_ptr<const UserSession> SessionManager::currentSession = make_shared<const UserSession>();
+mutex SessionManager::sessionMutex;
+
+/*
+ * publish - Replaces the session snapshot seen by getSession
+ */
+void SessionManager::publish(shared_ptr<const UserSession> session) {
+    lock_guard<mutex> lock(sessionMutex);
+    currentSession = std::move(session);
+}
 
 /*
  * login - Authenticates user and creates session
  */
 bool SessionManager::login(Database& db, const string& username, const string& password) {
     try {
-        // Query user with role info
-        auto stmt = db.prepareStatement(
+        // Every statement finds the user by its credentials instead of by the
+        // id from the first one, so the whole login is a single round trip.
+        // A wrong password matches no user and every result comes back empty.
+        const string userMatch = "u.username = ? AND u.password_hash = ? AND u.is_active = TRUE";
+        QueryPipeline pipeline(db);
+        pipeline.add(
             "SELECT u.id, u.username, u.full_name, u.role_id, r.name_en as role_name "
             "FROM users u "
             "JOIN roles r ON u.role_id = r.id "
-            "WHERE u.username = ? AND u.password_hash = ? AND u.is_active = TRUE"
+            "WHERE " + userMatch,
+            {username, password}
         );
-        stmt->setString(1, username);
-        stmt->setString(2, password);
-        auto result = stmt->executeQuery();
+        pipeline.add(
+            "SELECT p.name FROM users u "
+            "JOIN role_permissions rp ON rp.role_id = u.role_id "
+            "JOIN permissions p ON p.id = rp.permission_id "
+            "WHERE " + userMatch,
+            {username, password}
+        );
+        // Linked professor or student id
+        pipeline.add(
+            "SELECT COALESCE(pr.id, st.id) as linked_id FROM users u "
+            "LEFT JOIN professors pr ON pr.user_id = u.id AND u.role_id = 'ROLE_PROFESSOR' "
+            "LEFT JOIN students st ON st.user_id = u.id AND u.role_id = 'ROLE_STUDENT' "
+            "WHERE " + userMatch,
+            {username, password}
+        );
+        // Update last login
+        pipeline.add(
+            "UPDATE users u SET u.last_login = CURRENT_TIMESTAMP WHERE " + userMatch,
+            {username, password}
+        );
+        auto results = pipeline.execute();
+        auto& result = results[0];
         
         if (result->next()) {
-            currentSession.userId = result->getString("id");
-            currentSession.username = result->getString("username");
-            currentSession.fullName = result->getString("full_name");
-            currentSession.roleId = result->getString("role_id");
-            currentSession.roleName = result->getString("role_name");
-            currentSession.isActive = true;
+            auto session = make_shared<UserSession>();
+            session->userId = result->getString("id");
+            session->username = result->getString("username");
+            session->fullName = result->getString("full_name");
+            session->roleId = result->getString("role_id");
+            session->roleName = result->getString("role_name");
+            session->isActive = true;
             
-            // Load permissions
-            currentSession.permissions = loadPermissions(db, currentSession.roleId, currentSession.userId);
-            
-            // Get linked ID (professor or student)
-            if (currentSession.isProfessor()) {
-                auto profStmt = db.prepareStatement(
-                    "SELECT id FROM professors WHERE user_id = ?"
-                );
-                profStmt->setString(1, currentSession.userId);
-                auto profResult = profStmt->executeQuery();
-                if (profResult->next()) {
-                    currentSession.linkedId = profResult->getString("id");
-                }
-            } else if (currentSession.isStudent()) {
-                auto stuStmt = db.prepareStatement(
-                    "SELECT id FROM students WHERE user_id = ?"
-                );
-                stuStmt->setString(1, currentSession.userId);
-                auto stuResult = stuStmt->executeQuery();
-                if (stuResult->next()) {
-                    currentSession.linkedId = stuResult->getString("id");
-                }
+            // Permissions
+            while (results[1]->next()) {
+                session->permissions.insert(results[1]->getString(0));
             }
+            cout << "[Session] Loaded " << session->permissions.size()
+                 << " permissions for role: " << session->roleId << endl;
             
-            // Update last login
-            auto updateStmt = db.prepareStatement(
-                "UPDATE users SET last_login = CURRENT_TIMESTAMP WHERE id = ?"
-            );
-            updateStmt->setString(1, currentSession.userId);
-            updateStmt->executeUpdate();
+            // Linked ID (professor or student)
+            if (results[2]->next()) {
+                session->linkedId = results[2]->getString(0);
+            }
             
-            cout << "[Session] User logged in: " << currentSession.fullName 
-                 << " (Role: " << currentSession.roleName << ")" << endl;
+            cout << "[Session] User logged in: " << session->fullName 
+                 << " (Role: " << session->roleName << ")" << endl;
             
+            publish(std::move(session));
             return true;
         }
         
@@ -86,14 +102,15 @@ bool SessionManager::login(Database& db, const string& username, const string& p
  * logout - Clears current session
  */
 void SessionManager::logout() {
-    cout << "[Session] User logged out: " << currentSession.username << endl;
-    currentSession = UserSession();
+    cout << "[Session] User logged out: " << getSession()->username << endl;
+    publish(make_shared<const UserSession>());
 }
 
 /*
- * getSession - Returns current session
+ * getSession - Returns the current session snapshot
  */
-const UserSession& SessionManager::getSession() {
+shared_ptr<const UserSession> SessionManager::getSession() {
+    lock_guard<mutex> lock(sessionMutex);
     return currentSession;
 }
 
@@ -101,17 +118,18 @@ const UserSession& SessionManager::getSession() {
  * isLoggedIn - Checks if a user is logged in
  */
 bool SessionManager::isLoggedIn() {
-    return currentSession.isActive;
+    return getSession()->isActive;
 }
 
 /*
  * hasPermission - Checks if current user has a specific permission
  */
 bool SessionManager::hasPermission(const string& permission) {
-    if (currentSession.isSuperAdmin()) {
+    auto session = getSession();
+    if (session->isSuperAdmin()) {
         return true;
     }
-    return currentSession.hasPermission(permission);
+    return session->hasPermission(permission);
 }
 
 /*
@@ -161,19 +179,20 @@ bool SessionManager::canRecordAttendance() {
  */
 bool SessionManager::canAccessCourse(Database& db, const string& courseId,
                                      const string& semesterId) {
+    auto session = getSession();
     // Admins can access all courses
-    if (currentSession.isAdmin()) {
+    if (session->isAdmin()) {
         return true;
     }
     
     // Professor must be assigned to the course
-    if (currentSession.isProfessor() && !currentSession.linkedId.empty()) {
+    if (session->isProfessor() && !session->linkedId.empty()) {
         try {
             auto stmt = db.prepareStatement(
                 "SELECT COUNT(*) as count FROM course_assignments "
             "WHERE professor_id = ? AND course_id = ? AND semester_id = ?"
         );
-        stmt->setString(1, currentSession.linkedId);
+        stmt->setString(1, session->linkedId);
         stmt->setString(2, courseId);
         stmt->setString(3, semesterId);
             
@@ -193,9 +212,10 @@ bool SessionManager::canAccessCourse(Database& db, const string& courseId,
  * getAssignedCourseIds - Gets list of course IDs assigned to the professor
  */
 vector<string> SessionManager::getAssignedCourseIds(Database& db, const string& semesterId) {
+    auto session = getSession();
     vector<string> courseIds;
     
-    if (!currentSession.isProfessor() || currentSession.linkedId.empty()) {
+    if (!session->isProfessor() || session->linkedId.empty()) {
         return courseIds;
     }
     
@@ -207,7 +227,7 @@ vector<string> SessionManager::getAssignedCourseIds(Database& db, const string&
             query += " AND semester_id = ?";
         }
         auto stmt = db.prepareStatement(query);
-        stmt->setString(1, currentSession.linkedId);
+        stmt->setString(1, session->linkedId);
         if (!semesterId.empty()) {
             stmt->setString(2, semesterId);
         }
@@ -227,7 +247,8 @@ vector<string> SessionManager::getAssignedCourseIds(Database& db, const string&
  * isOwnStudentId - Checks if the student ID belongs to the logged-in student
  */
 bool SessionManager::isOwnStudentId(const string& studentId) {
-    return currentSession.isStudent() && currentSession.linkedId == studentId;
+    auto session = getSession();
+    return session->isStudent() && session->linkedId == studentId;
 }
 
 /*
@@ -280,7 +301,7 @@ void SessionManager::logAction(Database& db, const string& action,
             "INSERT INTO audit_log (user_id, action, table_name, record_id, details) "
             "VALUES (?, ?, ?, ?, ?)"
         );
-        stmt->setString(1, currentSession.userId);
+        stmt->setString(1, getSession()->userId);
         stmt->setString(2, action);
         stmt->setString(3, tableName);
         stmt->setString(4, recordId);
@@ -6,7 +6,6 @@
  */
 
 #include "../include/Student.h"
-#include <sstream>
 #include <ctime>
 #include <cstdlib>
 
@@ -68,6 +67,16 @@ void Student::setAcademicLevelId(const string& academicLevelId) { this->academic
 void Student::setDepartmentId(const string& departmentId) { this->departmentId = departmentId; }
 void Student::setPassword(const string& password) { this->passwordHash = password; }
 
+// ========================================
+// FIELD TABLE
+// ========================================
+
+// "s.id, s.user_id, ..., u.email, u.phone, ..." for queries aliasing students as s
+static const string& studentColumns() {
+    static const string columns = EntityFields::selectList(Student::fields(), "s.");
+    return columns;
+}
+
 // ========================================
 // STATIC DATABASE OPERATIONS
 // ========================================
@@ -81,30 +90,13 @@ vector<Student> Student::getAllStudents(Database& db) {
     try {
         // Execute query to get all students
         auto result = db.executeQuery(
-            "SELECT s.id, s.user_id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
-            "u.email, u.phone, s.enrollment_date, s.academic_level_id, s.department_id "
+            "SELECT " + studentColumns() + " "
             "FROM students s "
             "LEFT JOIN users u ON s.user_id = u.id "
             "ORDER BY s.id"
         );
         
-        // Loop through results and create Student objects
-        while (result->next()) {
-            Student student;
-            student.id = result->getString("id");
-            student.userId = result->getString("user_id");
-            student.firstName = result->getString("first_name");
-            student.lastName = result->getString("last_name");
-            student.dateOfBirth = result->getString("date_of_birth");
-            student.gender = result->getString("gender");
-            student.email = result->getString("email");
-            student.phone = result->getString("phone");
-            student.registrationDate = result->getString("enrollment_date");
-            student.academicLevelId = result->getString("academic_level_id");
-            student.departmentId = result->getString("department_id");
-            
-            students.push_back(student);
-        }
+        students = EntityFields::readAll<Student>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Student] Error getting all students: " << e.what() << endl;
@@ -122,8 +114,7 @@ Student Student::getById(Database& db, const string& id) {
     try {
         // Use prepared statement to prevent SQL injection
         auto stmt = db.prepareStatement(
-            "SELECT s.id, s.user_id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
-            "u.email, u.phone, s.enrollment_date, s.academic_level_id, s.department_id "
+            "SELECT " + studentColumns() + " "
             "FROM students s "
             "LEFT JOIN users u ON s.user_id = u.id "
             "WHERE s.id = ?"
@@ -132,19 +123,7 @@ Student Student::getById(Database& db, const string& id) {
         
         auto result = stmt->executeQuery();
         
-        if (result->next()) {
-            student.id = result->getString("id");
-            student.userId = result->getString("user_id");
-            student.firstName = result->getString("first_name");
-            student.lastName = result->getString("last_name");
-            student.dateOfBirth = result->getString("date_of_birth");
-            student.gender = result->getString("gender");
-            student.email = result->getString("email");
-            student.phone = result->getString("phone");
-            student.registrationDate = result->getString("enrollment_date");
-            student.academicLevelId = result->getString("academic_level_id");
-            student.departmentId = result->getString("department_id");
-        }
+        student = EntityFields::readFirst<Student>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Student] Error getting student by ID: " << e.what() << endl;
@@ -182,8 +161,7 @@ vector<Student> Student::getByDepartment(Database& db, const string& departmentI
     
     try {
         auto stmt = db.prepareStatement(
-            "SELECT s.id, s.user_id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
-            "u.email, u.phone, s.enrollment_date, s.academic_level_id, s.department_id "
+            "SELECT " + studentColumns() + " "
             "FROM students s "
             "LEFT JOIN users u ON s.user_id = u.id "
             "WHERE s.department_id = ? ORDER BY s.id"
@@ -192,22 +170,7 @@ vector<Student> Student::getByDepartment(Database& db, const string& departmentI
         
         auto result = stmt->executeQuery();
         
-        while (result->next()) {
-            Student student;
-            student.id = result->getString("id");
-            student.userId = result->getString("user_id");
-            student.firstName = result->getString("first_name");
-            student.lastName = result->getString("last_name");
-            student.dateOfBirth = result->getString("date_of_birth");
-            student.gender = result->getString("gender");
-            student.email = result->getString("email");
-            student.phone = result->getString("phone");
-            student.registrationDate = result->getString("enrollment_date");
-            student.academicLevelId = result->getString("academic_level_id");
-            student.departmentId = result->getString("department_id");
-            
-            students.push_back(student);
-        }
+        students = EntityFields::readAll<Student>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Student] Error getting students by department: " << e.what() << endl;
@@ -224,8 +187,7 @@ vector<Student> Student::getByAcademicLevel(Database& db, const string& levelId)
     
     try {
         auto stmt = db.prepareStatement(
-            "SELECT s.id, s.user_id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
-            "u.email, u.phone, s.enrollment_date, s.academic_level_id, s.department_id "
+            "SELECT " + studentColumns() + " "
             "FROM students s "
             "LEFT JOIN users u ON s.user_id = u.id "
             "WHERE s.academic_level_id = ? ORDER BY s.id"
@@ -234,22 +196,7 @@ vector<Student> Student::getByAcademicLevel(Database& db, const string& levelId)
         
         auto result = stmt->executeQuery();
         
-        while (result->next()) {
-            Student student;
-            student.id = result->getString("id");
-            student.userId = result->getString("user_id");
-            student.firstName = result->getString("first_name");
-            student.lastName = result->getString("last_name");
-            student.dateOfBirth = result->getString("date_of_birth");
-            student.gender = result->getString("gender");
-            student.email = result->getString("email");
-            student.phone = result->getString("phone");
-            student.registrationDate = result->getString("enrollment_date");
-            student.academicLevelId = result->getString("academic_level_id");
-            student.departmentId = result->getString("department_id");
-            
-            students.push_back(student);
-        }
+        students = EntityFields::readAll<Student>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Student] Error getting students by level: " << e.what() << endl;
@@ -266,8 +213,7 @@ Student Student::validateLogin(Database& db, const string& id, const string& pas
     
     try {
         auto stmt = db.prepareStatement(
-            "SELECT s.id, s.user_id, s.first_name, s.last_name, s.date_of_birth, s.gender, "
-            "u.email, u.phone, s.enrollment_date, s.academic_level_id, s.department_id "
+            "SELECT " + studentColumns() + " "
             "FROM users u "
             "JOIN students s ON s.user_id = u.id "
             "WHERE u.username = ? AND u.password_hash = ? AND u.is_active = TRUE AND u.role_id = 'ROLE_STUDENT'"
@@ -277,19 +223,7 @@ Student Student::validateLogin(Database& db, const string& id, const string& pas
         
         auto result = stmt->executeQuery();
         
-        if (result->next()) {
-            student.id = result->getString("id");
-            student.userId = result->getString("user_id");
-            student.firstName = result->getString("first_name");
-            student.lastName = result->getString("last_name");
-            student.dateOfBirth = result->getString("date_of_birth");
-            student.gender = result->getString("gender");
-            student.email = result->getString("email");
-            student.phone = result->getString("phone");
-            student.registrationDate = result->getString("enrollment_date");
-            student.academicLevelId = result->getString("academic_level_id");
-            student.departmentId = result->getString("department_id");
-        }
+        student = EntityFields::readFirst<Student>(*result, fields());
         
     } catch (exception& e) {
         cerr << "[Student] Error validating login: " << e.what() << endl;
@@ -532,21 +466,7 @@ bool Student::remove(Database& db) {
  * toJson - Converts student to JSON string
  */
 string Student::toJson() const {
-    stringstream ss;
-    ss << "{";
-    ss << "\"id\":\"" << id << "\",";
-    ss << "\"firstName\":\"" << firstName << "\",";
-    ss << "\"lastName\":\"" << lastName << "\",";
-    ss << "\"fullName\":\"" << getFullName() << "\",";
-    ss << "\"dateOfBirth\":\"" << dateOfBirth << "\",";
-    ss << "\"gender\":\"" << gender << "\",";
-    ss << "\"email\":\"" << email << "\",";
-    ss << "\"phone\":\"" << phone << "\",";
-    ss << "\"registrationDate\":\"" << registrationDate << "\",";
-    ss << "\"academicLevelId\":\"" << academicLevelId << "\",";
-    ss << "\"departmentId\":\"" << departmentId << "\"";
-    ss << "}";
-    return ss.str();
+    return EntityFields::toJson(fields(), *this);
 }
 
 /*
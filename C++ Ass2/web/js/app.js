@@ -352,6 +352,167 @@ function showTableEmpty(tbodyId, colSpan = 5, message = 'No data found') {
     }
 }
 
+// ========================================
+// PAGED LISTINGS
+// ========================================
+/**
+ * createPagedList - Loads a listing binding one page at a time
+ *
+ * The backend filters and pages the rows; the list keeps what has been
+ * loaded so far. Responses to superseded requests (e.g. while typing in
+ * a search box) are dropped.
+ *
+ * @param {Function} binding - Listing binding, e.g. cpp_getAllStudents
+ * @param {number} pageSize - Rows per page
+ * @returns {Object} { items, total, totalExact, hasMore(), reset(filters), loadMore() }
+ */
+function createPagedList(binding, pageSize = 50) {
+    let filters = {};
+    let next = null;
+    let generation = 0;
+
+    const list = {
+        items: [],
+        total: 0,
+        totalExact: true,
+
+        hasMore() {
+            return next !== null;
+        },
+
+        // Start over with new filters and load the first page
+        async reset(newFilters = {}) {
+            filters = newFilters;
+            next = null;
+            list.items = [];
+            return fetchPage(++generation, true);
+        },
+
+        // Append the next page
+        async loadMore() {
+            if (next === null) return list.items;
+            return fetchPage(generation, false);
+        }
+    };
+
+    async function fetchPage(requestGeneration, first) {
+        const args = Object.assign({}, filters, { limit: pageSize });
+        if (!first) args.after = next;
+
+        let page = await binding(JSON.stringify(args));
+        if (typeof page === 'string') page = JSON.parse(page);
+        if (requestGeneration !== generation) return list.items;
+
+        list.items = list.items.concat(page.items || []);
+        next = page.next ?? null;
+        if (first) {
+            list.total = page.total ?? list.items.length;
+            list.totalExact = page.totalExact !== false;
+        }
+        return list.items;
+    }
+
+    return list;
+}
+
+// ========================================
+// CHANGE NOTIFICATIONS
+// ========================================
+const dataChangeListeners = {};
+
+/**
+ * onDataChange - Registers a listener for changes to a table
+ *
+ * After a mutation succeeds the backend pushes the changed row as
+ * { table, op, key, row }, with op 'insert', 'update' or 'delete' and
+ * row shaped like the table's listing, so grids can patch one row
+ * instead of reloading.
+ *
+ * @param {string} table - e.g. 'grades', 'registrations', 'attendance'
+ * @param {Function} listener - Called with the delta
+ * @returns {Function} Removes the listener
+ */
+function onDataChange(table, listener) {
+    (dataChangeListeners[table] = dataChangeListeners[table] || []).push(listener);
+    return () => {
+        dataChangeListeners[table] = dataChangeListeners[table].filter(l => l !== listener);
+    };
+}
+
+// Called by the backend with each delta
+function handleDataChange(delta) {
+    (dataChangeListeners[delta.table] || []).forEach(listener => {
+        try {
+            listener(delta);
+        } catch (error) {
+            console.error('Error applying change:', error);
+        }
+    });
+}
+
+// ========================================
+// BATCHED CALLS
+// ========================================
+/**
+ * callBatch - Makes several binding calls in one round trip
+ *
+ * The calls run in parallel on the backend; the results come back
+ * together, in the order of the calls. A failed call gets its error
+ * response in its slot instead of failing the whole batch.
+ *
+ * @param {Array} calls - [{ method: 'cpp_getDepartments', args: {...} }, ...]
+ * @returns {Promise<Array>} One result per call
+ */
+async function callBatch(calls) {
+    let results = await cpp_batch(calls);
+    if (typeof results === 'string') results = JSON.parse(results);
+    return results;
+}
+
+// ========================================
+// COLUMNAR RESPONSES
+// ========================================
+/**
+ * decodeColumnar - Turns a columnar grid back into row objects
+ *
+ * Grid bindings called with { format: 'columnar' } answer with
+ * { columns, types, rows, dicts, data }: one array per column, and for
+ * dictionary columns an index into dicts[column] instead of the value.
+ * Plain arrays (row responses, errors) are returned unchanged.
+ *
+ * @param {Object|Array|string} grid - Binding result
+ * @returns {Array} Row objects
+ */
+function decodeColumnar(grid) {
+    if (typeof grid === 'string') grid = JSON.parse(grid);
+    if (!grid || Array.isArray(grid) || !grid.columns) return grid || [];
+
+    const dicts = grid.dicts || {};
+    const rows = new Array(grid.rows);
+    for (let i = 0; i < grid.rows; i++) rows[i] = {};
+
+    for (const column of grid.columns) {
+        const values = grid.data[column];
+        const dict = dicts[column];
+        for (let i = 0; i < grid.rows; i++) {
+            const value = values[i];
+            rows[i][column] = dict && value !== null ? dict[value] : value;
+        }
+    }
+    return rows;
+}
+
+/**
+ * fetchColumnar - Calls a grid binding in columnar form and decodes it
+ *
+ * @param {Function} binding - Grid binding, e.g. cpp_getStudentsByCourse
+ * @param {Object} args - Request arguments
+ * @returns {Promise<Array>} Row objects
+ */
+async function fetchColumnar(binding, args = {}) {
+    return decodeColumnar(await binding(Object.assign({}, args, { format: 'columnar' })));
+}
+
 // ========================================
 // FORM VALIDATION
 // ========================================